@@ -20,6 +20,49 @@
   function hideErr(){ err.hidden=true; err.textContent=''; }
   function clear(){ ctx.clearRect(0,0,canvas.width,canvas.height); }
 
+  function pad2(n){ return (n < 10 ? '0' : '') + n; }
+
+  // Label aus epoch: Tageswerte "TT.MM", sonst "HH:MM" (mehrtägig "TT.MM HH:MM")
+  function fmtLabel(ep, daily, multiDay){
+    const d = new Date(ep * 1000);
+    const day = pad2(d.getDate()) + '.' + pad2(d.getMonth()+1);
+    const hm  = pad2(d.getHours()) + ':' + pad2(d.getMinutes());
+    if (daily) return day;
+    return multiDay ? day + ' ' + hm : hm;
+  }
+
+  // Reihenfolge wie LOG_METRICS in der Firmware (Spaltenindex im Binärkopf)
+  const BIN_KEYS = ['temp','hum','press','co2'];
+
+  // format=bin: 8 Byte Kopf + Records {uint32 epoch, float32 je Metrik}, little-endian
+  function decodeBin(buf){
+    const dv = new DataView(buf);
+    if (buf.byteLength < 8 || dv.getUint8(0) !== 1) throw new Error('Binärformat unbekannt');
+    const flags = dv.getUint8(1), n = dv.getUint8(2);
+    const cols = [];
+    for (let i=0;i<n;i++) cols.push(BIN_KEYS[dv.getUint8(4+i)]);
+
+    const stride = 4 + 4*n;
+    const count = Math.floor((buf.byteLength - 8) / stride);
+    const t = new Uint32Array(count);
+    const vals = cols.map(() => new Float32Array(count));
+    for (let r=0, off=8; r<count; r++, off+=stride){
+      t[r] = dv.getUint32(off, true);
+      for (let i=0;i<n;i++) vals[i][r] = dv.getFloat32(off + 4 + 4*i, true);
+    }
+    return { mode: (flags & 2) ? 'bar' : 'line', daily: !!(flags & 1), cols, t, vals };
+  }
+
+  // Spaltenform (t + vals je Metrik) -> labels + series je Metrik
+  function toChart(d){
+    const n = d.t.length;
+    const multiDay = n > 1 && (d.t[n-1] - d.t[0]) > 86400;
+    const labels = new Array(n), series = {};
+    for (let r=0;r<n;r++) labels[r] = fmtLabel(d.t[r], d.daily, multiDay);
+    d.cols.forEach((k, i) => series[k] = d.vals[i]);
+    return { mode: d.mode, labels, series };
+  }
+
   function drawChart(payload){
     clear();
 
@@ -169,16 +212,21 @@
     }
 
     try{
-      const r = await fetch('/api/history?' + qs({ range, chart, metrics: metrics.join(',') }));
+      // points = Canvasbreite: mehr Punkte kann das Diagramm ohnehin nicht darstellen
+      const r = await fetch('/api/history?' + qs({ range, chart, metrics: metrics.join(','), points: canvas.width, format: 'bin' }));
       if (!r.ok) throw new Error('HTTP ' + r.status);
-      const data = await r.json();
-      drawChart(data);
+      drawChart(toChart(decodeBin(await r.arrayBuffer())));
     }catch(e){
       showErr('Konnte Daten nicht laden: ' + e.message);
       clear();
     }
   }
 
+  // live: alle 10 s nachladen (Raster des RAM-Puffers)
+  setInterval(()=>{
+    if (document.getElementById('range').value === 'live' && !document.hidden) load();
+  }, 10000);
+
   document.getElementById('range').addEventListener('change', load);
   document.getElementById('chart').addEventListener('change', load);
   document.querySelectorAll('.m').forEach(x => x.addEventListener('change', load));
@@ -4,3 +4,4 @@
 #include "settings.h"
 
 void apiHistory(WebServer &server);
+void apiLogCsv(WebServer &server);   // CSV-Export eines Tages (?day=YYYY-MM-DD)
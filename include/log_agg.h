@@ -0,0 +1,33 @@
+#pragma once
+#include <Arduino.h>
+#include "log_format.h"
+
+// ===== Verdichtung der 1-s-Messungen auf das Log-Intervall =====
+//
+// Zwischen zwei Log-Zeitpunkten werden je Metrik Anzahl, Summe, Min und Max mitgeführt
+// (fester Speicher, O(1) je Messung); NAN-Werte (Sensor hatte keinen neuen Wert) zählen nicht.
+// Zum Log-Zeitpunkt wird der Mittelwert geschrieben statt des zufälligen Momentanwerts,
+// bei log_agg_mode = LOG_AGG_MINMAX zusätzlich Min/Max in die Hüllkurven-Datei (.env, log_format.h).
+static constexpr uint8_t LOG_AGG_LAST   = 0;   // Momentanwert (wie früher)
+static constexpr uint8_t LOG_AGG_MEAN   = 1;   // Mittelwert des Intervalls
+static constexpr uint8_t LOG_AGG_MINMAX = 2;   // Mittelwert + Min/Max
+
+class LogAgg {
+public:
+  // ein Wert je Metrik in der Reihenfolge von LOG_METRICS
+  void add(const float* vals);
+  void reset();
+  uint32_t samples() const { return _samples; }
+
+  // Mittel/Min/Max je Metrik; ohne Werte im Intervall: NAN. Setzt danach zurück.
+  // metricMask: nur diese Metriken (LOG_* Bits) ausgeben und zurücksetzen, die übrigen sammeln
+  // weiter (eigenes Intervall je Metrik, log_every_*); deren Ausgabe bleibt NAN.
+  void take(LogSample& mean, LogSample& mn, LogSample& mx, uint32_t metricMask = 0xFFFFFFFFu);
+
+private:
+  uint32_t _samples = 0;
+  uint32_t _n[LOG_METRIC_COUNT] = {};
+  double   _sum[LOG_METRIC_COUNT] = {};
+  float    _min[LOG_METRIC_COUNT] = { NAN, NAN, NAN, NAN };
+  float    _max[LOG_METRIC_COUNT] = { NAN, NAN, NAN, NAN };
+};
@@ -0,0 +1,75 @@
+#pragma once
+#include <Arduino.h>
+#include <FS.h>
+#include <time.h>
+#include "log_format.h"
+
+// ===== Monatsarchiv /log/YYYY-MM.arc =====
+//
+// Ältere Tage werden aus ihren Einzeldateien (.csv/.bin/.gor/.idx) in eine Datei je Monat
+// übernommen -> weniger Verzeichniseinträge und weniger Cluster-Verschnitt auf großen Karten.
+//
+// [Inhaltsverzeichnis A @0][Inhaltsverzeichnis B @LOG_ARC_TOC_SLOT][Tag][Tag]...
+// Das Inhaltsverzeichnis hat 31 feste Slots (Tag im Monat - 1) und liegt zweimal vor:
+// geschrieben wird immer die ältere Kopie, gültig ist die mit der höchsten seq und passender CRC
+// -> ein beim Stromausfall abgerissener Schreibvorgang kostet höchstens den zuletzt übernommenen Tag.
+// Jeder Tag beginnt auf einer 512-Byte-Grenze und ist entweder eine vollständige .bin-Datei
+// (LogBinHeader + Records) oder eine Folge von .gor-Blöcken (komprimiert).
+static constexpr uint32_t LOG_ARC_MAGIC    = 0x4352414C;   // "LARC"
+static constexpr uint8_t  LOG_ARC_VERSION  = 1;
+static constexpr uint32_t LOG_ARC_TOC_SLOT = 1024;
+static constexpr uint32_t LOG_ARC_DATA     = 2 * LOG_ARC_TOC_SLOT;
+static constexpr uint32_t LOG_ARC_ALIGN    = 512;
+static constexpr uint8_t  LOG_ARC_DAYS     = 31;
+
+enum LogArcKind : uint8_t { LOG_ARC_NONE = 0, LOG_ARC_BIN = 1, LOG_ARC_GOR = 2 };
+
+struct __attribute__((packed)) LogArcDay {
+  uint32_t offset;     // Dateioffset des Tages
+  uint32_t length;     // Bytes
+  uint32_t first;      // epoch des ersten / letzten Werts
+  uint32_t last;
+  uint32_t rows;
+  uint32_t mask;       // log_metric_mask (Vereinigung über den Tag)
+  uint8_t  kind;       // LogArcKind, NONE = Slot leer
+  uint8_t  reserved[3];
+};
+
+struct __attribute__((packed)) LogArcToc {
+  uint32_t  magic;
+  uint8_t   version;
+  uint8_t   reserved;
+  uint16_t  crc;       // logCrc16 ab seq bis Ende
+  uint32_t  seq;
+  uint32_t  month;     // YYYYMM
+  LogArcDay days[LOG_ARC_DAYS];
+};
+
+// "/log/YYYY-MM.arc" zu einem Tag ("YYYY-MM-DD") oder Monat ("YYYY-MM")
+String logArchivePath(const String& dayOrMonth);
+
+// "YYYY-MM.arc" -> Jahr/Monat
+bool logArchiveParseName(const String& base, int& y, int& m);
+
+// gültiges Inhaltsverzeichnis einer geöffneten Archivdatei
+bool logArchiveReadToc(File& f, LogArcToc& toc);
+
+// Archivdatei geöffnet zurück, wenn der Tag darin liegt (sonst ungültiger File)
+File logArchiveOpenDay(const String& day, LogArcDay& out);
+
+// Tag aus dem Archiv austragen (Aufräumen); das letzte Austragen löscht die Datei
+bool logArchiveDropDay(const String& day);
+
+// Hintergrundjob (Storage-Task): Tage älter als ageDays ins Monatsarchiv übernehmen
+// (0 = aus), compress = .gor-Blöcke statt .bin. Kopiert je Aufruf nur wenige Samples;
+// die Einzeldateien werden erst gelöscht, wenn das Inhaltsverzeichnis geschrieben ist.
+void logArchiveStep(time_t now, uint16_t ageDays, bool compress);
+bool logArchiveBusy();
+void logArchiveReset();   // SD neu gemountet
+
+struct LogArchiveStats {
+  uint32_t days = 0;       // übernommene Tage (seit Start)
+  uint64_t bytesIn = 0;    // Einzeldateien davor
+  uint64_t bytesOut = 0;   // im Archiv
+};
+LogArchiveStats logArchiveGetStats();
@@ -6,3 +6,9 @@ static constexpr uint32_t LOG_HUM   = (1u << 1);
 static constexpr uint32_t LOG_PRESS = (1u << 2);
 static constexpr uint32_t LOG_CO2   = (1u << 3);
 static constexpr uint32_t LOG_LUX   = (1u << 4); // später
+
+// Dateiformate der Tagesdateien (Bitmaske, cfg.log_format_mask)
+static constexpr uint32_t LOG_FMT_CSV = (1u << 0);   // /log/YYYY-MM-DD.csv (lesbar, Export)
+static constexpr uint32_t LOG_FMT_BIN = (1u << 1);   // /log/YYYY-MM-DD.bin (feste Recordgröße, schnell)
+static constexpr uint32_t LOG_FMT_GOR = (1u << 2);   // /log/YYYY-MM-DD.gor (komprimierte Blöcke, lange Aufbewahrung)
+static constexpr uint32_t LOG_FMT_ALL = LOG_FMT_CSV | LOG_FMT_BIN | LOG_FMT_GOR;
@@ -0,0 +1,60 @@
+#pragma once
+#include <Arduino.h>
+#include <FS.h>
+#include "log_format.h"
+
+struct SensorData;
+
+// ===== Burst-Aufzeichnung: Sekundenwerte rund um ein Ereignis =====
+//
+// loop() legt jede Messung (1 s) in einen statischen Ringpuffer. Löst ein Trigger aus
+// (CO2-Steigung, Web, MQTT, Zeitplan), wird ab LOG_BURST_PRE_SEC vor dem Trigger bis
+// log_burst_sec danach jede Sekunde in eine eigene Datei geschrieben; ein weiterer Trigger
+// verlängert die laufende Aufzeichnung (höchstens LOG_BURST_MAX_SEC).
+// Geschrieben wird vom Storage-Task in Blöcken direkt aus dem Ringpuffer -> kein Heap je Burst.
+// Kommt die Karte nicht hinterher (Ring voll), werden neue Sekunden verworfen und gezählt.
+//
+// /log/burst/<epoch>-<grund>.bin: .bin-Format (log_format.h), epoch = erster Record,
+// day_start im Header = Zeitpunkt des Triggers. Höchstens LOG_BURST_MAX_FILES Dateien,
+// die älteste wird beim nächsten Burst gelöscht (nicht im Katalog / in log_max_bytes).
+static constexpr const char* LOG_BURST_DIR       = "/log/burst";
+static constexpr uint16_t    LOG_BURST_RING      = 256;    // Sekunden im RAM (20 B je Sekunde)
+static constexpr uint16_t    LOG_BURST_PRE_SEC   = 120;    // Vorlauf vor dem Trigger
+static constexpr uint16_t    LOG_BURST_MAX_SEC   = 3600;   // längste Aufzeichnung nach dem Trigger
+static constexpr uint8_t     LOG_BURST_CHUNK     = 16;     // Sekunden je Schreibvorgang
+static constexpr uint8_t     LOG_BURST_MAX_FILES = 32;
+
+enum LogBurstReason : uint8_t { LOG_BURST_NONE, LOG_BURST_SLOPE, LOG_BURST_WEB, LOG_BURST_MQTT, LOG_BURST_SCHEDULE };
+
+struct LogBurstConfig {
+  uint16_t postSec = 0;        // log_burst_sec (0 = aus)
+  uint16_t slopePpmMin = 0;    // log_burst_slope: |ΔCO2| je Minute (0 = aus, wirkt nur mit LOG_CO2 in metricMask)
+  uint8_t  everyH = 0;         // log_burst_every_h: zu jeder n-ten vollen Stunde (0 = aus)
+  uint32_t metricMask = 0;     // log_metric_mask
+};
+
+struct LogBurstStats {
+  bool     active = false;
+  uint8_t  reason = LOG_BURST_NONE;   // der laufenden bzw. letzten Aufzeichnung
+  uint32_t lastTrigger = 0;           // epoch
+  uint32_t captures = 0;              // abgeschlossene Aufzeichnungen seit Start
+  uint32_t samples = 0;               // geschriebene Sekunden
+  uint32_t overruns = 0;              // verworfene Sekunden (Ring voll)
+};
+
+const char* logBurstReasonName(uint8_t reason);   // "slope", "web", ...
+
+// (loop, 1 s) Messung in den Ring, Trigger prüfen; ohne gültige Uhrzeit passiert nichts
+void logBurstPush(const LogBurstConfig& cfg, time_t now, const SensorData& d);
+
+// manueller Trigger (Web/MQTT), wird mit der nächsten Messung wirksam; false = Burst aus
+bool logBurstTrigger(uint8_t reason);
+
+// (Storage-Task, SD-Sperre gehalten) fällige Sekunden schreiben
+void logBurstStep();
+void logBurstReset();   // SD neu gemountet: laufende Aufzeichnung beenden
+
+LogBurstStats logBurstGetStats();
+
+// "<epoch>-<grund>.bin" -> erster Record + Grund
+bool logBurstParseName(const char* base, uint32_t& start, uint8_t& reason);
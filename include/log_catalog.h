@@ -0,0 +1,63 @@
+#pragma once
+#include <Arduino.h>
+#include "log_format.h"
+
+// Katalog der Log-Tage im RAM: je Tag Größe, Zeilen, erster/letzter Zeitstempel.
+// Wird beim Schreiben, Tageswechsel und Löschen nachgeführt und als /log/catalog.bin
+// gesichert -> Statusseiten, Verlauf und Aufräumen brauchen kein Verzeichnis-Listing.
+//
+// Datei: [LogCatalogHeader][LogCatalogDay * count], aufsteigend nach Tag.
+static constexpr uint32_t LOG_CATALOG_MAGIC = 0x5441434C;   // "LCAT"
+static constexpr uint8_t  LOG_CATALOG_VERSION = 1;
+static constexpr uint16_t LOG_CATALOG_MAX = 400;            // Tage im RAM (~10 kB)
+static constexpr uint8_t  LOG_CATALOG_ARC = 0x80;           // formats: Tag liegt im Monatsarchiv (.arc)
+
+struct __attribute__((packed)) LogCatalogHeader {
+  uint32_t magic;
+  uint8_t  version;
+  uint8_t  flags;      // bit0: Katalog unvollständig (mehr Tage als LOG_CATALOG_MAX)
+  uint16_t count;
+  uint16_t crc;        // logCrc16 über alle Einträge
+  uint16_t entry_size;
+};
+
+struct __attribute__((packed)) LogCatalogDay {
+  uint32_t day;        // YYYYMMDD
+  uint32_t first;      // epoch des ersten / letzten Werts
+  uint32_t last;
+  uint32_t rows;
+  uint32_t bytes;      // alle Dateien des Tages (.csv/.bin/.gor/.idx) bzw. sein Anteil am Archiv
+  uint32_t csv_bytes;  // davon CSV (Zeilen nachzählen ab hier)
+  uint8_t  formats;    // LOG_FMT_* der vorhandenen Dateien, LOG_CATALOG_ARC
+};
+
+// "YYYY-MM-DD" <-> YYYYMMDD (0 = ungültig)
+uint32_t logCatalogKey(const String& day);
+String   logCatalogDayString(uint32_t key);
+
+// Katalog laden, sonst aus /log neu aufbauen (einmalig: CSV-Tage werden dabei gezählt).
+// rebuild = true: Datei ignorieren und immer neu aufbauen (SD manuell aktualisiert).
+void logCatalogBegin(bool rebuild = false);
+void logCatalogReset();            // RAM verwerfen (Karte weg)
+
+// einen Tag neu aus seinen Dateien bestimmen (Boot: evtl. nach dem letzten Sichern weitergeschrieben)
+void logCatalogRefresh(const String& day);
+
+bool logCatalogReady();
+bool logCatalogComplete();         // false = mehr Tage auf der Karte als LOG_CATALOG_MAX
+
+// nach jedem Schreibvorgang: rows Samples [first..last], bytes/csvBytes neu auf der Karte
+void logCatalogAppend(const String& day, uint8_t formats, uint32_t rows, uint32_t first, uint32_t last,
+                      uint32_t bytes, uint32_t csvBytes);
+void logCatalogRemove(const String& day);
+// Tag ins Monatsarchiv übernommen, Einzeldateien werden gelöscht; bytes = Anteil im Archiv
+void logCatalogArchived(const String& day, uint32_t bytes);
+
+bool     logCatalogGet(const String& day, LogCatalogDay& out);
+bool     logCatalogOldest(LogCatalogDay& out);
+bool     logCatalogAt(uint16_t i, LogCatalogDay& out);   // i-ter Tag, aufsteigend
+uint16_t logCatalogCount();
+uint64_t logCatalogBytes();
+
+// geänderten Katalog sichern: force = sofort, sonst höchstens alle paar Minuten / bei Tageswechsel
+void logCatalogSync(bool force);
@@ -0,0 +1,63 @@
+#pragma once
+#include <Arduino.h>
+#include <FS.h>
+
+// Zeilenweiser CSV-Leser über einen File mit festem Blockpuffer: kein String, kein Heap.
+// Die aktuelle Zeile wird in einen Zeilenpuffer kopiert und dort in-place in Felder
+// zerlegt (',' -> '\0', Leerzeichen/'\r' abgeschnitten). Überlange Zeilen werden übersprungen.
+class LogCsvReader {
+public:
+  static constexpr uint8_t MAX_FIELDS = 16;
+  static constexpr size_t  MAX_LINE   = 160;
+
+  // liest ab der aktuellen Dateiposition
+  explicit LogCsvReader(File& f);
+
+  // nächste nicht-leere Zeile; false = Dateiende
+  bool next();
+
+  uint8_t     count() const { return _n; }
+  const char* field(uint8_t i) const { return (i < _n) ? _fld[i] : ""; }
+  int         find(const char* name) const;   // Spaltenindex per Name (Headerzeile), -1 wenn nicht da
+
+  // Dateiposition hinter der zuletzt gelieferten Zeile (der Puffer liest vor!)
+  uint32_t offset() const { return _fileOff + (uint32_t)_pos; }
+  void     seek(uint32_t off);
+
+  uint32_t skipped() const { return _skipped; }   // überlange Zeilen
+
+  // Zeilen mit Prüfsumme (Spalte "crc"): Zeilen mit falscher/fehlender CRC werden übersprungen.
+  // Erst nach der Headerzeile einschalten.
+  void     setCrc(bool on) { _crc = on; }
+  uint32_t crcErrors() const { return _crcErrors; }
+
+private:
+  bool fill();
+  void split(size_t len);
+
+  File&    _f;
+  char     _buf[512];
+  size_t   _len = 0;
+  size_t   _pos = 0;
+  uint32_t _fileOff = 0;   // Dateiposition von _buf[0]
+  char     _line[MAX_LINE];
+  char*    _fld[MAX_FIELDS];
+  uint8_t  _n = 0;
+  uint32_t _skipped = 0;
+  bool     _crc = false;
+  uint32_t _crcErrors = 0;
+};
+
+// Ergebnis beim Parsen eines Felds
+enum LogCsvField : uint8_t {
+  LOG_CSV_EMPTY = 0,   // leeres Feld (kein Wert)
+  LOG_CSV_OK,
+  LOG_CSV_BAD          // kein gültiger Zahlenwert
+};
+
+// Schnellpfad für [0-9]+ bzw. [-]ziffern[.ziffern], sonst strtof mit Endprüfung
+LogCsvField logCsvParseU32(const char* s, uint32_t& out);
+LogCsvField logCsvParseFloat(const char* s, float& out);
+
+// Zeile (ohne '\n') mit Prüfsummenspalte am Ende: CRC-16 passt zum Rest der Zeile
+bool logCsvLineCrcOk(const char* line, size_t len);
@@ -0,0 +1,67 @@
+#pragma once
+#include <Arduino.h>
+#include <FS.h>
+#include "log_format.h"
+
+// ===== Ringspeicher im internen Flash (LittleFS), wenn keine SD-Karte steckt =====
+//
+// /flog/NNNNNNNN.bin: Segmente mit fortlaufender Nummer, jedes ein kleines .bin (LogBinHeader +
+// Records fester Größe mit CRC, siehe log_format.h; day_start = epoch des ersten Records)
+// mit höchstens LOG_FLASH_SEG_BYTES.
+// Segmente werden nur angehängt, nie überschrieben; ist das Budget erreicht, wird beim Anlegen
+// eines neuen Segments das älteste gelöscht (Ring über Dateien). Welche Flash-Blöcke dabei benutzt
+// werden, verteilt LittleFS selbst über die ganze Partition (dynamisches Wear-Leveling).
+//
+// Kapazität: Segmente * (LOG_FLASH_SEG_BYTES - Header) / Recordgröße. Bei 4 Messwerten (22 B/Record)
+//   fasst ein Segment 744 Records; 512 KB Budget = 32 Segmente = 23808 Records
+//   = ~16,5 Tage bei 1 min, ~82 Tage bei 5 min, ~16 Monate bei 30 min.
+// Umlauf: das älteste Segment fällt als Ganzes weg -> nach dem ersten Umlauf sind immer
+//   (Segmente - 1) volle Segmente plus das laufende lesbar; die Historie verkürzt sich segmentweise.
+// Schreibverstärkung: LittleFS kopiert beim Anhängen den angefangenen letzten Block (4 KB) in einen
+//   frischen Block und schreibt einen Metadaten-Eintrag. Je Schreibvorgang also etwa
+//   Blockfüllstand + neue Daten + ~64 B -> im Flash-Betrieb wird nur mit vollem Puffer (32 Werte)
+//   bzw. spätestens nach 2 h geschrieben (logger.cpp). Geschätzt (LogFlashStats::flashBytes):
+//   Faktor ~4 bei 1 min, ~5 bei 5 min, ~16 bei 30 min; absolut 8..65 KB Flash je Tag, die
+//   Partition (~270 Blöcke à 100k Löschzyklen) hält damit weit länger als das Gerät.
+static constexpr const char* LOG_FLASH_DIR       = "/flog";
+static constexpr uint32_t    LOG_FLASH_SEG_BYTES = 16384;       // 4 LittleFS-Blöcke
+static constexpr uint32_t    LOG_FLASH_BLOCK     = 4096;
+static constexpr uint32_t    LOG_FLASH_RESERVE   = 96 * 1024;   // frei lassen für config.json & Co.
+static constexpr uint8_t     LOG_FLASH_MAX_SEGS  = 64;
+
+struct LogFlashSeg {
+  uint32_t seq = 0;
+  uint32_t first = 0;    // epoch erster / letzter Record (0 = leer)
+  uint32_t last = 0;
+  uint32_t bytes = 0;    // Dateigröße (angerissenes Segment: voll, damit nicht weiter angehängt wird)
+  uint16_t records = 0;
+  uint32_t mask = 0;     // log_metric_mask des Segments
+};
+
+struct LogFlashStats {
+  bool     active = false;
+  uint8_t  segments = 0;
+  uint8_t  maxSegments = 0;
+  uint32_t records = 0;        // lesbare Records
+  uint32_t bytes = 0;          // belegt im Flash (Dateigrößen)
+  uint32_t appends = 0;        // Schreibvorgänge seit Start
+  uint32_t wraps = 0;          // gelöschte Segmente (Umlauf)
+  uint64_t written = 0;        // geschriebene Nutzdaten seit Start
+  uint64_t flashBytes = 0;     // geschätzt tatsächlich programmierte Bytes (s.o.)
+};
+
+// Segmente einlesen und Budget festlegen (begrenzt durch den freien Platz); false = zu wenig Platz
+bool logFlashBegin(uint32_t budgetBytes);
+void logFlashEnd();          // SD ist (wieder) da -> nicht mehr schreiben
+bool logFlashActive();
+
+// Records anhängen (ein open/close je Segment); neues Segment bei voller Datei, anderer Maske
+// oder rückwärts gestellter Uhr, damit jedes Segment nach epoch sortiert bleibt
+bool logFlashAppend(uint32_t metricMask, const LogSample* rows, uint8_t n);
+
+// Segmente vom ältesten zum neuesten (Leser halten loggerSdLock(), der Storage-Task schreibt dann nicht)
+uint8_t logFlashSegmentCount();
+bool logFlashSegmentAt(uint8_t i, LogFlashSeg& out);
+File logFlashOpen(const LogFlashSeg& s);
+
+LogFlashStats logFlashGetStats();
@@ -0,0 +1,80 @@
+#pragma once
+#include <Arduino.h>
+#include <FS.h>
+#include <math.h>
+#include "log_bits.h"
+
+// Metriken in fester Spaltenreihenfolge (Bit in log_metric_mask -> Spalte)
+static constexpr uint8_t LOG_METRIC_COUNT = 4;   // temp, hum, press, co2 (lux später)
+
+struct LogMetricDef {
+  uint32_t    bit;
+  const char* key;   // API-Key, z.B. "temp"
+  const char* col;   // CSV-Spaltenname, z.B. "temp_c"
+};
+
+extern const LogMetricDef LOG_METRICS[LOG_METRIC_COUNT];
+
+// Index in LOG_METRICS fuer einen API-Key ("temp") bzw. CSV-Spaltennamen ("temp_c"), -1 wenn unbekannt
+int logMetricIndexByKey(const String& key);
+int logMetricIndexByCol(const String& col);
+
+// Ein Messpunkt, so wie er in die Tagesdateien geschrieben wird (NAN = kein Wert)
+struct LogSample {
+  uint32_t epoch = 0;
+  float    v[LOG_METRIC_COUNT] = { NAN, NAN, NAN, NAN };
+};
+
+// ===== Prüfsumme je Record (CRC-16/CCITT-FALSE) =====
+// CSV: letzte Spalte "crc" = 4 Hex-Zeichen über die Zeile vor dem letzten ','.
+// .bin ab Version 2: uint16 am Record-Ende über die Bytes davor.
+uint16_t logCrc16(const uint8_t* p, size_t n, uint16_t crc = 0xFFFF);
+
+static constexpr const char* LOG_CSV_COL_CRC = "crc";
+
+// ===== Pfade / Tage =====
+String logDayStringFromEpoch(time_t t);                          // "YYYY-MM-DD" (lokal)
+String logPathForDay(const String& day, const char* ext = ".csv"); // "/log/YYYY-MM-DD.csv"
+
+// ===== Binäre Tagesdatei /log/YYYY-MM-DD.bin =====
+//
+// [LogBinHeader][Record 0][Record 1]...
+// Record = uint32 epoch + float32 je gesetztem Bit in hdr.mask (Reihenfolge wie LOG_METRICS)
+// [+ uint16 CRC ab Version 2], little endian, NAN = kein Wert.
+// Records sind aufsteigend nach epoch -> binäre Suche möglich. Version 1 wird weiter gelesen.
+// Vorbelegte Dateien (log_prealloc) sind hinter dem letzten Record mit Nullen gefüllt:
+// das logische Ende ist der erste Record mit epoch 0; am Tagesende wird dort gekürzt.
+static constexpr uint32_t LOG_BIN_MAGIC   = 0x424C534D;   // "MSLB"
+static constexpr uint8_t  LOG_BIN_VERSION = 2;
+static constexpr uint8_t  LOG_BIN_MAX_REC = 4 + 4 * LOG_METRIC_COUNT + 2;
+
+struct __attribute__((packed)) LogBinHeader {
+  uint32_t magic;
+  uint8_t  version;
+  uint8_t  header_size;   // sizeof(LogBinHeader), damit spätere Versionen Felder anhängen können
+  uint16_t rec_size;
+  uint32_t mask;          // log_metric_mask beim Anlegen der Datei
+  uint32_t day_start;     // lokale Mitternacht (epoch)
+};
+
+void     logBinInitHeader(LogBinHeader& h, uint32_t mask, uint32_t dayStart);
+// base = Dateioffset des Headers (0; im Monatsarchiv: Offset des Tages)
+bool     logBinReadHeader(File& f, LogBinHeader& h, uint32_t base = 0);   // liest + prüft, Position danach = erster Record
+// Records bis zum logischen Ende; len = Bytes ab base (0 = bis Dateiende).
+// Nur wenn der letzte Record leer ist, wird das Ende binär gesucht (O(log n) Seeks).
+uint32_t logBinRecordCount(File& f, const LogBinHeader& h, uint32_t base = 0, uint32_t len = 0);
+size_t   logBinEncode(const LogBinHeader& h, const LogSample& s, uint8_t* out);
+void     logBinDecode(const LogBinHeader& h, const uint8_t* rec, LogSample& s);
+bool     logBinRecordOk(const LogBinHeader& h, const uint8_t* rec);   // CRC stimmt (v1: immer true)
+
+// Spaltenposition einer Metrik (Index in LOG_METRICS) im Record, -1 wenn nicht in hdr.mask
+int      logBinColumn(const LogBinHeader& h, int metricIdx);
+
+// Index des ersten Records mit epoch >= ep (binäre Suche, O(log n) Seeks)
+uint32_t logBinLowerBound(File& f, const LogBinHeader& h, uint32_t count, uint32_t ep, uint32_t base = 0);
+
+// ===== Hüllkurve /log/YYYY-MM-DD.env (log_agg_mode = Mittel + Min/Max) =====
+// Gleiches Format wie .bin, je Log-Zeitpunkt zwei Records mit derselben epoch: erst Min, dann Max
+// des Intervalls. Sortierung und binäre Suche bleiben gültig; ein einzelner Record am Ende
+// (Stromausfall zwischen beiden) wird beim Lesen verworfen.
+static constexpr const char* LOG_ENV_EXT = ".env";
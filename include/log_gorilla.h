@@ -0,0 +1,81 @@
+#pragma once
+#include <Arduino.h>
+#include "log_format.h"
+
+// ===== Komprimierte Tagesdatei /log/YYYY-MM-DD.gor =====
+//
+// Folge unabhängiger Blöcke fester Größe (LOG_GOR_BLOCK_SIZE), jeder Block für sich dekodierbar:
+// [LogGorBlockHeader][Payload-Bits]
+// Zeitstempel: Delta-of-Delta, Werte: XOR zum Vorgänger je Metrik (Gorilla-Verfahren).
+// Der erste Sample eines Blocks steht mit epoch im Header und rohen float32-Werten im Payload.
+// Der offene (letzte) Block wird bei jedem Sample an seiner Position neu geschrieben.
+// Vorbelegte Dateien (log_prealloc) haben hinter dem letzten Block Nullen -> logisches Ende
+// = erster Block ohne Magic (logGorBlockCount).
+static constexpr uint32_t LOG_GOR_MAGIC      = 0x31524F47;   // "GOR1"
+static constexpr uint16_t LOG_GOR_BLOCK_SIZE = 512;          // = ein SD-Sektor
+
+struct __attribute__((packed)) LogGorBlockHeader {
+  uint32_t magic;
+  uint32_t first_epoch;
+  uint32_t last_epoch;
+  uint16_t count;                   // Samples im Block
+  uint16_t bits;                    // belegte Payload-Bits
+  uint32_t mask;                    // log_metric_mask der Samples
+  float    min[LOG_METRIC_COUNT];   // NAN = kein Wert im Block
+  float    max[LOG_METRIC_COUNT];
+};
+
+static constexpr uint16_t LOG_GOR_PAYLOAD = LOG_GOR_BLOCK_SIZE - sizeof(LogGorBlockHeader);
+
+// Blöcke bis zum logischen Ende der Datei (binäre Suche nur, wenn der letzte Block leer ist)
+uint32_t logGorBlockCount(File& f);
+
+class LogGorEncoder {
+public:
+  void reset(uint32_t mask);                  // neuer, leerer Block
+  bool add(const LogSample& s);               // false = passt nicht mehr (Block unverändert)
+  bool resume(const uint8_t* block);          // Zustand aus einem geschriebenen Block wiederherstellen
+
+  bool     empty() const { return hdr().count == 0; }
+  uint32_t mask()  const { return hdr().mask; }
+  const uint8_t* block() const { return _blk; }
+
+private:
+  struct State {
+    uint16_t bits;
+    uint32_t prevEpoch;
+    int32_t  prevDelta;
+    uint32_t prev[LOG_METRIC_COUNT];
+    uint8_t  lead[LOG_METRIC_COUNT];
+    uint8_t  trail[LOG_METRIC_COUNT];
+  };
+
+  LogGorBlockHeader&       hdr()       { return *(LogGorBlockHeader*)_blk; }
+  const LogGorBlockHeader& hdr() const { return *(const LogGorBlockHeader*)_blk; }
+  bool put(uint32_t v, uint8_t n);
+  bool putValue(int i, uint32_t bits);
+
+  uint8_t _blk[LOG_GOR_BLOCK_SIZE];
+  State   _st {};
+};
+
+class LogGorDecoder {
+public:
+  bool begin(const uint8_t* block);           // Header prüfen
+  bool next(LogSample& s);                    // false = Block zu Ende / defekt
+
+  const LogGorBlockHeader& header() const { return _h; }
+
+private:
+  bool get(uint8_t n, uint32_t& v);
+
+  LogGorBlockHeader _h {};
+  const uint8_t*    _p = nullptr;
+  uint16_t _pos = 0;
+  uint16_t _i = 0;
+  uint32_t _prevEpoch = 0;
+  int32_t  _prevDelta = 0;
+  uint32_t _prev[LOG_METRIC_COUNT] = {};
+  uint8_t  _lead[LOG_METRIC_COUNT] = {};
+  uint8_t  _trail[LOG_METRIC_COUNT] = {};
+};
@@ -0,0 +1,29 @@
+#pragma once
+#include <Arduino.h>
+
+// Dünner Index je CSV-Tagesdatei: /log/YYYY-MM-DD.idx
+// Folge von {epoch, offset} (je 8 Byte, aufsteigend), ein Eintrag spätestens alle
+// LOG_INDEX_STEP_SEC Sekunden. offset zeigt auf den Zeilenanfang in der CSV.
+static constexpr uint32_t LOG_INDEX_STEP_SEC = 600;   // 10 Minuten
+
+struct __attribute__((packed)) LogIndexEntry {
+  uint32_t epoch;
+  uint32_t offset;
+};
+
+// letzter Eintrag; false wenn Index fehlt/leer
+bool logIndexLast(const String& day, LogIndexEntry& last);
+
+bool logIndexAppend(const String& day, const LogIndexEntry& e);
+
+// true, wenn der Index zur CSV passt (letzter Eintrag zeigt auf eine Zeile mit genau diesem epoch)
+bool logIndexValid(const String& day);
+
+// Index aus der CSV neu erzeugen (ein sequentieller Lauf über die Datei)
+bool logIndexRebuild(const String& day);
+
+// Byteoffset in der CSV, ab dem Zeilen mit epoch >= ep liegen können; 0 = von vorne lesen
+uint32_t logIndexSeekOffset(const String& day, uint32_t ep);
+
+// Wird vor dem Lesen aufgerufen: fehlenden/veralteten Index neu aufbauen (nur wenn sich das lohnt)
+void logIndexEnsure(const String& day);
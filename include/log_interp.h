@@ -0,0 +1,41 @@
+#pragma once
+#include <Arduino.h>
+#include "log_format.h"
+#include "log_sdt.h"
+
+// ===== Lücken im Verlauf linear auffüllen (/api/history?interp=1) =====
+//
+// Kompression (log_sdt_*) und eigene Intervalle (log_every_*) lassen Zellen leer (NAN). Zwischen
+// zwei gespeicherten Werten einer Spalte wird auf die Zeitachse der Zeilen interpoliert.
+// Zeilen warten, bis der nächste Wert ihrer leeren Spalten da ist (fester Ring). Beide Quellen
+// halten den Abstand zweier Werte einer Metrik bei höchstens LOG_SDT_RING Zeilen
+// (log_every_* <= 60), der Ring reicht dafür; nur längere Lücken (Sensor- bzw. Metrik-Ausfall)
+// bleiben leer. Spalten: ein Wert je Metrik bzw. Min/Max je Metrik (Hüllkurve).
+static constexpr uint8_t LOG_INTERP_ROWS = LOG_SDT_RING;
+static constexpr uint8_t LOG_INTERP_COLS = 2 * LOG_METRIC_COUNT;
+
+class LogInterp {
+public:
+  void begin(uint8_t cols);   // setzt den Zustand zurück
+
+  // nächste Zeile (epoch aufsteigend); danach pop() bis false, sonst läuft der Ring über
+  void push(uint32_t ep, const float* vals);
+  bool pop(uint32_t& ep, float* vals);   // nächste fertige Zeile, cols Werte
+  void finish();                         // Ende der Daten: restliche Zeilen ohne Auffüllen freigeben
+
+  uint32_t filled() const { return _filled; }
+
+private:
+  bool waiting(uint8_t r) const;
+
+  uint8_t  _cols = 1;
+  uint8_t  _head = 0;
+  uint8_t  _n = 0;
+  bool     _final = false;
+  uint32_t _ep[LOG_INTERP_ROWS];
+  float    _v[LOG_INTERP_ROWS][LOG_INTERP_COLS];
+  bool     _has[LOG_INTERP_COLS] = {};        // Spalte hatte schon einen Wert
+  uint32_t _lastEp[LOG_INTERP_COLS] = {};
+  float    _lastV[LOG_INTERP_COLS] = {};
+  uint32_t _filled = 0;
+};
@@ -0,0 +1,52 @@
+#pragma once
+#include <Arduino.h>
+
+// ===== SD-Latenz je Operation (Schreibpfad des Loggers) =====
+//
+// Histogramm mit Zweierpotenz-Buckets: Bucket k zählt Dauern < LOG_LAT_BASE_US << k,
+// der letzte Bucket alles darüber (ab ~1 s). Geschrieben wird nur im Storage-Task;
+// Leser (Webserver) bekommen eine Kopie, ein dabei zerrissener Zähler verfälscht höchstens eine Anzeige.
+//
+// Zusätzlich wird ein Fenster über alle Operationen bewertet: liegt dessen p99 über der Schwelle
+// (log_slow_ms), gilt die Karte als langsam -> der Logger schreibt seltener in größeren Blöcken,
+// bis ein Fenster wieder unter der halben Schwelle bleibt.
+enum LogSdOp : uint8_t { LOG_OP_OPEN, LOG_OP_WRITE, LOG_OP_CLOSE, LOG_OP_MKDIR, LOG_OP_REMOVE, LOG_OP_COUNT };
+
+static constexpr uint8_t  LOG_LAT_BUCKETS = 16;
+static constexpr uint32_t LOG_LAT_BASE_US = 64;
+static constexpr uint16_t LOG_LAT_WINDOW  = 128;   // Operationen je Bewertung
+
+struct LogLatencyHist {
+  uint32_t count = 0;
+  uint32_t maxUs = 0;
+  uint64_t totalUs = 0;
+  uint32_t buckets[LOG_LAT_BUCKETS] = {};
+
+  void add(uint32_t us);
+  // Obergrenze des Buckets, in dem das permille-Quantil liegt (letzter Bucket: maxUs)
+  uint32_t percentileUs(uint16_t permille) const;
+};
+
+struct LogLatencyHealth {
+  bool     slow = false;        // Karte gilt gerade als langsam (größere Schreibblöcke)
+  uint32_t slowEvents = 0;      // Wechsel schnell -> langsam seit Start
+  uint32_t stalls = 0;          // einzelne Operationen über der Schwelle
+  uint32_t windows = 0;         // bewertete Fenster
+  uint32_t lastP99Us = 0;       // p99 des letzten Fensters
+  uint16_t thresholdMs = 0;     // 0 = Bewertung aus
+};
+
+const char* logSdOpName(uint8_t op);          // "open", "write", ...
+uint32_t logLatencyBucketLimitUs(uint8_t k);  // Obergrenze von Bucket k (letzter: 0 = offen)
+
+void logLatencyAdd(uint8_t op, uint32_t us);
+
+// mkdir/remove mit Zeitmessung, für alle Module im Storage-Task (Logger, Burst-Aufzeichnung)
+bool logSdMkdir(const String& path);
+bool logSdRemove(const String& path);
+LogLatencyHist logLatencyGet(uint8_t op);
+void logLatencySetThreshold(uint16_t ms);
+LogLatencyHealth logLatencyHealth();
+
+// alle Histogramme und die Bewertung als JSON-Objekt
+String logLatencyJson();
@@ -0,0 +1,45 @@
+#pragma once
+#include <Arduino.h>
+#include "log_format.h"
+
+// ===== Log-Werte vor der ersten gültigen Uhrzeit (NTP) =====
+//
+// Solange die Zeit nicht gültig ist, merkt sich der Logger seine Intervallwerte mit millis()
+// statt epoch. Sobald die Zeit gültig wird, rechnet er sie über (epoch jetzt, millis jetzt)
+// auf Wandzeit um und schreibt sie gesammelt in die passenden Tagesdateien.
+//
+// Der Puffer liegt im RTC-RAM (RTC_NOINIT_ATTR) und übersteht damit einen Software-Reset bzw.
+// Watchdog/Panic (nicht Strom aus): beim Start werden die Einträge auf die neue millis()-Zeitachse
+// verschoben (vor dem Reset = unter 0, Abstände rechnen wie millis() modulo 2^32). Grundlage ist
+// das zuletzt gemerkte millis() vor dem Reset (je Messung nachgeführt), die Dauer des Neustarts
+// selbst fehlt -> Fehler < ~1 s.
+// Voll -> der älteste Eintrag fällt weg (gezählt).
+static constexpr uint8_t LOG_PRE_CAPACITY = 48;   // 64 B je Eintrag; 30 min Intervall = 24 h
+
+struct LogPreEntry {
+  uint32_t  ms = 0;        // millis() des Log-Zeitpunkts (vor dem letzten Reset: modulo 2^32 davor)
+  LogSample s, mn, mx;     // Wert und Min/Max des Intervalls (log_agg.h), epoch noch 0
+};
+
+struct LogPreStats {
+  uint8_t  capacity = LOG_PRE_CAPACITY;
+  uint8_t  pending = 0;        // Einträge, die auf die Uhrzeit warten
+  uint8_t  restored = 0;       // beim Start aus dem RTC-RAM übernommen
+  uint32_t recovered = 0;      // nachträglich mit Zeitstempel geschrieben
+  uint32_t dropped = 0;        // Puffer voll bzw. Zeitstempel unplausibel
+};
+
+// einmal beim Start: RTC-Inhalt prüfen (nicht nach Power-on), auf die neue Zeitachse verschieben
+void logPreBegin();
+
+// Log-Zeitpunkt ohne gültige Zeit merken
+void logPrePush(const LogPreEntry& e);
+
+// millis() fortschreiben (jede Messung), damit ein Reset die Einträge richtig verschiebt
+void logPreTouch(uint32_t ms);
+
+uint8_t logPreCount();
+bool logPreAt(uint8_t i, LogPreEntry& out);   // ältester zuerst
+void logPreClear(uint32_t recovered, uint32_t dropped);
+
+LogPreStats logPreGetStats();
@@ -0,0 +1,46 @@
+#pragma once
+#include <Arduino.h>
+#include "log_format.h"
+
+// Tageszusammenfassung je Metrik, Monatsdatei /log/YYYY-MM.sum mit 31 festen Slots
+// (Slot = Tag im Monat - 1) -> ein Tag = ein Seek + ein Record.
+static constexpr uint8_t LOG_ROLLUP_FINAL    = (1u << 0);   // Tag abgeschlossen
+static constexpr uint8_t LOG_ROLLUP_BACKFILL = (1u << 1);   // wird gerade aus der Tagesdatei nachberechnet
+
+struct __attribute__((packed)) LogRollupMetric {
+  uint32_t count;
+  double   sum;
+  float    min;
+  float    max;
+  uint32_t first;   // epoch des ersten Werts
+  uint32_t last;    // epoch des letzten Werts
+};
+
+struct __attribute__((packed)) LogRollupDay {
+  uint32_t day;       // YYYYMMDD, 0 = Slot leer
+  uint8_t  flags;     // LOG_ROLLUP_*
+  uint8_t  reserved[3];
+  uint32_t src_off;   // Backfill: Fortschritt (Byteoffset in der Tagesdatei)
+  LogRollupMetric m[LOG_METRIC_COUNT];
+};
+
+// O(1) je Sample: RAM-Akkumulator des Tages fortschreiben; mn/mx = Extremwerte des Intervalls
+// (log_agg_mode = Mittel + Min/Max), sonst zählen Min/Max der geloggten Werte.
+// Wechselt der Tag, wird der vorige Tag als abgeschlossen markiert und geschrieben.
+void logRollupAdd(const String& day, const LogSample& s, const LogSample* mn = nullptr, const LogSample* mx = nullptr);
+
+// Slot des laufenden Tages schreiben (einmal je Schreibvorgang des Loggers)
+void logRollupSync();
+
+// RAM-Zustand verwerfen (SD neu gemountet)
+void logRollupReset();
+
+// Slot eines Tages ("YYYY-MM-DD") lesen; false wenn nicht vorhanden
+bool logRollupRead(const String& day, LogRollupDay& out);
+
+// Mittelwert einer Metrik (Index in LOG_METRICS), NAN wenn keine Werte
+float logRollupMean(const LogRollupDay& d, int metricIdx);
+
+// Hintergrundjob: fehlende/unvollständige Slots vergangener Tage aus den Tagesdateien
+// nachrechnen. Bearbeitet pro Aufruf nur wenige Zeilen, Fortschritt steht im Slot.
+void logRollupBackfillStep(const String& today);
@@ -0,0 +1,67 @@
+#pragma once
+#include <Arduino.h>
+
+// ===== SD-Karte: SPI-Takt aushandeln + Benchmark =====
+//
+// Aushandeln (log_sd_hz = 0): der Takt wird in Stufen (LOG_SD_HZ_STEPS) erhöht, je Stufe wird neu
+// eingehängt und ein Testmuster geschrieben und zurückgelesen (CRC, zwei Durchgänge). Es gilt die
+// höchste Stufe ohne Fehler; der Logger merkt sie sich mit einer Kennung der Karte in der Konfiguration
+// und prüft beim nächsten Einhängen nur noch diese eine Stufe (schlägt sie fehl: neu aushandeln).
+//
+// Benchmark (Web, auf Anforderung): sequentiell schreiben/lesen, kleine Appends wie der Logger
+// (offene Datei + flush), Öffnen+Schließen.
+// Beides schreibt in LOG_SD_TEST_FILE (danach gelöscht) und braucht die SD-Sperre.
+static constexpr uint32_t    LOG_SD_HZ_STEPS[]    = { 4000000, 8000000, 10000000, 16000000, 20000000, 26666667, 40000000 };
+static constexpr uint8_t     LOG_SD_HZ_STEP_COUNT = sizeof(LOG_SD_HZ_STEPS) / sizeof(LOG_SD_HZ_STEPS[0]);
+static constexpr const char* LOG_SD_TEST_FILE     = "/.sdtest.tmp";
+static constexpr uint32_t    LOG_SD_VERIFY_BYTES  = 32768;    // je Prüfdurchgang
+static constexpr uint32_t    LOG_SD_BENCH_BYTES   = 1048576;  // sequentiell schreiben/lesen
+static constexpr uint16_t    LOG_SD_BENCH_APPENDS = 200;      // à 24 Byte (ein .bin-Record)
+static constexpr uint16_t    LOG_SD_BENCH_OPENS   = 50;
+
+// SD.end() + SD.begin(..., hz); true = Karte eingehängt
+typedef bool (*LogSdMountFn)(uint32_t hz);
+
+struct LogSdStep {
+  uint32_t hz = 0;
+  bool     ok = false;
+  uint32_t us = 0;      // Einhängen + Prüfen
+};
+
+struct LogSdClock {
+  uint32_t  hz = 0;              // aktueller Takt (0 = nicht eingehängt)
+  bool      fixed = false;       // log_sd_hz fest eingestellt
+  bool      negotiated = false;  // in diesem Einhängen ausgehandelt (sonst gemerkt bzw. fest)
+  uint32_t  cardId = 0;          // logSdCardId()
+  uint8_t   steps = 0;
+  LogSdStep step[LOG_SD_HZ_STEP_COUNT + 1];   // + Prüfung des gemerkten Takts
+};
+
+struct LogSdBench {
+  bool     ok = false;
+  uint32_t epoch = 0;
+  uint32_t hz = 0;
+  uint32_t seqBytes = 0;
+  uint32_t seqWriteKBs = 0;      // KB/s
+  uint32_t seqReadKBs = 0;
+  uint32_t appendAvgUs = 0;      // je Append inkl. flush
+  uint32_t appendMaxUs = 0;
+  uint32_t openCloseAvgUs = 0;   // Öffnen (Anhängen) + Schließen
+  uint32_t crcErrors = 0;        // zurückgelesen != geschrieben
+  uint32_t durationMs = 0;
+};
+
+// Kennung der eingehängten Karte aus Typ und Größe (0 = keine); genügt, um einen Kartenwechsel zu erkennen
+uint32_t logSdCardId();
+
+// Testmuster schreiben und zurücklesen, true = identisch
+bool logSdVerify(uint32_t bytes);
+
+// knownHz (0 = keiner): zuerst diesen Takt prüfen, sonst von unten hochstufen.
+// Lässt die Karte mit dem Ergebnis eingehängt; 0 = keine Karte.
+uint32_t logSdNegotiate(LogSdMountFn mount, uint32_t knownHz, LogSdClock& out);
+
+bool logSdRunBench(uint32_t hz, LogSdBench& out);
+
+// {"clock":{...},"bench":{...}} (bench = null, solange keiner gelaufen ist)
+String logSdJson(const LogSdClock& c, const LogSdBench* b);
@@ -0,0 +1,70 @@
+#pragma once
+#include <Arduino.h>
+#include "log_format.h"
+
+// ===== Swinging-Door-Kompression der Tagesdateien (log_sdt_*) =====
+//
+// Je Metrik wird nur gespeichert, was nötig ist, um die Reihe durch lineare Interpolation zwischen
+// den gespeicherten Punkten mit höchstens der Toleranz E wiederherzustellen (Verlauf: interp=1).
+// Vom letzten gespeicherten Punkt A aus wird ein Korridor möglicher Steigungen geführt
+// ([lo, hi], jeder neue Wert x engt ihn auf (x +- E - A) / dt ein). Wird er leer, wird der
+// zurückgehaltene Punkt davor gespeichert, und zwar mit einem Wert auf der Geraden im Korridor
+// (nicht dem gemessenen): damit liegen alle übersprungenen Werte und er selbst innerhalb E.
+// Der neue Punkt ist dann der Anfang des nächsten Korridors.
+//
+// Weil über einen Punkt erst mit einem späteren entschieden wird, hält der Kompressor die Zeilen
+// ab dem ältesten offenen Punkt zurück (fester Ring). Zwei gespeicherte Werte einer Metrik liegen
+// höchstens LOG_SDT_RING Zeilen auseinander (auch mit log_every_*), solange die Metrik Werte
+// liefert: reicht der Korridor weiter, wird trotzdem gespeichert; wird der Ring voll, werden die
+// offenen Punkte der ältesten Zeile gespeichert -> der Verlauf braucht zum Auffüllen höchstens so
+// viele Zeilen (log_interp.h).
+// Zeilen, in denen kein Wert übrig bleibt, fallen weg; übrige Zellen sind NAN (wie log_every_*).
+// Die CSV rundet zusätzlich auf 0,01.
+static constexpr uint8_t LOG_SDT_RING = 64;
+
+class LogSdt {
+public:
+  // Toleranz je Metrik (Einheit der Metrik, 0 = jeden Wert speichern); setzt den Zustand zurück
+  void configure(const float* tol);
+  bool enabled() const { return _on; }
+
+  // nächster Log-Zeitpunkt (epoch aufsteigend); danach pop() bis false, sonst läuft der Ring über
+  void push(const LogSample& s);
+  bool pop(LogSample& out);        // nächste fertige Zeile
+  void finish();                   // alle zurückgehaltenen Punkte speichern (Tageswechsel, Flush)
+
+  uint8_t  pending() const { return _count; }
+  // k-te zurückgehaltene Zeile (0 = älteste) im jetzigen Stand: verworfene Werte NAN,
+  // offene mit dem Messwert (zum Lesen vor dem Schreiben, ändert nichts)
+  bool     peek(uint8_t k, LogSample& out) const;
+  uint32_t valuesIn() const { return _in; }
+  uint32_t valuesKept() const { return _kept; }
+
+private:
+  struct Door {
+    bool     anchor = false;   // A gesetzt
+    uint32_t ta = 0;
+    float    a = 0;
+    int16_t  held = -1;        // Ringplatz des zurückgehaltenen Punkts P (-1 = keiner)
+    uint32_t tp = 0;
+    float    p = 0;
+    float    lo = 0, hi = 0;   // Steigungskorridor ab A einschließlich P
+    uint32_t ra = 0, rp = 0;   // Zeilennummer (push) von A und P
+  };
+
+  void keepHeld(int i);
+  void holdNew(int i, uint8_t slot, uint32_t t, float v);
+  void closeHead();
+  uint8_t slotAt(uint8_t k) const { return (uint8_t)((_head + k) % LOG_SDT_RING); }
+
+  bool      _on = false;
+  float     _tol[LOG_METRIC_COUNT] = {};
+  Door      _d[LOG_METRIC_COUNT];
+  LogSample _rows[LOG_SDT_RING];
+  uint8_t   _open[LOG_SDT_RING] = {};   // Bit je Metrik: Wert noch nicht entschieden
+  uint8_t   _head = 0;
+  uint8_t   _count = 0;
+  uint32_t  _seq = 0;                   // Zeilennummer der nächsten push()-Zeile
+  uint32_t  _in = 0;
+  uint32_t  _kept = 0;
+};
@@ -2,6 +2,8 @@
 #include <Arduino.h>
 #include "settings.h"
 #include "log_bits.h"
+#include "log_format.h"
+#include "log_sdbench.h"
 
 struct SensorData;
 
@@ -12,13 +14,109 @@ struct LoggerSdInfo {
   uint64_t free  = 0;
 };
 
+// Schreibstatistik (seit Start)
+struct LoggerStats {
+  uint32_t samples = 0;        // geloggte Samples
+  uint32_t flushes = 0;        // gebündelte Schreibvorgänge
+  uint32_t fileOpens = 0;      // SD.open im Schreibpfad
+  uint8_t  pending = 0;        // Samples, die noch im RAM-Puffer stehen
+  uint32_t lastFlushUs = 0;
+  uint32_t maxFlushUs = 0;
+  uint64_t totalFlushUs = 0;   // Summe der Schreibzeit im Storage-Task
+  uint32_t dropped = 0;        // Queue voll -> Auftrag verworfen
+  uint8_t  queueDepth = 0;     // Aufträge, die gerade in der Queue warten
+  uint8_t  queueMax = 0;       // höchster Queue-Stand seit Start
+  uint32_t maxEnqueueUs = 0;   // längste Zeit, die loop() zum Einreihen gebraucht hat
+
+  // Kompression der Tagesdateien (log_sdt_*, log_sdt.h)
+  uint32_t sdtIn = 0;          // Werte seit Start
+  uint32_t sdtKept = 0;        // davon gespeichert
+
+  // Aufräumen (Alter/Quota), läuft in Zeitscheiben im Storage-Task
+  uint32_t cleanupPasses = 0;      // abgeschlossene Durchgänge
+  uint32_t cleanupSteps = 0;       // Zeitscheiben
+  uint32_t cleanupLastStepUs = 0;
+  uint32_t cleanupMaxStepUs = 0;
+  uint32_t cleanupFiles = 0;       // gelöschte Dateien
+  uint64_t cleanupBytes = 0;       // freigegebene Bytes
+  uint64_t logBytes = 0;           // Größe von /log beim letzten Durchgang
+
+  // Monatsarchiv
+  uint32_t archiveDays = 0;        // übernommene Tage
+  uint64_t archiveBytesIn = 0;     // Einzeldateien davor
+  uint64_t archiveBytesOut = 0;    // im Archiv
+
+  // Ringspeicher im internen Flash (nur ohne SD-Karte)
+  bool     flashActive = false;
+  uint32_t flashRecords = 0;
+  uint32_t flashBytes = 0;
+  uint8_t  flashSegments = 0;
+  uint8_t  flashMaxSegments = 0;
+  uint32_t flashWraps = 0;         // gelöschte Segmente seit Start
+  uint64_t flashWritten = 0;       // Nutzdaten seit Start
+  uint64_t flashProgrammed = 0;    // davon tatsächlich programmiert (Schätzung inkl. Blockkopien)
+
+  // Werte vor der ersten gültigen Uhrzeit (log_pretime.h)
+  uint8_t  preCapacity = 0;
+  uint8_t  prePending = 0;         // warten auf die Uhrzeit
+  uint8_t  preRestored = 0;        // nach Reset aus dem RTC-RAM übernommen
+  uint32_t preRecovered = 0;       // nachträglich mit Zeitstempel geschrieben
+  uint32_t preDropped = 0;         // Puffer voll / Zeitstempel unplausibel
+};
+
 void loggerBegin(const AppConfig& cfg);
 void loggerLoop(const AppConfig& cfg, const SensorData& data);
 
+// jede Messung (1 s) für den Mittelwert/Min/Max des nächsten Log-Zeitpunkts (log_agg_mode);
+// NAN = kein neuer Wert dieser Metrik. O(1), kein SD-Zugriff.
+void loggerAccumulate(const SensorData& fresh);
+
+// jede Messung (1 s) in den Ring der Burst-Aufzeichnung (log_burst.h), Trigger prüfen
+void loggerBurst(const AppConfig& cfg, const SensorData& live);
+
 void loggerForceOnce(const AppConfig& cfg, const SensorData& data);
 
-void loggerRescan();   // SD neu initialisieren
+void loggerRescan(const AppConfig& cfg);   // SD neu initialisieren (SPI-Takt, Flash-Ersatz aus cfg)
+
+// SPI-Takt der SD (log_sdbench.h). Ausgehandelten Takt + Kartenkennung in cfg übernehmen und
+// speichern, wenn er sich geändert hat (nach loggerBegin/loggerRescan aufrufen); true = gespeichert.
+bool loggerStoreSdClock(AppConfig& cfg);
+uint32_t loggerSdHz();           // 0 = keine SD
+bool loggerSdBench();            // Benchmark auf der eingehängten Karte (blockiert ~1-3 s)
+LogSdBench loggerGetSdBench();   // letzter Benchmark (epoch = 0: noch keiner)
+String loggerSdClockJson();      // Takt, Stufen des Aushandelns, letzter Benchmark
+
+// gepufferte Samples sofort schreiben (vor Neustart, Einstellungsänderung, ...).
+// Wartet auf den Storage-Task -> nicht aufrufen, während loggerSdLock() gehalten wird.
+void loggerFlush();
+LoggerStats loggerGetStats();
 
 bool loggerSdOk();
-LoggerSdInfo loggerGetSdInfo();
-uint16_t loggerCountLogDays();     // Anzahl Dateien in /log
+bool loggerFlashActive();          // keine SD, es wird in den Flash-Ring geschrieben (log_flash.h)
+LoggerSdInfo loggerGetSdInfo();    // Belegung beim Einhängen + Änderung laut Katalog
+uint16_t loggerCountLogDays();     // Anzahl Log-Tage (aus dem Katalog, ohne SD-Zugriff)
+
+// Die SD gehört dem Storage-Task. Wer sonst auf die Karte zugreift (Verlauf lesen, Export),
+// hält solange diese Sperre; false = Task blockiert länger als timeoutMs.
+bool loggerSdLock(uint32_t timeoutMs = 5000);
+void loggerSdUnlock();
+
+// Zeilen, die der Storage-Task noch nicht geschrieben hat, i = 0 -> älteste: erst die von der
+// Kompression (log_sdt_*) zurückgehaltenen, dann der Schreibpuffer.
+// Nur mit gehaltener loggerSdLock(); Leser hängen sie an die Tagesdateien an, statt loggerFlush()
+// das Haltefenster (log_flush_sec) abbrechen und zurückgehaltene Punkte speichern zu lassen.
+// mn/mx (Hüllkurve): ohne Min/Max im Puffer min = max = Wert; false für zurückgehaltene Zeilen,
+// deren Hüllkurve schon in der .env steht (überspringen).
+uint16_t loggerPendingCount();
+bool     loggerPendingGet(uint16_t i, LogSample& s, LogSample* mn = nullptr, LogSample* mx = nullptr);
+
+class LoggerSdGuard {
+public:
+  explicit LoggerSdGuard(uint32_t timeoutMs = 5000) : _held(loggerSdLock(timeoutMs)) {}
+  ~LoggerSdGuard() { if (_held) loggerSdUnlock(); }
+  LoggerSdGuard(const LoggerSdGuard&) = delete;
+  LoggerSdGuard& operator=(const LoggerSdGuard&) = delete;
+  bool held() const { return _held; }
+private:
+  bool _held;
+};
@@ -47,6 +47,9 @@ void pageOtaUpload(WebServer &server);      // Upload-Handler
 // API
 void apiLive(WebServer &server);
 void apiHistory(WebServer &server);
+void apiLogCsv(WebServer &server);
+void apiLogLatency(WebServer &server);   // SD-Latenz je Operation (JSON)
+void apiLogSdBench(WebServer &server);   // SPI-Takt der SD + letzter Benchmark (JSON)
 
 // ===== Shared helpers (werden in pages.cpp definiert, von Subpages genutzt) =====
 AppConfig* pagesCfg();
@@ -0,0 +1,24 @@
+#pragma once
+#include <Arduino.h>
+#include "log_format.h"
+
+struct SensorData;
+
+// Ringpuffer der letzten Messwerte im RAM: Mittelwert je SAMPLE_RING_STEP_SEC aus den
+// Sekundenwerten, SAMPLE_RING_CAPACITY Einträge (= 1 h). Statisch angelegt, kein Heap.
+static constexpr uint16_t SAMPLE_RING_STEP_SEC = 10;
+static constexpr uint16_t SAMPLE_RING_CAPACITY = 360;
+
+// Festkomma je Metrik (Reihenfolge wie LOG_METRICS), INT16_MIN = kein Wert
+struct __attribute__((packed)) SampleRingEntry {
+  uint32_t epoch;                  // Beginn des Intervalls
+  int16_t  v[LOG_METRIC_COUNT];    // temp 0.01 °C, hum 0.01 %, press 0.1 hPa, co2 1 ppm
+};
+
+// aus dem Sekundentakt in loop() aufrufen; ohne gültige Uhrzeit wird nichts gespeichert
+void sampleRingPush(time_t now, const SensorData& d);
+
+uint16_t sampleRingCount();
+uint32_t sampleRingOldest();                      // epoch des ältesten Eintrags, 0 wenn leer
+bool     sampleRingGet(uint16_t i, LogSample& s); // i = 0 -> ältester Eintrag
+size_t   sampleRingBytes();                       // belegter RAM (statisch)
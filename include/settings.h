@@ -60,6 +60,68 @@ struct AppConfig {
   // 0 = nie löschen
   uint16_t log_retention_days = 30;
 
+  // Dateiformat(e) der Tagesdateien (LOG_FMT_*), Default: nur CSV
+  uint32_t log_format_mask    = LOG_FMT_CSV;
+
+  // Haltefenster des Schreibpuffers in Sekunden (0 = jedes Sample sofort schreiben).
+  // Bei Stromausfall gehen höchstens so viele Sekunden verloren.
+  uint16_t log_flush_sec      = 300;
+
+  // Obergrenze für /log in Bytes (0 = keine); darüber werden die ältesten Tage gelöscht
+  uint32_t log_max_bytes      = 0;
+
+  // Aufräumen: max. Zeit je Schritt des Storage-Tasks in ms
+  uint16_t log_cleanup_budget_ms = 20;
+
+  // Tage älter als so viele Tage ins Monatsarchiv /log/YYYY-MM.arc übernehmen (0 = aus),
+  // komprimiert (.gor-Blöcke) oder binär
+  uint16_t log_archive_days     = 0;
+  bool     log_archive_compress = true;
+
+  // .bin/.gor beim ersten Schreiben des Tages auf die erwartete Tagesgröße vorbelegen
+  // (Intervall * Metriken), beim Tageswechsel aufs logische Ende gekürzt
+  bool     log_prealloc         = false;
+
+  // SD gilt als langsam, wenn das p99 der Schreibzugriffe darüber liegt (ms, 0 = aus)
+  // -> Haltefenster wird verlängert, es wird seltener in größeren Blöcken geschrieben
+  uint16_t log_slow_ms          = 250;
+
+  // SPI-Takt der SD in Hz (0 = automatisch aushandeln, siehe log_sdbench.h);
+  // log_sd_auto_hz/log_sd_card: zuletzt ausgehandelter Takt und die Karte dazu (schreibt der Logger)
+  uint32_t log_sd_hz            = 0;
+  uint32_t log_sd_auto_hz       = 0;
+  uint32_t log_sd_card          = 0;
+
+  // ohne SD-Karte in einen Ringspeicher im internen Flash (LittleFS) loggen: Budget in KB (0 = aus)
+  uint16_t log_flash_kb         = 512;
+
+  // eigenes Intervall je Metrik als Vielfaches von log_interval_min (1 = jede Zeile): dazwischen bleibt
+  // die Spalte leer (NAN), der Mittelwert läuft über das ganze eigene Intervall. Der Verlauf überspringt
+  // Zeilen ohne einen der abgefragten Werte.
+  uint8_t  log_every_temp       = 1;
+  uint8_t  log_every_hum        = 1;
+  uint8_t  log_every_press      = 1;
+  uint8_t  log_every_co2        = 1;
+
+  // Kompression der Tagesdateien (log_sdt.h): Toleranz je Metrik in Hundertstel der Einheit (0 = aus).
+  // Gespeichert werden nur die Punkte, aus denen der Verlauf die Reihe linear interpoliert auf
+  // höchstens diese Abweichung wiederherstellt; Tageszusammenfassungen rechnen mit allen Werten.
+  uint16_t log_sdt_temp         = 0;
+  uint16_t log_sdt_hum          = 0;
+  uint16_t log_sdt_press        = 0;
+  uint16_t log_sdt_co2          = 0;
+
+  // was je Log-Intervall geschrieben wird: 0 = Momentanwert, 1 = Mittelwert der 1-s-Messungen,
+  // 2 = Mittelwert + Min/Max (Hüllkurve in /log/YYYY-MM-DD.env, siehe log_agg.h)
+  uint8_t  log_agg_mode         = 1;
+
+  // Burst: jede Sekunde in /log/burst/ ab 2 min vor bis so viele Sekunden nach einem Trigger (0 = aus);
+  // Trigger: CO2 ändert sich um mind. log_burst_slope ppm/min (0 = aus; nur mit CO2 in log_metric_mask), zu jeder log_burst_every_h-ten
+  // vollen Stunde (0 = aus), manuell über Web (/action/logger_burst) oder MQTT (<basis>/cmd/burst)
+  uint16_t log_burst_sec        = 0;
+  uint16_t log_burst_slope      = 100;
+  uint8_t  log_burst_every_h    = 0;
+
   // NTP
   String ntp_server = "pool.ntp.org";
   bool tz_auto_berlin = true;
@@ -1,42 +1,35 @@
 #include <Arduino.h>
 #include <WebServer.h>
-#include <ArduinoJson.h>
 #include <SD.h>
 #include <time.h>
 #include "logger.h"
+#include "log_format.h"
+#include "log_index.h"
+#include "log_rollup.h"
+#include "sample_ring.h"
+#include "log_csv.h"
+#include "log_gorilla.h"
+#include "log_catalog.h"
+#include "log_archive.h"
+#include "log_flash.h"
+#include "log_burst.h"
+#include "log_interp.h"
 
 #include "settings_config/settings_common.h"
 
 // CSV Spaltennamen aus Logger
 static const char* COL_EPOCH = "epoch";
-static const char* COL_TEMP  = "temp_c";
-static const char* COL_HUM   = "hum_rh";
-static const char* COL_PRESS = "press_hpa";
-static const char* COL_CO2   = "co2_ppm";
-
-static const char* metricToCol(const String& metricKey);
-static bool parseFloatField(const String& f, float& out);
-static void splitCsv(const String& s, String out[], int maxParts, int& n);
-static int  findColIndex(const String cols[], int n, const char* name);
-static bool looksLikeHeader(const String& line);
-static int  metricToIndexNoHeader(const String& metricKey);
-
 
+// fehlerhafte Zahlenfelder der laufenden Abfrage (werden übersprungen, nicht als 0 gewertet)
+static uint32_t g_badFields = 0;
+// Records mit falscher Prüfsumme (angerissen/beschädigt, werden übersprungen)
+static uint32_t g_badRecords = 0;
 
 static bool timeIsValid() {
   time_t now = time(nullptr);
   return (now > 1672531200);
 }
 
-static time_t localMidnight(time_t t) {
-  struct tm tmLocal{};
-  localtime_r(&t, &tmLocal);
-  tmLocal.tm_hour = 0;
-  tmLocal.tm_min  = 0;
-  tmLocal.tm_sec  = 0;
-  return mktime(&tmLocal); // lokale Mitternacht
-}
-
 static time_t startOfTodayLocal() {
   time_t now = time(nullptr);
   struct tm t{};
@@ -45,289 +38,1266 @@ static time_t startOfTodayLocal() {
   return mktime(&t); // local 00:00
 }
 
-static bool looksLikeHeader(const String& line){
-  return line.startsWith("epoch");
-}
+// ============================================================================
+// Chunked Ausgabe: fester kleiner Puffer statt JSON-Dokument + String-Kopie
+// ============================================================================
+class ChunkWriter {
+public:
+  explicit ChunkWriter(WebServer& server) : _server(server) {}
 
-// wenn KEIN Header: feste Spaltenpositionen
-static int metricToIndexNoHeader(const String& metricKey){
-  // 0=epoch, 1=temp, 2=hum, 3=press, 4=co2
-  if (metricKey == "temp")  return 1;
-  if (metricKey == "hum")   return 2;
-  if (metricKey == "press") return 3;
-  if (metricKey == "co2")   return 4;
-  return -1;
-}
+  void begin(const char* contentType) {
+    _heapStart = ESP.getFreeHeap();
+    _heapMin = _heapStart;
+    _server.setContentLength(CONTENT_LENGTH_UNKNOWN);
+    _server.send(200, contentType, "");
+  }
 
-static String dayStringLocalFromEpoch(time_t t) {
-  struct tm tmLocal{};
-  localtime_r(&t, &tmLocal);
-  char buf[16];
-  snprintf(buf, sizeof(buf), "%04d-%02d-%02d",
-           tmLocal.tm_year + 1900, tmLocal.tm_mon + 1, tmLocal.tm_mday);
-  return String(buf);
-}
+  void write(const char* p, size_t n) {
+    while (n) {
+      size_t k = sizeof(_buf) - _len;
+      if (k > n) k = n;
+      memcpy(_buf + _len, p, k);
+      _len += k; p += k; n -= k;
+      if (_len == sizeof(_buf)) flush();
+    }
+  }
+
+  void print(const char* s) { write(s, strlen(s)); }
+
+  void printU32(uint32_t v) {
+    char b[12];
+    write(b, (size_t)snprintf(b, sizeof(b), "%lu", (unsigned long)v));
+  }
+
+  void printFloat(float v) {
+    if (!isfinite(v)) { print("null"); return; }   // JSON kennt weder NaN noch inf
+    char b[48];                                       // "%.2f" von ±FLT_MAX: 43 Zeichen
+    write(b, (size_t)snprintf(b, sizeof(b), "%.2f", (double)v));
+  }
+
+  void end() {
+    flush();
+    _server.sendContent("");
+  }
+
+  uint32_t bytes()     const { return _bytes; }
+  uint32_t heapStart() const { return _heapStart; }
+  uint32_t heapMin()   const { return _heapMin; }
+
+private:
+  void flush() {
+    if (!_len) return;
+    _server.sendContent(_buf, _len);
+    _bytes += _len;
+    _len = 0;
+    const uint32_t h = ESP.getFreeHeap();
+    if (h < _heapMin) _heapMin = h;
+  }
+
+  WebServer& _server;
+  char       _buf[512];
+  size_t     _len = 0;
+  uint32_t   _bytes = 0;
+  uint32_t   _heapStart = 0;
+  uint32_t   _heapMin = 0;
+};
+
+// ============================================================================
+// Abfrage + Zeilenausgabe
+// ============================================================================
+struct HistQuery {
+  uint32_t tMin = 0;
+  uint32_t tMax = 0xFFFFFFFFu;
+  int      metricCount = 0;
+  int      midx[LOG_METRIC_COUNT];   // Index in LOG_METRICS je ausgewählter Metrik
+  bool     envelope = false;         // envelope=1: je Metrik Min und Max statt eines Werts
+
+  // Werte je Ausgabezeile (Hüllkurve: min,max je Metrik nebeneinander)
+  int cols() const { return envelope ? 2 * metricCount : metricCount; }
+};
+
+static constexpr int HIST_MAX_COLS = 2 * LOG_METRIC_COUNT;
+static constexpr uint32_t HIST_MAX_DAYS = LOG_CATALOG_MAX;   // from=/to=: längstes Fenster (Tage)
+
+// Empfänger der Zeilen (JSON-Ausgabe oder Downsampler davor)
+class HistSink {
+public:
+  virtual ~HistSink() {}
+  // vals: ein Wert je ausgewählter Metrik (NAN = kein Wert); zur Ausgabe hin q.cols() Werte
+  virtual void row(uint32_t ep, const float* vals) = 0;
+};
+
+// {"mode":"line","cols":["temp",...],"rows":[[epoch,v,...],...],"stats":{...}}
+// envelope=1: "cols":["temp_min","temp_max",...], je Zeile min,max je Metrik
+class HistJsonOut : public HistSink {
+public:
+  HistJsonOut(ChunkWriter& w, const HistQuery& q) : _w(w), _q(q) {}
+
+  void begin(const char* mode, bool daily) {
+    _w.print("{\"mode\":\"");
+    _w.print(mode);
+    _w.print("\",\"daily\":");
+    _w.print(daily ? "true" : "false");
+    _w.print(",\"cols\":[");
+    for (int i=0;i<_q.cols();i++) {
+      if (i) _w.print(",");
+      _w.print("\"");
+      _w.print(LOG_METRICS[_q.midx[_q.envelope ? i / 2 : i]].key);
+      if (_q.envelope) _w.print((i & 1) ? "_max" : "_min");
+      _w.print("\"");
+    }
+    _w.print("],\"rows\":[");
+  }
+
+  void row(uint32_t ep, const float* vals) override {
+    _w.print(_rows ? ",[" : "[");
+    _w.printU32(ep);
+    for (int i=0;i<_q.cols();i++) {
+      _w.print(",");
+      _w.printFloat(vals[i]);
+    }
+    _w.print("]");
+    _rows++;
+  }
+
+  // Zeilen abschließen (danach dürfen weitere Felder wie "captures" folgen)
+  void closeRows() {
+    if (_closed) return;
+    _w.print("]");
+    _closed = true;
+  }
+
+  void end() {
+    closeRows();
+    _w.print(",\"stats\":{\"rows\":");
+    _w.printU32(_rows);
+    _w.print(",\"heap_start\":");
+    _w.printU32(_w.heapStart());
+    _w.print(",\"heap_min\":");
+    _w.printU32(_w.heapMin());
+    _w.print(",\"bad_fields\":");
+    _w.printU32(g_badFields);
+    _w.print(",\"bad_records\":");
+    _w.printU32(g_badRecords);
+    _w.print("}}");
+  }
+
+  uint32_t rows() const { return _rows; }
+
+private:
+  ChunkWriter&     _w;
+  const HistQuery& _q;
+  uint32_t         _rows = 0;
+  bool             _closed = false;
+};
+
+// captures=1: eine Burst-Aufzeichnung (log_burst.h) als
+// {"start":epoch,"trigger":epoch,"reason":"slope","rows":[[epoch,v,...],...]};
+// der Kopf wird erst mit der ersten Zeile im Fenster geschrieben
+class HistCaptureOut : public HistSink {
+public:
+  HistCaptureOut(ChunkWriter& w, const HistQuery& q) : _w(w), _q(q) {}
+
+  void open(uint32_t start, uint32_t trigger, uint8_t reason) {
+    _start = start;
+    _trigger = trigger;
+    _reason = reason;
+    _rows = 0;
+  }
+
+  void row(uint32_t ep, const float* vals) override {
+    if (!_rows) {
+      _w.print(_captures ? ",{\"start\":" : "{\"start\":");
+      _w.printU32(_start);
+      _w.print(",\"trigger\":");
+      _w.printU32(_trigger);
+      _w.print(",\"reason\":\"");
+      _w.print(logBurstReasonName(_reason));
+      _w.print("\",\"rows\":[");
+      _captures++;
+    }
+    _w.print(_rows ? ",[" : "[");
+    _w.printU32(ep);
+    for (int i=0;i<_q.cols();i++) {
+      _w.print(",");
+      _w.printFloat(vals[i]);
+    }
+    _w.print("]");
+    _rows++;
+  }
+
+  void close() {
+    if (_rows) _w.print("]}");
+  }
+
+private:
+  ChunkWriter&     _w;
+  const HistQuery& _q;
+  uint32_t         _start = 0, _trigger = 0;
+  uint8_t          _reason = LOG_BURST_NONE;
+  uint32_t         _rows = 0;
+  uint32_t         _captures = 0;
+};
+
+// format=bin: 8 Byte Kopf + Records {uint32 epoch, float32 je Metrik}, little-endian, NAN = kein Wert.
+// Kopf: version, flags (bit0 = daily, bit1 = bar, bit2 = Hüllkurve), Anzahl Metriken, 0, Index in LOG_METRICS
+// je Metrik (0xFF = frei). Hüllkurve: je Metrik zwei Floats (min, max) im Record.
+// Zeilen statt Spalten-Arrays, weil die Zeilenzahl beim Streamen vorher nicht feststeht.
+static constexpr uint8_t HIST_BIN_VERSION = 1;
+
+class HistBinOut : public HistSink {
+public:
+  HistBinOut(ChunkWriter& w, const HistQuery& q) : _w(w), _q(q) {}
+
+  void begin(const char* mode, bool daily) {
+    uint8_t h[8] = { HIST_BIN_VERSION, 0, (uint8_t)_q.metricCount, 0, 0xFF, 0xFF, 0xFF, 0xFF };
+    if (daily) h[1] |= 0x01;
+    if (strcmp(mode, "bar") == 0) h[1] |= 0x02;
+    if (_q.envelope) h[1] |= 0x04;
+    for (int i=0;i<_q.metricCount;i++) h[4 + i] = (uint8_t)_q.midx[i];
+    _w.write((const char*)h, sizeof(h));
+  }
+
+  void row(uint32_t ep, const float* vals) override {
+    // ESP32 ist little-endian -> Werte direkt kopieren
+    char rec[4 + 4 * HIST_MAX_COLS];
+    memcpy(rec, &ep, 4);
+    memcpy(rec + 4, vals, 4 * _q.cols());
+    _w.write(rec, 4 + 4 * _q.cols());
+    _rows++;
+  }
+
+  void end() {}
+
+  uint32_t rows() const { return _rows; }
+
+private:
+  ChunkWriter&     _w;
+  const HistQuery& _q;
+  uint32_t         _rows = 0;
+};
+
+// Min/Max je Zeit-Bucket (points=N): ein Durchlauf, fester Zustand je Metrik.
+// Pro Bucket höchstens zwei Zeilen (erste/letzte Zeit im Bucket); je Metrik landet
+// das früher aufgetretene Extrem in der ersten, das andere in der zweiten Zeile.
+// Hüllkurve: eine Zeile je Bucket mit dem kleinsten Min und größten Max.
+class HistDownsampler : public HistSink {
+public:
+  HistDownsampler(HistSink& next, const HistQuery& q, uint32_t tFrom, uint32_t tTo, uint16_t points)
+    : _next(next), _q(q), _tFrom(tFrom) {
+    const uint32_t buckets = (points < 2) ? 1 : points / 2;
+    const uint32_t span = (tTo > tFrom) ? (tTo - tFrom) : 1;
+    _width = (span + buckets - 1) / buckets;
+    if (_width == 0) _width = 1;
+  }
+
+  void row(uint32_t ep, const float* vals) override {
+    const uint32_t b = (ep > _tFrom) ? (ep - _tFrom) / _width : 0;
+    if (_n && b != _bucket) flush();
+    if (!_n) { _bucket = b; _e0 = ep; }
+    _e1 = ep;
+    _n++;
+
+    for (int i=0;i<_q.metricCount;i++) {
+      const float lo = _q.envelope ? vals[2 * i] : vals[i];
+      const float hi = _q.envelope ? vals[2 * i + 1] : vals[i];
+      if (!isnan(lo) && (isnan(_min[i]) || lo < _min[i])) { _min[i] = lo; _minEp[i] = ep; }
+      if (!isnan(hi) && (isnan(_max[i]) || hi > _max[i])) { _max[i] = hi; _maxEp[i] = ep; }
+    }
+  }
+
+  void flush() {
+    if (!_n) return;
+    if (_q.envelope) {
+      float e[HIST_MAX_COLS];
+      for (int i=0;i<_q.metricCount;i++) {
+        e[2 * i] = _min[i];
+        e[2 * i + 1] = _max[i];
+        _min[i] = NAN; _max[i] = NAN;
+      }
+      _next.row(_e0, e);
+      _n = 0;
+      return;
+    }
+    float a[LOG_METRIC_COUNT], b[LOG_METRIC_COUNT];
+    for (int i=0;i<_q.metricCount;i++) {
+      const bool minFirst = _minEp[i] <= _maxEp[i];
+      a[i] = minFirst ? _min[i] : _max[i];
+      b[i] = minFirst ? _max[i] : _min[i];
+      _min[i] = NAN; _max[i] = NAN;
+    }
+    _next.row(_e0, a);
+    if (_n > 1) _next.row(_e1, b);
+    _n = 0;
+  }
+
+private:
+  HistSink&        _next;
+  const HistQuery& _q;
+  uint32_t         _tFrom;
+  uint32_t         _width = 1;
+  uint32_t         _bucket = 0;
+  uint32_t         _n = 0;
+  uint32_t         _e0 = 0, _e1 = 0;
+  float            _min[LOG_METRIC_COUNT] = { NAN, NAN, NAN, NAN };
+  float            _max[LOG_METRIC_COUNT] = { NAN, NAN, NAN, NAN };
+  uint32_t         _minEp[LOG_METRIC_COUNT] = {};
+  uint32_t         _maxEp[LOG_METRIC_COUNT] = {};
+};
 
-static String monthStringLocalFromEpoch(time_t t) {
-  struct tm tmLocal{};
-  localtime_r(&t, &tmLocal);
-  char buf[8];
-  snprintf(buf, sizeof(buf), "%04d-%02d", tmLocal.tm_year + 1900, tmLocal.tm_mon + 1);
-  return String(buf);
+// Hüllkurve aus einer Quelle ohne Min/Max (Ringpuffer, Flash, Archiv, Tage ohne .env): min = max = Wert
+class HistEnvPoint : public HistSink {
+public:
+  HistEnvPoint(HistSink& next, const HistQuery& q) : _next(next), _q(q) {}
+
+  void row(uint32_t ep, const float* vals) override {
+    float e[HIST_MAX_COLS];
+    for (int i=0;i<_q.metricCount;i++) e[2 * i] = e[2 * i + 1] = vals[i];
+    _next.row(ep, e);
+  }
+
+private:
+  HistSink&        _next;
+  const HistQuery& _q;
+};
+
+// .env-Records paarweise (erst Min, dann Max mit derselben epoch) -> eine Hüllkurven-Zeile
+class HistEnvPair : public HistSink {
+public:
+  HistEnvPair(HistSink& next, const HistQuery& q) : _next(next), _q(q) {}
+
+  void row(uint32_t ep, const float* vals) override {
+    if (!_have || ep != _ep) {
+      // erster des Paars (ein einzelner Vorgänger war angerissen und fällt weg)
+      memcpy(_min, vals, sizeof(float) * _q.metricCount);
+      _ep = ep;
+      _have = true;
+      return;
+    }
+    float e[HIST_MAX_COLS];
+    for (int i=0;i<_q.metricCount;i++) {
+      e[2 * i] = _min[i];
+      e[2 * i + 1] = vals[i];
+    }
+    _next.row(ep, e);
+    _have = false;
+  }
+
+private:
+  HistSink&        _next;
+  const HistQuery& _q;
+  float            _min[LOG_METRIC_COUNT];
+  uint32_t         _ep = 0;
+  bool             _have = false;
+};
+
+// Metriken mit eigenem Intervall (log_every_*) stehen nur in jeder n-ten Zeile, dazwischen NAN:
+// Zeilen ohne einen der abgefragten Werte fallen weg (metrics=press -> nur die Druck-Zeilen;
+// mit interp=1 nur noch Zeilen vor dem ersten bzw. nach dem letzten Wert)
+class HistSkipEmpty : public HistSink {
+public:
+  HistSkipEmpty(HistSink& next, const HistQuery& q) : _next(next), _q(q) {}
+
+  void row(uint32_t ep, const float* vals) override {
+    for (int i=0;i<_q.cols();i++) {
+      if (!isnan(vals[i])) { _next.row(ep, vals); return; }
+    }
+    _skipped++;
+  }
+
+  uint32_t skipped() const { return _skipped; }
+
+private:
+  HistSink&        _next;
+  const HistQuery& _q;
+  uint32_t         _skipped = 0;
+};
+
+// interp=1: leere Zellen zwischen zwei gespeicherten Werten einer Metrik linear auffüllen
+// (log_interp.h). Steht vor HistSkipEmpty, damit auch Abfragen einzelner Metriken jede Zeile bekommen.
+// Ring statisch (~2 KB), der Handler läuft nur im Webserver-Task.
+static LogInterp g_interp;
+
+class HistInterp : public HistSink {
+public:
+  HistInterp(HistSink& next, const HistQuery& q, bool on) : _next(next), _on(on) {
+    if (_on) g_interp.begin((uint8_t)q.cols());
+  }
+
+  void row(uint32_t ep, const float* vals) override {
+    if (!_on) { _next.row(ep, vals); return; }
+    g_interp.push(ep, vals);
+    drain();
+  }
+
+  void finish() {
+    if (!_on) return;
+    g_interp.finish();
+    drain();
+  }
+
+private:
+  void drain() {
+    uint32_t ep;
+    float v[LOG_INTERP_COLS];
+    while (g_interp.pop(ep, v)) _next.row(ep, v);
+  }
+
+  HistSink& _next;
+  bool      _on;
+};
+
+// ===== Binärdaten ab base (Datei: 0, Archiv: Offset des Tages), len Bytes:
+// Startrecord per binärer Suche, dann blockweise lesen =====
+static bool readBinRecords(File& f, uint32_t base, uint32_t len, const HistQuery& q, HistSink& out) {
+  LogBinHeader h;
+  if (!logBinReadHeader(f, h, base)) return false;
+
+  const uint32_t count = logBinRecordCount(f, h, base, len);
+  uint32_t r = logBinLowerBound(f, h, count, q.tMin, base);
+  f.seek(base + h.header_size + (size_t)r * h.rec_size);
+
+  uint8_t buf[32 * LOG_BIN_MAX_REC];
+  const uint32_t perChunk = sizeof(buf) / h.rec_size;
+  float vals[LOG_METRIC_COUNT];
+
+  while (r < count) {
+    const uint32_t n = (count - r < perChunk) ? (count - r) : perChunk;
+    if (f.read(buf, n * h.rec_size) != n * h.rec_size) break;
+
+    for (uint32_t k=0;k<n;k++) {
+      const uint8_t* rec = buf + k * h.rec_size;
+      if (!logBinRecordOk(h, rec)) { g_badRecords++; continue; }
+      LogSample s;
+      logBinDecode(h, rec, s);
+      if (s.epoch > q.tMax) return true;
+
+      for (int i=0;i<q.metricCount;i++) vals[i] = s.v[q.midx[i]];
+      out.row(s.epoch, vals);
+    }
+    r += n;
+  }
+  return true;
 }
 
-static String logPathForDay(const String& day) {
-  return String("/log/") + day + ".csv";
+static bool readBinDay(const String& day, const HistQuery& q, HistSink& out, const char* ext = ".bin") {
+  const String p = logPathForDay(day, ext);
+  if (!SD.exists(p)) return false;
+  File f = SD.open(p, FILE_READ);
+  if (!f) return false;
+
+  const bool ok = readBinRecords(f, 0, (uint32_t)f.size(), q, out);
+  f.close();
+  return ok;
 }
 
-static void splitCsv(const String& s, String out[], int maxParts, int& n) {
-  n = 0;
-  int start = 0;
-  while (n < maxParts) {
-    int comma = s.indexOf(',', start);
-    if (comma < 0) {
-      out[n] = s.substring(start);
-      out[n].trim();
-      n++;
-      break;
-    }
-    out[n] = s.substring(start, comma);
-    out[n].trim();
-    n++;
-    start = comma + 1;
+// ===== komprimierte Blöcke ab base: blockweise, Blöcke außerhalb des Fensters nur per Header übersprungen =====
+static void readGorBlocks(File& f, uint32_t base, uint32_t blocks, const HistQuery& q, HistSink& out) {
+  uint8_t blk[LOG_GOR_BLOCK_SIZE];
+  float vals[LOG_METRIC_COUNT];
+  LogGorDecoder dec;
+
+  for (uint32_t b=0;b<blocks;b++) {
+    LogGorBlockHeader h;
+    f.seek(base + (size_t)b * LOG_GOR_BLOCK_SIZE);
+    if (f.read((uint8_t*)&h, sizeof(h)) != sizeof(h)) break;
+    if (h.magic != LOG_GOR_MAGIC || !h.count) continue;
+    if (h.last_epoch < q.tMin) continue;
+    if (h.first_epoch > q.tMax) break;
+
+    memcpy(blk, &h, sizeof(h));
+    const size_t rest = sizeof(blk) - sizeof(h);
+    if (f.read(blk + sizeof(h), rest) != rest || !dec.begin(blk)) break;
+
+    LogSample s;
+    while (dec.next(s)) {
+      if (s.epoch < q.tMin) continue;
+      if (s.epoch > q.tMax) return;
+      for (int i=0;i<q.metricCount;i++) vals[i] = s.v[q.midx[i]];
+      out.row(s.epoch, vals);
+    }
   }
 }
 
-static int findColIndex(const String cols[], int n, const char* name) {
-  for (int i=0;i<n;i++) if (cols[i] == name) return i;
-  return -1;
+static bool readGorDay(const String& day, const HistQuery& q, HistSink& out) {
+  const String p = logPathForDay(day, ".gor");
+  if (!SD.exists(p)) return false;
+  File f = SD.open(p, FILE_READ);
+  if (!f) return false;
+
+  readGorBlocks(f, 0, logGorBlockCount(f), q, out);
+  f.close();
+  return true;
 }
 
-static bool parseFloatField(const String& f, float& out) {
-  if (f.length() == 0) return false;
+// ===== Monatsarchiv: Tag über das Inhaltsverzeichnis, dann wie .bin/.gor ab seinem Offset =====
+static bool dayIsArchived(const String& day) {
+  LogCatalogDay cd;
+  // ohne Katalog im Archiv nachsehen
+  return !logCatalogReady() || (logCatalogGet(day, cd) && (cd.formats & LOG_CATALOG_ARC));
+}
 
-  // toFloat() gibt 0 zurück auch bei Müll → wir lassen 0 aber zu.
-  // Für bessere Validierung könnte man isDigit/strtod nutzen, aber reicht hier.
-  out = f.toFloat();
+static bool readArcDay(const String& day, const HistQuery& q, HistSink& out) {
+  if (!dayIsArchived(day)) return false;
+  LogArcDay e;
+  File f = logArchiveOpenDay(day, e);
+  if (!f) return false;
+
+  if (e.kind == LOG_ARC_BIN) readBinRecords(f, e.offset, e.length, q, out);
+  else readGorBlocks(f, e.offset, e.length / LOG_GOR_BLOCK_SIZE, q, out);
+  f.close();
   return true;
 }
 
-static void calcDailyAvg(const String& path, const String& metricKey,
-                         double& sum, uint32_t& cnt) {
-  if (!SD.exists(path)) return;
+// ===== CSV-Datei (header oder no-header) =====
+static void readCsvDay(const String& day, const HistQuery& q, HistSink& out) {
+  const String p = logPathForDay(day);
+  if (!SD.exists(p)) return;
 
-  File f = SD.open(path, FILE_READ);
+  // Startoffset aus dem .idx (fehlend/veraltet -> wird hier neu aufgebaut)
+  logIndexEnsure(day);
+  const uint32_t startOff = logIndexSeekOffset(day, q.tMin);
+
+  File f = SD.open(p, FILE_READ);
   if (!f) return;
 
-  String first = f.readStringUntil('\n');
-  first.trim();
-  if (!first.length()) { f.close(); return; }
+  LogCsvReader rd(f);
+  if (!rd.next()) { f.close(); return; }
 
-  const int MAXC=16;
-  String cols[MAXC]; int n=0;
-  String parts[MAXC]; int pn=0;
+  int idxEpoch = 0;
+  int idx[LOG_METRIC_COUNT];
+  float vals[LOG_METRIC_COUNT];
 
-  bool hasHeader = looksLikeHeader(first);
+  auto emit = [&]()->bool {
+    uint32_t ep = 0;
+    if (logCsvParseU32(rd.field((uint8_t)idxEpoch), ep) != LOG_CSV_OK) { g_badFields++; return true; }
+    if (ep < q.tMin) return true;
+    if (ep > q.tMax) return false;
 
-  int idxEpoch = 0;
-  int idxVal   = -1;
-
-  if (hasHeader) {
-    splitCsv(first, cols, MAXC, n);
-    idxEpoch = findColIndex(cols, n, COL_EPOCH);
-    const char* col = metricToCol(metricKey);
-    idxVal = col ? findColIndex(cols, n, col) : -1;
-    if (idxEpoch < 0 || idxVal < 0) { f.close(); return; }
+    for (int i=0;i<q.metricCount;i++) {
+      vals[i] = NAN;
+      if (idx[i] < 0) continue;
+      float v;
+      const LogCsvField r = logCsvParseFloat(rd.field((uint8_t)idx[i]), v);
+      if (r == LOG_CSV_OK) vals[i] = v;
+      else if (r == LOG_CSV_BAD) g_badFields++;
+    }
+    out.row(ep, vals);
+    return true;
+  };
+
+  if (strncmp(rd.field(0), COL_EPOCH, strlen(COL_EPOCH)) == 0) {
+    idxEpoch = rd.find(COL_EPOCH);
+    if (idxEpoch < 0) { f.close(); return; }
+
+    for (int i=0;i<q.metricCount;i++) idx[i] = rd.find(LOG_METRICS[q.midx[i]].col);
+    rd.setCrc(rd.find(LOG_CSV_COL_CRC) >= 0);
   } else {
+    // kein header → feste positionen (0=epoch, dann LOG_METRICS-Reihenfolge)
     idxEpoch = 0;
-    idxVal = metricToIndexNoHeader(metricKey);
-    // first ist Datenzeile
-    splitCsv(first, parts, MAXC, pn);
-    if (pn > idxVal) {
-      float v;
-      if (parseFloatField(parts[idxVal], v) && !isnan(v)) { sum += v; cnt++; }
+    for (int i=0;i<q.metricCount;i++) idx[i] = q.midx[i] + 1;
+
+    // erste Zeile ist daten → mitverarbeiten
+    if (!emit()) { f.close(); return; }
+  }
+
+  // direkt zur ersten relevanten Zeile springen (Header ist bereits gelesen)
+  if (startOff > rd.offset()) rd.seek(startOff);
+
+  while (rd.next()) {
+    if (!emit()) break;
+  }
+  g_badRecords += rd.crcErrors();
+
+  f.close();
+}
+
+// laut Katalog keine Daten im Fenster -> Tag ohne SD-Zugriff überspringen
+static bool catalogSkipsDay(const String& day, const HistQuery& q) {
+  if (!logCatalogReady()) return false;
+  LogCatalogDay cd;
+  if (logCatalogGet(day, cd)) return cd.last < q.tMin || cd.first > q.tMax;
+  if (logCatalogComplete()) return true;
+  // unvollständiger Katalog: nur Tage vor dem ältesten Eintrag können fehlen
+  LogCatalogDay oldest;
+  return logCatalogOldest(oldest) && logCatalogKey(day) > oldest.day;
+}
+
+// erster Zeitpunkt der Hüllkurve eines Tages (false = keine .env bzw. leer)
+static bool envFirstEpoch(const String& day, uint32_t& first) {
+  const String p = logPathForDay(day, LOG_ENV_EXT);
+  if (!SD.exists(p)) return false;
+  File f = SD.open(p, FILE_READ);
+  if (!f) return false;
+  LogBinHeader h;
+  uint8_t rec[LOG_BIN_MAX_REC];
+  bool ok = logBinReadHeader(f, h) && logBinRecordCount(f, h) > 0;
+  if (ok) {
+    f.seek(h.header_size);
+    ok = f.read(rec, h.rec_size) == h.rec_size && logBinRecordOk(h, rec);
+  }
+  f.close();
+  if (!ok) return false;
+  LogSample s;
+  logBinDecode(h, rec, s);
+  first = s.epoch;
+  return true;
+}
+
+// Werte eines Tages: archivierte Tage direkt aus dem Monatsarchiv; sonst Binärdatei bevorzugen
+// (kein Text-Parsing), dann komprimiert, sonst CSV; alle hören bei q.tMax auf
+static void readDay(const String& day, const HistQuery& q, HistSink& out) {
+  if (readArcDay(day, q, out)) return;
+  if (!readBinDay(day, q, out) && !readGorDay(day, q, out)) readCsvDay(day, q, out);
+}
+
+// ===== beliebiges Zeitfenster: Tagesdateien der Reihe nach, konstanter Speicher =====
+static void readRange(uint32_t tFrom, uint32_t tTo, const HistQuery& q, HistSink& out) {
+  const time_t t0 = (time_t)tFrom;
+  struct tm td{};
+  localtime_r(&t0, &td);
+  const String lastDay = logDayStringFromEpoch((time_t)tTo);
+
+  while (true) {
+    // 12:00 des Tages -> robust gegen Sommerzeitwechsel
+    td.tm_hour = 12; td.tm_min = 0; td.tm_sec = 0;
+    td.tm_isdst = -1;
+    const String day = logDayStringFromEpoch(mktime(&td));
+    if (day > lastDay) break;
+
+    td.tm_mday++;
+    if (catalogSkipsDay(day, q)) continue;
+
+    // Hüllkurve aus der .env des Tages; fehlt sie, die Werte selbst als min = max
+    HistEnvPair pair(out, q);
+    HistEnvPoint point(out, q);
+    uint32_t envFrom = 0;
+    if (q.envelope && envFirstEpoch(day, envFrom)) {
+      // Hüllkurve erst im Lauf des Tages eingeschaltet: davor die Werte selbst
+      HistQuery env = q;
+      if (envFrom > q.tMin) {
+        HistQuery pre = q;
+        if (envFrom - 1 < pre.tMax) pre.tMax = envFrom - 1;
+        readDay(day, pre, point);
+        env.tMin = envFrom;
+      }
+      if (env.tMin <= env.tMax && !readBinDay(day, env, pair, LOG_ENV_EXT)) readDay(day, env, point);
+      continue;
     }
+    readDay(day, q, q.envelope ? (HistSink&)point : out);
+  }
+}
+
+// ===== ohne SD: Segmente des Flash-Rings, nur die mit Daten im Fenster =====
+static void readFlash(const HistQuery& q, HistSink& out) {
+  const uint8_t n = logFlashSegmentCount();
+  for (uint8_t i=0;i<n;i++) {
+    LogFlashSeg s;
+    if (!logFlashSegmentAt(i, s) || !s.records || s.last < q.tMin || s.first > q.tMax) continue;
+    File f = logFlashOpen(s);
+    if (!f) continue;
+    readBinRecords(f, 0, (uint32_t)f.size(), q, out);
+    f.close();
   }
+}
 
-  while (f.available()) {
-    String line = f.readStringUntil('\n');
-    line.trim();
-    if (!line.length()) continue;
+// Metriken der Flash-Segmente im Fenster (0 = keine Daten)
+static uint32_t flashMask(const HistQuery& q) {
+  uint32_t mask = 0;
+  const uint8_t n = logFlashSegmentCount();
+  for (uint8_t i=0;i<n;i++) {
+    LogFlashSeg s;
+    if (logFlashSegmentAt(i, s) && s.records && s.last >= q.tMin && s.first <= q.tMax) mask |= s.mask;
+  }
+  return mask;
+}
 
-    splitCsv(line, parts, MAXC, pn);
-    if (pn <= idxVal) continue;
+// Rohdaten eines Fensters: Tagesdateien auf der SD, ohne SD der Flash-Ring
+static void readStored(const HistQuery& q, HistSink& out, bool flash) {
+  HistEnvPoint point(out, q);   // Flash-Ring hat keine Hüllkurve
+  if (flash) readFlash(q, q.envelope ? (HistSink&)point : out);
+  else readRange(q.tMin, q.tMax, q, out);
+}
 
-    float v;
-    if (parseFloatField(parts[idxVal], v) && !isnan(v)) { sum += v; cnt++; }
+// ===== noch nicht geschriebene Zeilen des Loggers (Kompression, Schreibpuffer), nur unter der SD-Sperre =====
+// schließen an die Tagesdateien an: älter als alles im Puffer ist schon auf der Karte
+static void readPending(const HistQuery& q, HistSink& out) {
+  float vals[HIST_MAX_COLS];
+  const uint16_t n = loggerPendingCount();
+  for (uint16_t i=0;i<n;i++) {
+    LogSample s, mn, mx;
+    if (!loggerPendingGet(i, s, q.envelope ? &mn : nullptr, q.envelope ? &mx : nullptr)) continue;
+    if (s.epoch < q.tMin) continue;
+    if (s.epoch > q.tMax) break;
+    for (int k=0;k<q.metricCount;k++) {
+      const int m = q.midx[k];
+      if (q.envelope) { vals[2 * k] = mn.v[m]; vals[2 * k + 1] = mx.v[m]; }
+      else vals[k] = s.v[m];
+    }
+    out.row(s.epoch, vals);
   }
+}
 
-  f.close();
+static bool hasPending(const HistQuery& q) {
+  LogSample s;
+  const uint16_t n = loggerPendingCount();
+  for (uint16_t i=0;i<n;i++) if (loggerPendingGet(i, s) && s.epoch >= q.tMin && s.epoch <= q.tMax) return true;
+  return false;
 }
 
-static const char* metricToCol(const String& metricKey) {
-  if (metricKey == "temp")  return COL_TEMP;
-  if (metricKey == "hum")   return COL_HUM;
-  if (metricKey == "press") return COL_PRESS;
-  if (metricKey == "co2")   return COL_CO2;
-  return nullptr;
+// ===== 1h / live: Ringpuffer im RAM (10 s Raster), kein SD-Zugriff =====
+static void readRing(const HistQuery& q, HistSink& sink) {
+  HistEnvPoint point(sink, q);
+  HistSink& out = q.envelope ? (HistSink&)point : sink;
+  float vals[LOG_METRIC_COUNT];
+  const uint16_t n = sampleRingCount();
+  for (uint16_t i=0;i<n;i++) {
+    LogSample s;
+    if (!sampleRingGet(i, s)) break;
+    if (s.epoch < q.tMin) continue;
+    if (s.epoch > q.tMax) break;
+    for (int k=0;k<q.metricCount;k++) vals[k] = s.v[q.midx[k]];
+    out.row(s.epoch, vals);
+  }
+}
+
+// ===== Burst-Aufzeichnungen im Fenster, nach Startzeit =====
+static void writeCaptures(ChunkWriter& w, const HistQuery& q, uint16_t points) {
+  w.print(",\"captures\":[");
+  uint32_t starts[LOG_BURST_MAX_FILES];
+  uint8_t  reasons[LOG_BURST_MAX_FILES];
+  uint8_t n = 0;
+  File dir = SD.open(LOG_BURST_DIR);
+  if (dir) {
+    for (File f = dir.openNextFile(); f && n < LOG_BURST_MAX_FILES; f = dir.openNextFile()) {
+      const char* slash = strrchr(f.name(), '/');
+      uint32_t start;
+      uint8_t reason;
+      if (!f.isDirectory() && logBurstParseName(slash ? slash + 1 : f.name(), start, reason) &&
+          start <= q.tMax) {
+        // einsortieren
+        uint8_t k = n++;
+        for (; k > 0 && starts[k - 1] > start; k--) { starts[k] = starts[k - 1]; reasons[k] = reasons[k - 1]; }
+        starts[k] = start;
+        reasons[k] = reason;
+      }
+      f.close();
+    }
+    dir.close();
+  }
+
+  HistCaptureOut cap(w, q);
+  for (uint8_t i = 0; i < n; i++) {
+    char path[48];
+    snprintf(path, sizeof(path), "%s/%010lu-%s.bin", LOG_BURST_DIR, (unsigned long)starts[i],
+             logBurstReasonName(reasons[i]));
+    File f = SD.open(path, FILE_READ);
+    if (!f) continue;
+    LogBinHeader h;
+    if (logBinReadHeader(f, h, 0)) {
+      cap.open(starts[i], h.day_start, reasons[i]);
+      HistEnvPoint point(cap, q);
+      HistSink& capOut = q.envelope ? (HistSink&)point : cap;
+      HistDownsampler ds(capOut, q, q.tMin > starts[i] ? q.tMin : starts[i], q.tMax, points);
+      readBinRecords(f, 0, (uint32_t)f.size(), q, points ? (HistSink&)ds : capOut);
+      ds.flush();
+      cap.close();
+    }
+    f.close();
+  }
+  w.print("]");
+}
+
+static bool parseEpochArg(const String& s, uint32_t& out) {
+  if (!s.length() || s.length() > 10) return false;
+  for (size_t i=0;i<s.length();i++) if (!isDigit(s.charAt(i))) return false;
+  const unsigned long long v = strtoull(s.c_str(), nullptr, 10);   // 10 Stellen können über 32 bit gehen
+  if (v > 0xFFFFFFFFull) return false;
+  out = (uint32_t)v;
+  return true;
+}
+
+// Mittelwert/Min/Max je Metrik über alle Zeilen (Tageswerte aus dem Flash-Ring, dort gibt es keine Rollups)
+class HistMean : public HistSink {
+public:
+  explicit HistMean(const HistQuery& q) : _q(q) {}
+
+  void row(uint32_t, const float* vals) override {
+    for (int i=0;i<_q.metricCount;i++) {
+      const float v = vals[i];
+      if (isnan(v)) continue;
+      _sum[i] += v;
+      _n[i]++;
+      if (isnan(_min[i]) || v < _min[i]) _min[i] = v;
+      if (isnan(_max[i]) || v > _max[i]) _max[i] = v;
+    }
+  }
+
+  float mean(int i) const { return _n[i] ? (float)(_sum[i] / _n[i]) : NAN; }
+  float min(int i) const { return _min[i]; }
+  float max(int i) const { return _max[i]; }
+
+private:
+  const HistQuery& _q;
+  double   _sum[LOG_METRIC_COUNT] = {};
+  uint32_t _n[LOG_METRIC_COUNT] = {};
+  float    _min[LOG_METRIC_COUNT] = { NAN, NAN, NAN, NAN };
+  float    _max[LOG_METRIC_COUNT] = { NAN, NAN, NAN, NAN };
+};
+
+// ===== 7d / month: je Tag ein Wert aus den Rollup-Slots (kein Rohdaten-Scan), ohne SD aus dem Flash-Ring;
+// Hüllkurve: Tagesminimum/-maximum =====
+static void readDaily(time_t now, int nDays, const HistQuery& q, HistSink& out, bool flash) {
+  struct tm tn{};
+  localtime_r(&now, &tn);
+  float vals[HIST_MAX_COLS];
+
+  for (int k = nDays - 1; k >= 0; k--) {
+    // 12:00 des Tages -> robust gegen Sommerzeitwechsel
+    struct tm td = tn;
+    td.tm_mday -= k;
+    td.tm_hour = 12; td.tm_min = 0; td.tm_sec = 0;
+    td.tm_isdst = -1;
+    const time_t tDay = mktime(&td);
+
+    if (flash) {
+      HistQuery dq = q;
+      td.tm_hour = 0; td.tm_isdst = -1;
+      dq.tMin = (uint32_t)mktime(&td);
+      td.tm_mday++; td.tm_isdst = -1;
+      dq.tMax = (uint32_t)mktime(&td) - 1;
+      HistMean m(dq);
+      readFlash(dq, m);
+      for (int i=0;i<q.metricCount;i++) {
+        if (q.envelope) { vals[2 * i] = m.min(i); vals[2 * i + 1] = m.max(i); }
+        else vals[i] = m.mean(i);
+      }
+    } else {
+      LogRollupDay r;
+      const bool have = logRollupRead(logDayStringFromEpoch(tDay), r);
+      for (int i=0;i<q.metricCount;i++) {
+        const bool any = have && r.m[q.midx[i]].count > 0;
+        if (q.envelope) {
+          vals[2 * i] = any ? r.m[q.midx[i]].min : NAN;
+          vals[2 * i + 1] = any ? r.m[q.midx[i]].max : NAN;
+        } else {
+          vals[i] = have ? logRollupMean(r, q.midx[i]) : NAN;
+        }
+      }
+    }
+    out.row((uint32_t)tDay, vals);
+  }
 }
 
 void apiHistory(WebServer &server) {
   AppConfig* cfg = settingsRequireCfgAndAuth(server);
   if (!cfg) return;
 
-  if (!loggerSdOk()) {
-    server.send(503, "application/json", "{\"error\":\"sd_not_ready\"}");
-    return;
-  }
   if (!timeIsValid()) {
     server.send(409, "application/json", "{\"error\":\"time_not_set\"}");
     return;
   }
 
+  const uint32_t t0 = millis();
+  g_badFields = 0;
+  g_badRecords = 0;
+
   const String range = server.hasArg("range") ? server.arg("range") : "24h";
   const String chart = server.hasArg("chart") ? server.arg("chart") : "line";
   const String metricsArg = server.hasArg("metrics") ? server.arg("metrics") : "temp,hum,press,co2";
+  const String format = server.hasArg("format") ? server.arg("format") : "json";
+  if (format != "json" && format != "bin") {
+    server.send(400, "application/json", "{\"error\":\"bad_format\"}");
+    return;
+  }
+  const bool bin = (format == "bin");
+
+  // points=N: höchstens ~N Zeilen (0 = alle)
+  int points = server.hasArg("points") ? toIntSafe(server.arg("points"), 0) : 0;
+  if (points < 0) points = 0;
+  if (points > 0 && points < 16) points = 16;
+  if (points > 4000) points = 4000;
+
+  // envelope=1: Min/Max je Intervall (log_agg_mode = Mittel + Min/Max), sonst min = max = Wert
+  const bool envelope = server.hasArg("envelope") && toIntSafe(server.arg("envelope"), 0) != 0;
+
+  // interp=1: Lücken der Kompression / eigener Intervalle linear auffüllen (sonst nur gespeicherte Punkte)
+  const bool interp = server.hasArg("interp") && toIntSafe(server.arg("interp"), 0) != 0;
 
-  // metrics split
-  String metrics[8]; int mn=0;
+  // captures=1 (nur JSON): Burst-Aufzeichnungen im Fenster zusätzlich als "captures"
+  const bool captures = server.hasArg("captures") && toIntSafe(server.arg("captures"), 0) != 0;
+
+  // metrics split (nur bekannte, keine doppelten)
+  HistQuery q;
+  q.envelope = envelope;
   {
     int start=0;
-    while (mn < 8) {
+    while (q.metricCount < LOG_METRIC_COUNT) {
       int c = metricsArg.indexOf(',', start);
-      if (c < 0) { metrics[mn++] = metricsArg.substring(start); break; }
-      metrics[mn++] = metricsArg.substring(start, c);
+      String key = (c < 0) ? metricsArg.substring(start) : metricsArg.substring(start, c);
+      key.trim();
+
+      const int mi = logMetricIndexByKey(key);
+      bool dup = false;
+      for (int i=0;i<q.metricCount;i++) if (q.midx[i] == mi) dup = true;
+      if (mi >= 0 && !dup) q.midx[q.metricCount++] = mi;
+
+      if (c < 0) break;
       start = c+1;
     }
-    for (int i=0;i<mn;i++) metrics[i].trim();
   }
 
-  DynamicJsonDocument doc(18000);
-  doc["mode"] = (chart == "bar") ? "bar" : "line";
-  JsonArray labels = doc.createNestedArray("labels");
-  JsonObject series = doc.createNestedObject("series");
-
   time_t now = time(nullptr);
 
-  // ===== feste Zeitfenster (kein rolling über Tage) =====
   time_t tMin = 0;
+  time_t tMax = now;
+  int dailyDays = 0;
 
-  if (range == "1h") {
+  if (server.hasArg("from")) {
+    // ===== from=/to= (epoch), to fehlt -> jetzt =====
+    uint32_t from = 0, to = (uint32_t)now;
+    if (!parseEpochArg(server.arg("from"), from) ||
+        (server.hasArg("to") && !parseEpochArg(server.arg("to"), to)) || to < from) {
+      server.send(400, "application/json", "{\"error\":\"bad_from_to\"}");
+      return;
+    }
+    if (to > (uint32_t)now) to = from > (uint32_t)now ? from : (uint32_t)now;   // Zukunft gibt es nicht
+    tMin = (time_t)from;
+    tMax = (time_t)to;
+  } else if (range == "1h") {
     struct tm t{};
     localtime_r(&now, &t);
     t.tm_min = 0;
     t.tm_sec = 0;
     tMin = mktime(&t);
+  } else if (range == "live") {
+    tMin = now - 10 * 60;
   } else if (range == "12h") {
     tMin = now - 12 * 3600;
   } else if (range == "24h" || range == "today") {
     tMin = startOfTodayLocal(); // 00:00 lokal
-  } else if (range == "7d" || range == "month") {
-    // TODO: deinen bestehenden Tagesmittel-Code hier wieder einsetzen
-    server.send(400, "application/json", "{\"error\":\"not_implemented_in_this_block\"}");
-    return;
+  } else if (range == "7d") {
+    dailyDays = 7;   // Tagesmittel aus /log/YYYY-MM.sum
+  } else if (range == "month") {
+    struct tm t{};
+    localtime_r(&now, &t);
+    dailyDays = t.tm_mday;
   } else {
     server.send(400, "application/json", "{\"error\":\"bad_range\"}");
     return;
   }
+  q.tMin = (uint32_t)tMin;
+  q.tMax = (uint32_t)tMax;
+
+  // 1h/live aus dem RAM; SD nur für den Teil davor, den der Puffer (noch) nicht abdeckt
+  const bool ram = !server.hasArg("from") && (range == "1h" || range == "live");
+  const uint32_t ramFrom = sampleRingCount() ? sampleRingOldest() : 0xFFFFFFFFu;
+  const bool flash = loggerFlashActive();   // keine SD: Flash-Ring statt Tagesdateien
+  bool useSd = !ram || ramFrom > q.tMin;
+  if (useSd && !loggerSdOk() && !flash) {
+    if (!ram) {
+      server.send(503, "application/json", "{\"error\":\"sd_not_ready\"}");
+      return;
+    }
+    useSd = false;
+  }
+  // solange gespeicherte Tage (SD bzw. Flash-Ring) und der Schreibpuffer des Loggers gelesen werden,
+  // schreibt der Storage-Task nicht; Ringpuffer und Ausgabe danach ohne Sperre
+  bool sdHeld = useSd && loggerSdLock();
+  if (useSd && !sdHeld) {
+    server.send(503, "application/json", "{\"error\":\"sd_busy\"}");
+    return;
+  }
+  auto sdDone = [&sdHeld]() {
+    if (sdHeld) loggerSdUnlock();
+    sdHeld = false;
+  };
 
-  // ===== series arrays anlegen =====
-  String metricKeys[8];
-  JsonArray seriesArrs[8];
-  int metricCount = 0;
+  // from=/to=: vor dem ältesten Tag eines vollständigen Katalogs liegt nichts (from=0 nicht Tag für Tag
+  // prüfen); was dann noch länger als HIST_MAX_DAYS ist, abweisen statt unter der Sperre durchzulaufen
+  if (server.hasArg("from") && useSd && !flash) {
+    LogCatalogDay oldest;
+    if (logCatalogReady() && logCatalogComplete() && logCatalogOldest(oldest) && oldest.first > q.tMin) {
+      q.tMin = oldest.first < q.tMax ? oldest.first : q.tMax;
+    }
+    if (q.tMax - q.tMin > HIST_MAX_DAYS * 86400u) {
+      sdDone();
+      server.send(400, "application/json", "{\"error\":\"range_too_long\"}");
+      return;
+    }
+  }
 
-  for (int i=0;i<mn;i++){
-    const String& key = metrics[i];
-    if (!metricToCol(key)) continue; // nur bekannte
-    metricKeys[metricCount] = key;
-    seriesArrs[metricCount] = series.createNestedArray(key);
-    metricCount++;
+  ChunkWriter w(server);
+  HistJsonOut jsonOut(w, q);
+  HistBinOut  binOut(w, q);
+  HistSink& out = bin ? (HistSink&)binOut : (HistSink&)jsonOut;
+  const char* mode = (chart == "bar") ? "bar" : "line";
+
+  if (bin) {
+    w.begin("application/octet-stream");
+    binOut.begin(mode, dailyDays > 0);
+  } else {
+    w.begin("application/json");
+    jsonOut.begin(mode, dailyDays > 0);
   }
 
-  // ===== Datei: nur heute =====
-  const String day = dayStringLocalFromEpoch(now);
-  const String path = logPathForDay(day);
+  if (dailyDays > 0) {
+    readDaily(now, dailyDays, q, out, flash);
+    sdDone();
+  } else {
+    // ===== Rohdaten: alle Tagesdateien zwischen tMin und tMax =====
+    HistDownsampler ds(out, q, q.tMin, q.tMax, (uint16_t)points);
+    HistSkipEmpty skip(points ? (HistSink&)ds : out, q);
+    HistInterp sink(skip, q, interp);
 
-  // ===== Datei lesen (header oder no-header) =====
-  auto readFile = [&](const String& p)->void {
-    if (!SD.exists(p)) return;
-    File f = SD.open(p, FILE_READ);
-    if (!f) return;
+    if (ram) {
+      if (useSd) {
+        HistQuery sdq = q;
+        if (ramFrom <= q.tMax) sdq.tMax = ramFrom - 1;
+        readStored(sdq, sink, flash);
+        readPending(sdq, sink);
+      }
+      sdDone();
+      readRing(q, sink);
+    } else {
+      readStored(q, sink, flash);
+      readPending(q, sink);
+      sdDone();
+    }
+    sink.finish();
+    ds.flush();
+  }
 
-    String first = f.readStringUntil('\n');
-    first.trim();
-    if (!first.length()) { f.close(); return; }
+  if (!bin && captures) {
+    jsonOut.closeRows();
+    // Captures liegen auf der SD: eigene, kurze Sperre
+    const bool capHeld = dailyDays == 0 && loggerSdOk() && loggerSdLock();
+    if (capHeld) {
+      writeCaptures(w, q, (uint16_t)points);
+      loggerSdUnlock();
+    } else {
+      w.print(",\"captures\":[]");
+    }
+  }
 
-    const int MAXC=16;
-    String cols[MAXC]; int n=0;
-    String parts[MAXC]; int pn=0;
+  if (bin) binOut.end();
+  else jsonOut.end();
+  w.end();
 
-    bool hasHeader = looksLikeHeader(first);
+  const uint32_t rows = bin ? binOut.rows() : jsonOut.rows();
+  Serial.printf("[history] range=%s from=%lu to=%lu fmt=%s rows=%lu bad=%lu badrec=%lu bytes=%lu heap_start=%lu heap_min=%lu dt=%lums\n",
+                server.hasArg("from") ? "custom" : range.c_str(), (unsigned long)q.tMin, (unsigned long)q.tMax,
+                bin ? "bin" : "json", (unsigned long)rows, (unsigned long)g_badFields, (unsigned long)g_badRecords,
+                (unsigned long)w.bytes(),
+                (unsigned long)w.heapStart(), (unsigned long)w.heapMin(),
+                (unsigned long)(millis() - t0));
+}
 
-    int idxEpoch = 0;
-    int idx[8];
-    for(int i=0;i<metricCount;i++) idx[i] = -1;
+// ============================================================================
+// CSV-Export eines Tages: CSV-Datei (ohne Prüfsummenspalte), sonst aus .bin/.gor/Monatsarchiv umkodiert
+// ============================================================================
+static bool isDayString(const String& d) {
+  if (d.length() != 10 || d.charAt(4) != '-' || d.charAt(7) != '-') return false;
+  for (int i=0;i<10;i++) {
+    if (i == 4 || i == 7) continue;
+    if (!isDigit(d.charAt(i))) return false;
+  }
+  return true;
+}
 
-    if (hasHeader) {
-      splitCsv(first, cols, MAXC, n);
-      idxEpoch = findColIndex(cols, n, COL_EPOCH);
-      if (idxEpoch < 0) { f.close(); return; }
+// Metriken einer .bin (Header), .gor (alle Blöcke) bzw. laut Monatsarchiv; false wenn es nichts davon gibt
+static bool binaryDayMask(const String& day, uint32_t& mask) {
+  if (dayIsArchived(day)) {
+    LogArcDay e;
+    File f = logArchiveOpenDay(day, e);
+    if (f) {
+      f.close();
+      mask = e.mask;
+      return true;
+    }
+  }
 
-      for(int i=0;i<metricCount;i++){
-        const char* col = metricToCol(metricKeys[i]);
-        idx[i] = col ? findColIndex(cols, n, col) : -1;
-      }
-    } else {
-      // kein header → feste positionen
-      idxEpoch = 0;
-      for(int i=0;i<metricCount;i++) idx[i] = metricToIndexNoHeader(metricKeys[i]);
-
-      // first ist daten → mitverarbeiten
-      splitCsv(first, parts, MAXC, pn);
-      if (pn > idxEpoch) {
-        time_t ep = (time_t)parts[idxEpoch].toInt();
-        if (ep >= tMin) {
-          struct tm tl{}; localtime_r(&ep, &tl);
-          char lb[6]; snprintf(lb, sizeof(lb), "%02d:%02d", tl.tm_hour, tl.tm_min);
-          labels.add(String(lb));
-
-          for(int i=0;i<metricCount;i++){
-            float v;
-            if (idx[i] >= 0 && pn > idx[i] && parseFloatField(parts[idx[i]], v)) seriesArrs[i].add(v);
-            else seriesArrs[i].add(nullptr);
-          }
-        }
-      }
+  const String binPath = logPathForDay(day, ".bin");
+  if (SD.exists(binPath)) {
+    File f = SD.open(binPath, FILE_READ);
+    LogBinHeader h;
+    const bool ok = f && logBinReadHeader(f, h);
+    if (f) f.close();
+    if (ok) { mask = h.mask; return true; }
+  }
+
+  const String gorPath = logPathForDay(day, ".gor");
+  if (!SD.exists(gorPath)) return false;
+  File f = SD.open(gorPath, FILE_READ);
+  if (!f) return false;
+
+  mask = 0;
+  const uint32_t blocks = logGorBlockCount(f);
+  for (uint32_t b=0;b<blocks;b++) {
+    LogGorBlockHeader h;
+    f.seek((size_t)b * LOG_GOR_BLOCK_SIZE);
+    if (f.read((uint8_t*)&h, sizeof(h)) != sizeof(h)) break;
+    if (h.magic == LOG_GOR_MAGIC) mask |= h.mask;
+  }
+  f.close();
+  return blocks > 0;
+}
+
+// CSV-Zeilen wie vom Logger geschrieben (leeres Feld = kein Wert)
+class HistCsvOut : public HistSink {
+public:
+  HistCsvOut(ChunkWriter& w, const HistQuery& q) : _w(w), _q(q) {}
+
+  void row(uint32_t ep, const float* vals) override {
+    _w.printU32(ep);
+    for (int i=0;i<_q.metricCount;i++) {
+      _w.print(",");
+      if (isfinite(vals[i])) _w.printFloat(vals[i]);
     }
+    _w.print("\n");
+  }
 
-    while (f.available()) {
-      String line = f.readStringUntil('\n');
-      line.trim();
-      if (!line.length()) continue;
+private:
+  ChunkWriter&     _w;
+  const HistQuery& _q;
+};
 
-      splitCsv(line, parts, MAXC, pn);
-      if (pn <= idxEpoch) continue;
+// Download-Header + Kopfzeile mit den Spalten von q
+static void beginCsv(WebServer& server, ChunkWriter& w, const String& day, const HistQuery& q) {
+  server.sendHeader("Content-Disposition", "attachment; filename=\"" + day + ".csv\"");
+  w.begin("text/csv");
+  w.print(COL_EPOCH);
+  for (int i=0;i<q.metricCount;i++) {
+    w.print(",");
+    w.print(LOG_METRICS[q.midx[i]].col);
+  }
+  w.print("\n");
+}
 
-      time_t ep = (time_t)parts[idxEpoch].toInt();
-      if (ep < tMin) continue;
+// Zeitfenster eines Tages "YYYY-MM-DD" (lokal)
+static void dayWindow(const String& day, HistQuery& q) {
+  struct tm td{};
+  td.tm_year = day.substring(0, 4).toInt() - 1900;
+  td.tm_mon  = day.substring(5, 7).toInt() - 1;
+  td.tm_mday = day.substring(8, 10).toInt();
+  td.tm_isdst = -1;
+  q.tMin = (uint32_t)mktime(&td);
+  td.tm_mday++; td.tm_isdst = -1;
+  q.tMax = (uint32_t)mktime(&td) - 1;
+}
 
-      struct tm tl{}; localtime_r(&ep, &tl);
-      char lb[6]; snprintf(lb, sizeof(lb), "%02d:%02d", tl.tm_hour, tl.tm_min);
-      labels.add(String(lb));
+// CSV-Datei des Loggers ohne die interne Prüfsummenspalte (log_format.h); Zeilen mit falscher CRC fallen weg.
+// Danach die noch nicht geschriebenen Zeilen des Tages (win: Zeitfenster) in den Spalten der Kopfzeile.
+static void streamCsvDay(WebServer& server, File& f, const String& day, const HistQuery& win) {
+  LogCsvReader rd(f);
+  server.sendHeader("Content-Disposition", "attachment; filename=\"" + day + ".csv\"");
+  ChunkWriter w(server);
+  w.begin("text/csv");
 
-      for(int i=0;i<metricCount;i++){
-        float v;
-        if (idx[i] >= 0 && pn > idx[i] && parseFloatField(parts[idx[i]], v)) seriesArrs[i].add(v);
-        else seriesArrs[i].add(nullptr);
+  HistQuery q = win;
+  bool header = false;
+  if (rd.next()) {
+    const int crc = rd.find(LOG_CSV_COL_CRC);   // nur in der Kopfzeile, Dateien ohne CRC: -1
+    header = strcmp(rd.field(0), COL_EPOCH) == 0;
+    for (uint8_t i=1;header && i<rd.count();i++) {
+      if ((int)i == crc) continue;
+      const int m = logMetricIndexByCol(rd.field(i));
+      if (m < 0 || q.metricCount >= LOG_METRIC_COUNT) header = false;
+      else q.midx[q.metricCount++] = m;
+    }
+    do {
+      for (uint8_t i=0;i<rd.count();i++) {
+        if ((int)i == crc) continue;
+        if (i) w.print(",");
+        w.print(rd.field(i));
       }
+      w.print("\n");
+      rd.setCrc(crc >= 0);
+    } while (rd.next());
+  }
+  if (header) {
+    HistCsvOut out(w, q);
+    readPending(q, out);
+  }
+  w.end();
+
+  if (rd.crcErrors()) {
+    Serial.printf("[csv] %s: %lu Zeilen mit falscher CRC ausgelassen\n", day.c_str(), (unsigned long)rd.crcErrors());
+  }
+}
+
+void apiLogCsv(WebServer &server) {
+  AppConfig* cfg = settingsRequireCfgAndAuth(server);
+  if (!cfg) return;
+
+  const bool flash = loggerFlashActive();
+  if (!loggerSdOk() && !flash) {
+    server.send(503, "application/json", "{\"error\":\"sd_not_ready\"}");
+    return;
+  }
+
+  const String day = server.hasArg("day") ? server.arg("day") : logDayStringFromEpoch(time(nullptr));
+  if (!isDayString(day)) {
+    server.send(400, "application/json", "{\"error\":\"bad_day\"}");
+    return;
+  }
+
+  // noch nicht geschriebene Zeilen kommen unter der Sperre aus dem RAM (readPending), kein loggerFlush()
+  LoggerSdGuard sdLock;
+  if (!sdLock.held()) {
+    server.send(503, "application/json", "{\"error\":\"sd_busy\"}");
+    return;
+  }
+
+  HistQuery win;
+  dayWindow(day, win);
+
+  // ohne SD: Zeilen des Tages aus dem Flash-Ring
+  if (flash) {
+    HistQuery q = win;
+    const uint32_t mask = flashMask(q);
+    if (!mask) {
+      server.send(404, "application/json", "{\"error\":\"no_data\"}");
+      return;
     }
+    for (int i=0;i<LOG_METRIC_COUNT;i++) if (mask & LOG_METRICS[i].bit) q.midx[q.metricCount++] = i;
+    ChunkWriter w(server);
+    beginCsv(server, w, day, q);
+    HistCsvOut out(w, q);
+    readFlash(q, out);
+    readPending(q, out);
+    w.end();
+    return;
+  }
 
-    f.close();
-  };
+  const String csvPath = logPathForDay(day);
+
+  if (SD.exists(csvPath)) {
+    File f = SD.open(csvPath, FILE_READ);
+    if (f) {
+      streamCsvDay(server, f, day, win);
+      f.close();
+      return;
+    }
+  }
+
+  // sonst aus .bin, .gor bzw. dem Monatsarchiv umkodieren, Spalten = Metriken der Datei
+  // noch keine Datei, aber Zeilen im Schreibpuffer: Spalten = aktuell geloggte Metriken
+  uint32_t mask = 0;
+  if (!binaryDayMask(day, mask) && hasPending(win)) mask = cfg->log_metric_mask;
+  if (!mask) {
+    server.send(404, "application/json", "{\"error\":\"no_data\"}");
+    return;
+  }
+
+  HistQuery q = win;
+  for (int i=0;i<LOG_METRIC_COUNT;i++) if (mask & LOG_METRICS[i].bit) q.midx[q.metricCount++] = i;
 
-  readFile(path);
+  ChunkWriter w(server);
+  beginCsv(server, w, day, q);
+  HistCsvOut out(w, q);
+  if (!readArcDay(day, q, out) && !readBinDay(day, q, out)) readGorDay(day, q, out);
+  readPending(q, out);
 
-  String out;
-  serializeJson(doc, out);
-  server.send(200, "application/json", out);
+  w.end();
 }
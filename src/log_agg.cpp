@@ -0,0 +1,34 @@
+#include "log_agg.h"
+
+void LogAgg::add(const float* vals) {
+  _samples++;
+  for (int i = 0; i < LOG_METRIC_COUNT; i++) {
+    const float v = vals[i];
+    if (isnan(v)) continue;
+    _n[i]++;
+    _sum[i] += v;
+    if (isnan(_min[i]) || v < _min[i]) _min[i] = v;
+    if (isnan(_max[i]) || v > _max[i]) _max[i] = v;
+  }
+}
+
+void LogAgg::reset() {
+  *this = LogAgg();
+}
+
+void LogAgg::take(LogSample& mean, LogSample& mn, LogSample& mx, uint32_t metricMask) {
+  for (int i = 0; i < LOG_METRIC_COUNT; i++) {
+    if (!(metricMask & LOG_METRICS[i].bit)) {
+      mean.v[i] = mn.v[i] = mx.v[i] = NAN;
+      continue;
+    }
+    mean.v[i] = _n[i] ? (float)(_sum[i] / _n[i]) : NAN;
+    mn.v[i] = _min[i];
+    mx.v[i] = _max[i];
+    _n[i] = 0;
+    _sum[i] = 0;
+    _min[i] = NAN;
+    _max[i] = NAN;
+  }
+  _samples = 0;
+}
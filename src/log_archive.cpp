@@ -0,0 +1,471 @@
+#include "log_archive.h"
+#include <SD.h>
+#include <stddef.h>
+#include "log_bits.h"
+#include "log_csv.h"
+#include "log_gorilla.h"
+#include "log_catalog.h"
+#include "log_rollup.h"
+
+static constexpr uint16_t ARC_ROWS_PER_STEP = 64;
+static constexpr uint32_t ARC_RESCAN_MS     = 10ul * 60ul * 1000ul;   // nichts zu tun -> so lange warten
+static const char* const  ARC_DAY_EXT[] = { ".csv", ".bin", ".gor", ".idx", LOG_ENV_EXT };   // .env wird nicht archiviert
+
+// Übernahme eines Tages: COPY (Samples umkodieren) -> Inhaltsverzeichnis -> DROP (Einzeldateien löschen)
+enum ArcState : uint8_t { ARC_IDLE, ARC_COPY, ARC_DROP };
+// Quelle bevorzugt .bin > .gor > .csv (wie beim Rollup-Backfill)
+enum ArcSrc : uint8_t { ARC_SRC_CSV, ARC_SRC_BIN, ARC_SRC_GOR };
+
+static ArcState     g_state = ARC_IDLE;
+static uint32_t     g_nextScanMs = 0;
+static String       g_day = "";
+static uint8_t      g_slot = 0;
+static ArcSrc       g_srcKind = ARC_SRC_CSV;
+static uint32_t     g_srcOff = 0;          // Fortschritt in der Quelle (Datei wird je Schritt neu geöffnet)
+static uint32_t     g_srcMask = 0;         // Metriken der Quelle (.gor: Vereinigung aller Blöcke)
+static uint32_t     g_srcBytes = 0;        // Einzeldateien laut Katalog
+static LogBinHeader g_srcHdr {};
+static int8_t       g_csvCol[LOG_METRIC_COUNT];
+static bool         g_csvCrc = false;
+
+static LogArcDay    g_entry {};            // Slot des laufenden Tages
+static uint32_t     g_writeOff = 0;        // nächste Schreibposition im Archiv
+static LogBinHeader g_outHdr {};
+static LogGorEncoder g_enc;
+static uint8_t      g_out[ARC_ROWS_PER_STEP * LOG_BIN_MAX_REC + sizeof(LogBinHeader)];
+static size_t       g_outLen = 0;
+static uint8_t      g_dropExt = 0;
+static LogArchiveStats g_stats;
+
+String logArchivePath(const String& dayOrMonth) {
+  return String("/log/") + dayOrMonth.substring(0, 7) + ".arc";
+}
+
+bool logArchiveParseName(const String& base, int& y, int& m) {
+  if (base.length() != 11 || base.charAt(4) != '-' || !base.endsWith(".arc")) return false;
+  for (int i = 0; i < 7; i++) {
+    if (i != 4 && !isDigit(base.charAt(i))) return false;
+  }
+  y = base.substring(0, 4).toInt();
+  m = base.substring(5, 7).toInt();
+  return y >= 1970 && m >= 1 && m <= 12;
+}
+
+static int slotOf(const String& day) {
+  return (int)day.substring(8, 10).toInt() - 1;
+}
+
+// ============================================================================
+// Inhaltsverzeichnis
+// ============================================================================
+static uint16_t tocCrc(const LogArcToc& t) {
+  return logCrc16((const uint8_t*)&t.seq, sizeof(t) - offsetof(LogArcToc, seq));
+}
+
+static bool readTocAt(File& f, uint32_t off, LogArcToc& t) {
+  f.seek(off);
+  return f.read((uint8_t*)&t, sizeof(t)) == sizeof(t) && t.magic == LOG_ARC_MAGIC &&
+         t.version == LOG_ARC_VERSION && t.crc == tocCrc(t);
+}
+
+bool logArchiveReadToc(File& f, LogArcToc& toc) {
+  // ohne zweite Kopie im RAM: A lesen, von B nur den Kopf; B ganz lesen, wenn jünger
+  const bool okA = readTocAt(f, 0, toc);
+  uint8_t head[offsetof(LogArcToc, month)];
+  f.seek(LOG_ARC_TOC_SLOT);
+  if (f.read(head, sizeof(head)) != sizeof(head)) return okA;
+  uint32_t magicB, seqB;
+  memcpy(&magicB, head + offsetof(LogArcToc, magic), 4);
+  memcpy(&seqB, head + offsetof(LogArcToc, seq), 4);
+  if (magicB != LOG_ARC_MAGIC || (okA && seqB <= toc.seq)) return okA;
+
+  if (readTocAt(f, LOG_ARC_TOC_SLOT, toc)) return true;
+  return okA && readTocAt(f, 0, toc);
+}
+
+// immer die ältere Kopie überschreiben
+static bool writeToc(File& f, LogArcToc& t) {
+  t.seq++;
+  t.crc = tocCrc(t);
+  f.seek((t.seq & 1) ? LOG_ARC_TOC_SLOT : 0);
+  const bool ok = f.write((const uint8_t*)&t, sizeof(t)) == sizeof(t);
+  f.flush();
+  return ok;
+}
+
+static bool createArchive(const String& path, uint32_t month) {
+  File f = SD.open(path, FILE_WRITE);
+  if (!f) return false;
+
+  LogArcToc t {};
+  t.magic = LOG_ARC_MAGIC;
+  t.version = LOG_ARC_VERSION;
+  t.month = month;
+  t.crc = tocCrc(t);
+  bool ok = f.write((const uint8_t*)&t, sizeof(t)) == sizeof(t);
+
+  // Rest von Kopie A und Kopie B leer (B ungültig, bis sie zum ersten Mal geschrieben wird)
+  uint8_t zero[64] = {};
+  for (uint32_t n = sizeof(t); ok && n < LOG_ARC_DATA; ) {
+    const uint32_t k = (LOG_ARC_DATA - n < sizeof(zero)) ? LOG_ARC_DATA - n : sizeof(zero);
+    ok = f.write(zero, k) == k;
+    n += k;
+  }
+  f.close();
+  return ok;
+}
+
+File logArchiveOpenDay(const String& day, LogArcDay& out) {
+  const int slot = slotOf(day);
+  if (slot < 0 || slot >= LOG_ARC_DAYS) return File();
+
+  const String path = logArchivePath(day);
+  if (!SD.exists(path)) return File();
+  File f = SD.open(path, FILE_READ);
+  if (!f) return f;
+
+  LogArcToc toc;
+  if (!logArchiveReadToc(f, toc) || toc.month != logCatalogKey(day) / 100u ||
+      toc.days[slot].kind == LOG_ARC_NONE) {
+    f.close();
+    return File();
+  }
+  out = toc.days[slot];
+  return f;
+}
+
+bool logArchiveDropDay(const String& day) {
+  const int slot = slotOf(day);
+  if (slot < 0 || slot >= LOG_ARC_DAYS) return false;
+
+  const String path = logArchivePath(day);
+  if (!SD.exists(path)) return false;
+  File f = SD.open(path, "r+");
+  if (!f) return false;
+
+  LogArcToc toc;
+  if (!logArchiveReadToc(f, toc) || toc.days[slot].kind == LOG_ARC_NONE) { f.close(); return false; }
+  memset(&toc.days[slot], 0, sizeof(LogArcDay));
+
+  bool any = false;
+  for (const LogArcDay& d : toc.days) if (d.kind != LOG_ARC_NONE) any = true;
+  if (any) {
+    const bool ok = writeToc(f, toc);
+    f.close();
+    return ok;
+  }
+  // letzter Tag des Monats -> ganze Datei weg
+  f.close();
+  return SD.remove(path);
+}
+
+// ============================================================================
+// Übernahme: Quelle
+// ============================================================================
+static const char* srcExt(ArcSrc k) {
+  return (k == ARC_SRC_BIN) ? ".bin" : (k == ARC_SRC_GOR) ? ".gor" : ".csv";
+}
+
+static uint32_t dayStartOf(const String& day) {
+  struct tm t {};
+  t.tm_year = day.substring(0, 4).toInt() - 1900;
+  t.tm_mon  = day.substring(5, 7).toInt() - 1;
+  t.tm_mday = day.substring(8, 10).toInt();
+  t.tm_isdst = -1;
+  return (uint32_t)mktime(&t);
+}
+
+// Quelle wählen, Metriken bestimmen, g_srcOff auf den ersten Datensatz
+static bool openSource(const String& day) {
+  if (SD.exists(logPathForDay(day, ".bin")))      g_srcKind = ARC_SRC_BIN;
+  else if (SD.exists(logPathForDay(day, ".gor"))) g_srcKind = ARC_SRC_GOR;
+  else if (SD.exists(logPathForDay(day)))         g_srcKind = ARC_SRC_CSV;
+  else return false;
+
+  File f = SD.open(logPathForDay(day, srcExt(g_srcKind)), FILE_READ);
+  if (!f) return false;
+
+  bool ok = true;
+  g_srcMask = 0;
+  g_srcOff = 0;
+  if (g_srcKind == ARC_SRC_BIN) {
+    ok = logBinReadHeader(f, g_srcHdr);
+    g_srcMask = g_srcHdr.mask;
+    g_srcOff = g_srcHdr.header_size;
+  } else if (g_srcKind == ARC_SRC_GOR) {
+    const uint32_t blocks = logGorBlockCount(f);
+    for (uint32_t b = 0; b < blocks; b++) {
+      LogGorBlockHeader h;
+      f.seek((size_t)b * LOG_GOR_BLOCK_SIZE);
+      if (f.read((uint8_t*)&h, sizeof(h)) != sizeof(h)) break;
+      if (h.magic == LOG_GOR_MAGIC) g_srcMask |= h.mask;
+    }
+  } else {
+    LogCsvReader rd(f);
+    g_csvCrc = false;
+    if (rd.next() && strncmp(rd.field(0), "epoch", 5) == 0) {
+      for (int i = 0; i < LOG_METRIC_COUNT; i++) {
+        g_csvCol[i] = (int8_t)rd.find(LOG_METRICS[i].col);
+        if (g_csvCol[i] > 0) g_srcMask |= LOG_METRICS[i].bit;
+      }
+      g_csvCrc = rd.find(LOG_CSV_COL_CRC) >= 0;
+      g_srcOff = rd.offset();
+    } else {
+      // kein Header -> feste Positionen, erste Zeile ist bereits Daten
+      for (int i = 0; i < LOG_METRIC_COUNT; i++) {
+        g_csvCol[i] = (int8_t)(i + 1);
+        g_srcMask |= LOG_METRICS[i].bit;
+      }
+    }
+  }
+  f.close();
+  return ok;
+}
+
+// ============================================================================
+// Übernahme: Ziel
+// ============================================================================
+// an g_writeOff schreiben; liegt die Position hinter dem Dateiende, wird mit Nullen aufgefüllt
+static bool writeAt(const uint8_t* p, size_t n) {
+  File f = SD.open(logArchivePath(g_day), "r+");
+  if (!f) return false;
+
+  uint32_t sz = (uint32_t)f.size();
+  if (sz < g_writeOff) {
+    uint8_t zero[64] = {};
+    f.seek(sz);
+    while (sz < g_writeOff) {
+      const uint32_t k = (g_writeOff - sz < sizeof(zero)) ? g_writeOff - sz : sizeof(zero);
+      f.write(zero, k);
+      sz += k;
+    }
+  }
+  f.seek(g_writeOff);
+  const bool ok = f.write(p, n) == n;
+  f.close();
+  if (ok) g_writeOff += (uint32_t)n;
+  return ok;
+}
+
+static bool flushOut() {
+  if (!g_outLen) return true;
+  const bool ok = writeAt(g_out, g_outLen);
+  g_outLen = 0;
+  return ok;
+}
+
+// mask = Metriken, die der Sample laut Quelle hat (.gor: je Block)
+static bool emit(const LogSample& s, uint32_t mask) {
+  if (!g_entry.first) g_entry.first = s.epoch;
+  g_entry.last = s.epoch;
+  g_entry.rows++;
+
+  if (g_entry.kind == LOG_ARC_BIN) {
+    if (g_outLen + g_outHdr.rec_size > sizeof(g_out) && !flushOut()) return false;
+    g_outLen += logBinEncode(g_outHdr, s, g_out + g_outLen);
+    return true;
+  }
+
+  // Block voll oder Metriken geändert -> Block schreiben, neuer Block dahinter
+  if (g_enc.mask() != mask || !g_enc.add(s)) {
+    if (!g_enc.empty() && !writeAt(g_enc.block(), LOG_GOR_BLOCK_SIZE)) return false;
+    g_enc.reset(mask);
+    g_enc.add(s);
+  }
+  return true;
+}
+
+static void abortDay(const char* why) {
+  Serial.printf("[logger] archiv %s abgebrochen: %s\n", g_day.c_str(), why);
+  g_outLen = 0;
+  g_state = ARC_IDLE;
+  g_nextScanMs = millis() + ARC_RESCAN_MS;
+}
+
+// Tag steht im Inhaltsverzeichnis -> Katalog umstellen, Einzeldateien löschen
+static void startDrop(uint32_t length) {
+  logCatalogArchived(g_day, length);
+  g_dropExt = 0;
+  g_state = ARC_DROP;
+}
+
+static bool startDay(const String& day, uint32_t srcBytes, bool compress) {
+  g_day = day;
+  g_slot = (uint8_t)slotOf(day);
+  g_srcBytes = srcBytes;
+  const String path = logArchivePath(day);
+  if (!SD.exists(path) && !createArchive(path, logCatalogKey(day) / 100u)) return false;
+
+  File f = SD.open(path, FILE_READ);
+  if (!f) return false;
+  LogArcToc toc;
+  const bool ok = logArchiveReadToc(f, toc);
+  f.close();
+  if (!ok) {
+    Serial.println("[logger] archiv ungueltig: " + path);
+    return false;
+  }
+
+  // schon übernommen (Stromausfall vor dem Löschen der Einzeldateien) -> nur noch aufräumen
+  if (toc.days[g_slot].kind != LOG_ARC_NONE) {
+    startDrop(toc.days[g_slot].length);
+    return true;
+  }
+
+  if (!openSource(day)) {
+    logCatalogRefresh(day);   // Katalog veraltet
+    return false;
+  }
+
+  // hinter den letzten übernommenen Tag; Reste eines abgebrochenen Versuchs werden überschrieben
+  uint32_t end = LOG_ARC_DATA;
+  for (const LogArcDay& d : toc.days) {
+    if (d.kind != LOG_ARC_NONE && d.offset + d.length > end) end = d.offset + d.length;
+  }
+  g_writeOff = (end + LOG_ARC_ALIGN - 1) / LOG_ARC_ALIGN * LOG_ARC_ALIGN;
+
+  memset(&g_entry, 0, sizeof(g_entry));
+  g_entry.offset = g_writeOff;
+  g_entry.mask = g_srcMask;
+  g_entry.kind = compress ? LOG_ARC_GOR : LOG_ARC_BIN;
+  g_outLen = 0;
+  if (g_entry.kind == LOG_ARC_BIN) {
+    logBinInitHeader(g_outHdr, g_srcMask, (g_srcKind == ARC_SRC_BIN) ? g_srcHdr.day_start : dayStartOf(day));
+    memcpy(g_out, &g_outHdr, sizeof(g_outHdr));
+    g_outLen = sizeof(g_outHdr);
+  } else {
+    g_enc.reset(g_srcMask);
+  }
+  g_state = ARC_COPY;
+  return true;
+}
+
+static void finishDay() {
+  if (g_entry.kind == LOG_ARC_GOR && !g_enc.empty() && !writeAt(g_enc.block(), LOG_GOR_BLOCK_SIZE)) {
+    abortDay("schreiben");
+    return;
+  }
+  g_entry.length = g_writeOff - g_entry.offset;
+
+  // Inhaltsverzeichnis frisch lesen: Aufräumen kann inzwischen Tage ausgetragen haben
+  File f = SD.open(logArchivePath(g_day), "r+");
+  if (!f) { abortDay("archiv weg"); return; }
+  LogArcToc toc;
+  bool ok = logArchiveReadToc(f, toc);
+  if (ok) {
+    toc.days[g_slot] = g_entry;
+    ok = writeToc(f, toc);
+  }
+  f.close();
+  if (!ok) { abortDay("inhaltsverzeichnis"); return; }
+
+  g_stats.days++;
+  g_stats.bytesIn += g_srcBytes;
+  g_stats.bytesOut += g_entry.length;
+  Serial.printf("[logger] archiv: %s -> %s (%lu Werte, %lu -> %lu kB)\n", g_day.c_str(),
+                logArchivePath(g_day).c_str(), (unsigned long)g_entry.rows,
+                (unsigned long)(g_srcBytes / 1024), (unsigned long)(g_entry.length / 1024));
+  startDrop(g_entry.length);
+}
+
+// ein Schritt: bis zu ARC_ROWS_PER_STEP Zeilen bzw. ein .gor-Block
+static void copyStep() {
+  File src = SD.open(logPathForDay(g_day, srcExt(g_srcKind)), FILE_READ);
+  if (!src) { abortDay("quelle weg"); return; }
+  src.seek(g_srcOff);
+
+  bool end = false, ok = true;
+  LogSample s;
+  if (g_srcKind == ARC_SRC_GOR) {
+    uint8_t blk[LOG_GOR_BLOCK_SIZE];
+    LogGorDecoder dec;
+    if (src.read(blk, sizeof(blk)) != sizeof(blk)) end = true;
+    else if (dec.begin(blk)) {
+      while (ok && dec.next(s)) ok = emit(s, dec.header().mask);
+    }
+    g_srcOff += LOG_GOR_BLOCK_SIZE;
+  } else if (g_srcKind == ARC_SRC_BIN) {
+    uint8_t rec[LOG_BIN_MAX_REC];
+    for (uint16_t rows = 0; ok && rows < ARC_ROWS_PER_STEP; rows++) {
+      if (src.read(rec, g_srcHdr.rec_size) != g_srcHdr.rec_size) { end = true; break; }
+      g_srcOff += g_srcHdr.rec_size;
+      if (!logBinRecordOk(g_srcHdr, rec)) continue;
+      logBinDecode(g_srcHdr, rec, s);
+      if (s.epoch) ok = emit(s, g_srcMask);
+    }
+  } else {
+    LogCsvReader rd(src);
+    rd.setCrc(g_csvCrc);
+    for (uint16_t rows = 0; ok && rows < ARC_ROWS_PER_STEP; rows++) {
+      if (!rd.next()) { end = true; break; }
+      if (logCsvParseU32(rd.field(0), s.epoch) != LOG_CSV_OK || !s.epoch) continue;
+      for (int i = 0; i < LOG_METRIC_COUNT; i++) {
+        float v;
+        s.v[i] = (g_csvCol[i] > 0 && logCsvParseFloat(rd.field((uint8_t)g_csvCol[i]), v) == LOG_CSV_OK) ? v : NAN;
+      }
+      ok = emit(s, g_srcMask);
+    }
+    g_srcOff = rd.offset();
+  }
+  src.close();
+
+  if (!ok || !flushOut()) { abortDay("schreiben"); return; }
+  if (end) finishDay();
+}
+
+static void dropStep() {
+  if (g_dropExt < sizeof(ARC_DAY_EXT) / sizeof(ARC_DAY_EXT[0])) {
+    const String p = logPathForDay(g_day, ARC_DAY_EXT[g_dropExt++]);
+    if (SD.exists(p)) SD.remove(p);
+    return;
+  }
+  g_state = ARC_IDLE;   // nächster Tag gleich im nächsten Schritt
+}
+
+// ältester noch nicht übernommener Tag vor der Altersgrenze
+static bool pickDay(time_t now, uint16_t ageDays, bool compress) {
+  if (!logCatalogReady()) return false;
+  const uint32_t cutoff = logCatalogKey(logDayStringFromEpoch(now - (time_t)ageDays * 86400));
+
+  for (uint16_t i = 0; i < logCatalogCount(); i++) {
+    LogCatalogDay cd;
+    if (!logCatalogAt(i, cd) || cd.day >= cutoff) break;
+    if (cd.formats & LOG_CATALOG_ARC) continue;
+
+    // erst nach der Tageszusammenfassung (der Backfill liest die Einzeldateien)
+    const String day = logCatalogDayString(cd.day);
+    LogRollupDay r;
+    if (!logRollupRead(day, r) || !(r.flags & LOG_ROLLUP_FINAL)) continue;
+
+    if (startDay(day, cd.bytes, compress)) return true;
+  }
+  return false;
+}
+
+void logArchiveStep(time_t now, uint16_t ageDays, bool compress) {
+  switch (g_state) {
+    case ARC_IDLE:
+      if (!ageDays) return;
+      if ((int32_t)(millis() - g_nextScanMs) < 0) return;
+      if (!pickDay(now, ageDays, compress)) g_nextScanMs = millis() + ARC_RESCAN_MS;
+      return;
+
+    case ARC_COPY:
+      copyStep();
+      return;
+
+    case ARC_DROP:
+      dropStep();
+      return;
+  }
+}
+
+bool logArchiveBusy() { return g_state != ARC_IDLE; }
+
+void logArchiveReset() {
+  g_state = ARC_IDLE;
+  g_outLen = 0;
+  g_nextScanMs = millis();
+}
+
+LogArchiveStats logArchiveGetStats() { return g_stats; }
@@ -0,0 +1,230 @@
+#include "log_burst.h"
+#include "sensor_data.h"
+#include "log_latency.h"
+#include <SD.h>
+#include <time.h>
+#include <freertos/FreeRTOS.h>
+
+static const char* const REASON_NAMES[] = { "none", "slope", "web", "mqtt", "sched" };
+static constexpr uint16_t SLOPE_SPAN_SEC = 60;   // CO2-Steigung über die letzte Minute
+
+enum BurstState : uint8_t { BURST_IDLE, BURST_ACTIVE };
+
+// Ring: g_head = nächste Schreibposition (loop), g_read = nächste zu schreibende Sekunde (Storage-Task);
+// fortlaufende Zähler, Slot = Zähler % LOG_BURST_RING.
+// Start/Verlängerung (loop) und Ende (Storage-Task) unter g_mux: g_state, g_read beim Start, g_end,
+// g_limit, g_mask, g_stats.reason/lastTrigger
+static portMUX_TYPE      g_mux = portMUX_INITIALIZER_UNLOCKED;
+static LogSample         g_ring[LOG_BURST_RING];
+static volatile uint32_t g_head = 0;
+static volatile uint32_t g_read = 0;
+static volatile uint32_t g_end = 0;          // erste Sekunde nach der Aufzeichnung
+static volatile uint32_t g_limit = 0;        // weiter als bis hier wird nicht verlängert
+static volatile uint8_t  g_state = BURST_IDLE;
+static volatile uint8_t  g_pending = LOG_BURST_NONE;   // manueller Trigger für die nächste Messung
+static volatile bool     g_abort = false;    // SD weg -> Aufzeichnung beenden
+static uint16_t          g_postSec = 0;      // zuletzt übergebene Länge (0 = Burst aus)
+static volatile uint32_t g_mask = 0;         // log_metric_mask beim Trigger (Header der Datei)
+static bool              g_slopeHigh = false;
+static int32_t           g_lastSchedHour = -1;
+
+// nur Storage-Task
+static char          g_path[40] = "";   // "/log/burst/<epoch>-<grund>.bin", leer = noch keine Datei
+static LogBinHeader  g_hdr {};
+static LogBurstStats g_stats;
+
+const char* logBurstReasonName(uint8_t reason) {
+  return reason <= LOG_BURST_SCHEDULE ? REASON_NAMES[reason] : "?";
+}
+
+bool logBurstParseName(const char* base, uint32_t& start, uint8_t& reason) {
+  const size_t len = strlen(base);
+  if (len < 16 || base[10] != '-' || strcmp(base + len - 4, ".bin") != 0) return false;
+  for (int i = 0; i < 10; i++) if (!isDigit(base[i])) return false;
+  start = (uint32_t)strtoul(base, nullptr, 10);
+  const size_t rlen = len - 15;   // zwischen '-' und ".bin"
+  reason = LOG_BURST_NONE;
+  for (uint8_t k = LOG_BURST_SLOPE; k <= LOG_BURST_SCHEDULE; k++) {
+    if (strlen(REASON_NAMES[k]) == rlen && strncmp(base + 11, REASON_NAMES[k], rlen) == 0) reason = k;
+  }
+  return true;
+}
+
+static void trigger(uint8_t reason, uint32_t epoch, uint32_t mask) {
+  const uint32_t head = g_head;   // die auslösende Messung liegt schon im Ring (head - 1)
+  bool started = false;
+  uint32_t pre = 0;
+
+  portENTER_CRITICAL(&g_mux);
+  if (g_state == BURST_IDLE) {
+    const uint32_t have = head ? head - 1 : 0;
+    pre = have < LOG_BURST_PRE_SEC ? have : LOG_BURST_PRE_SEC;
+    g_read = head - 1 - pre;
+    g_limit = head + LOG_BURST_MAX_SEC;
+    g_end = head + g_postSec;
+    g_stats.reason = reason;
+    g_stats.lastTrigger = epoch;
+    g_mask = mask;
+    g_state = BURST_ACTIVE;
+    started = true;
+  } else {
+    // erneuter Trigger: verlängern, aber nicht endlos
+    const uint32_t end = head + g_postSec;
+    g_end = end < g_limit ? end : g_limit;
+  }
+  portEXIT_CRITICAL(&g_mux);
+
+  if (started) Serial.printf("[burst] Trigger %s, %lu s Vorlauf\n", logBurstReasonName(reason), (unsigned long)pre);
+}
+
+// Steigung bzw. Zeitplan; manuelle Trigger kommen über g_pending
+static uint8_t checkTriggers(const LogBurstConfig& cfg, time_t now, float co2) {
+  uint8_t reason = g_pending;
+  g_pending = LOG_BURST_NONE;
+
+  // Steigung aus dem Ring: nur mit CO2 in log_metric_mask (sonst steht dort NAN)
+  if (cfg.slopePpmMin && (cfg.metricMask & LOG_CO2) && g_head >= SLOPE_SPAN_SEC && !isnan(co2)) {
+    const float then = g_ring[(g_head - SLOPE_SPAN_SEC) % LOG_BURST_RING].v[3];
+    const bool high = !isnan(then) && fabsf(co2 - then) >= cfg.slopePpmMin;
+    if (high && !g_slopeHigh && !reason) reason = LOG_BURST_SLOPE;   // nur bei der steigenden Flanke
+    g_slopeHigh = high;
+  }
+
+  if (cfg.everyH) {
+    struct tm t {};
+    localtime_r(&now, &t);
+    const int32_t hourKey = t.tm_yday * 24 + t.tm_hour;
+    if (t.tm_min == 0 && t.tm_hour % cfg.everyH == 0 && hourKey != g_lastSchedHour) {
+      g_lastSchedHour = hourKey;
+      if (!reason) reason = LOG_BURST_SCHEDULE;
+    }
+  }
+  return reason;
+}
+
+void logBurstPush(const LogBurstConfig& cfg, time_t now, const SensorData& d) {
+  g_postSec = cfg.postSec;
+  if (now < 1672531200) return;   // ohne Uhrzeit kein epoch
+
+  LogSample s;
+  s.epoch = (uint32_t)now;
+  const float vals[LOG_METRIC_COUNT] = { d.temperature_c, d.humidity_rh, d.pressure_hpa, d.co2_ppm };
+  for (int i = 0; i < LOG_METRIC_COUNT; i++) s.v[i] = (cfg.metricMask & LOG_METRICS[i].bit) ? vals[i] : NAN;
+
+  const uint8_t reason = cfg.postSec ? checkTriggers(cfg, now, d.co2_ppm) : LOG_BURST_NONE;
+
+  // während einer Aufzeichnung nichts überschreiben, was noch nicht auf der Karte ist
+  if (g_state == BURST_ACTIVE && g_head - g_read >= LOG_BURST_RING) {
+    g_stats.overruns++;
+  } else {
+    g_ring[g_head % LOG_BURST_RING] = s;
+    g_head = g_head + 1;
+  }
+
+  if (reason) trigger(reason, s.epoch, cfg.metricMask);
+}
+
+bool logBurstTrigger(uint8_t reason) {
+  if (!g_postSec) return false;
+  g_pending = reason;
+  return true;
+}
+
+// älteste Aufzeichnungen löschen, bis Platz für eine neue ist
+static void pruneOld() {
+  File dir = SD.open(LOG_BURST_DIR);
+  if (!dir) {
+    logSdMkdir(LOG_BURST_DIR);
+    return;
+  }
+  uint8_t n = 0;
+  uint32_t oldest = 0xFFFFFFFFu;
+  char oldestName[24] = "";
+  for (File f = dir.openNextFile(); f; f = dir.openNextFile()) {
+    const char* slash = strrchr(f.name(), '/');
+    const char* base = slash ? slash + 1 : f.name();
+    uint32_t start;
+    uint8_t reason;
+    if (!f.isDirectory() && logBurstParseName(base, start, reason)) {
+      n++;
+      if (start < oldest) {
+        oldest = start;
+        snprintf(oldestName, sizeof(oldestName), "%s", base);
+      }
+    }
+    f.close();
+  }
+  dir.close();
+  if (n >= LOG_BURST_MAX_FILES && oldestName[0]) {
+    char path[48];
+    snprintf(path, sizeof(path), "%s/%s", LOG_BURST_DIR, oldestName);
+    logSdRemove(path);
+  }
+}
+
+// Aufzeichnung beenden; ohne force nur, wenn sie nicht gerade (loop) verlängert wurde
+static void finish(bool force) {
+  portENTER_CRITICAL(&g_mux);
+  const bool done = force || g_read == g_end;
+  if (done) g_state = BURST_IDLE;
+  portEXIT_CRITICAL(&g_mux);
+  if (!done) return;
+  g_path[0] = '\0';
+  g_stats.captures++;
+}
+
+void logBurstStep() {
+  if (g_state != BURST_ACTIVE) return;
+  if (g_abort) { g_abort = false; finish(true); return; }
+
+  portENTER_CRITICAL(&g_mux);
+  const uint32_t head = g_head, end = g_end, mask = g_mask, trig = g_stats.lastTrigger;
+  const uint8_t reason = g_stats.reason;
+  portEXIT_CRITICAL(&g_mux);
+  const uint32_t upto = head < end ? head : end;
+  const uint32_t n = upto - g_read;
+  const bool last = upto == end;
+  if (n < LOG_BURST_CHUNK && !last) return;   // in Blöcken schreiben
+
+  if (!g_path[0]) {
+    pruneOld();
+    const LogSample& first = g_ring[g_read % LOG_BURST_RING];
+    snprintf(g_path, sizeof(g_path), "%s/%010lu-%s.bin", LOG_BURST_DIR, (unsigned long)first.epoch,
+             logBurstReasonName(reason));
+    logBinInitHeader(g_hdr, mask, trig);
+    File f = SD.open(g_path, FILE_WRITE);
+    if (!f) { Serial.printf("[burst] SD.open FAILED: %s\n", g_path); finish(true); return; }
+    f.write((const uint8_t*)&g_hdr, sizeof(g_hdr));
+    f.close();
+  }
+
+  if (n) {
+    File f = SD.open(g_path, FILE_APPEND);
+    if (!f) { finish(true); return; }
+    uint8_t buf[LOG_BURST_CHUNK * LOG_BIN_MAX_REC];
+    uint32_t done = 0;
+    while (done < n) {
+      size_t len = 0;
+      uint32_t k = 0;
+      for (; k < LOG_BURST_CHUNK && done + k < n; k++) len += logBinEncode(g_hdr, g_ring[(g_read + k) % LOG_BURST_RING], buf + len);
+      if (f.write(buf, len) != len) break;
+      g_read = g_read + k;
+      done += k;
+    }
+    f.close();
+    g_stats.samples += done;
+  }
+
+  if (last && g_read == end) finish(false);
+}
+
+void logBurstReset() {
+  if (g_state == BURST_ACTIVE) g_abort = true;
+  logBurstStep();
+}
+
+LogBurstStats logBurstGetStats() {
+  LogBurstStats s = g_stats;
+  s.active = g_state == BURST_ACTIVE;
+  return s;
+}
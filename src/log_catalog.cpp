@@ -0,0 +1,411 @@
+#include "log_catalog.h"
+#include "log_bits.h"
+#include "log_csv.h"
+#include "log_gorilla.h"
+#include "log_archive.h"
+#include <SD.h>
+
+static const char* CATALOG_PATH = "/log/catalog.bin";
+static const char* CATALOG_TMP  = "/log/catalog.tmp";
+static constexpr uint32_t CATALOG_SYNC_MS = 10ul * 60ul * 1000ul;   // höchstens so viel geht bei Stromausfall verloren
+
+static LogCatalogDay g_days[LOG_CATALOG_MAX];
+static uint16_t g_count = 0;
+static uint64_t g_bytes = 0;
+static bool     g_ready = false;
+static bool     g_complete = true;
+static bool     g_dirty = false;
+static bool     g_urgent = false;   // Tag dazu/weg -> beim nächsten Sync schreiben
+static uint32_t g_lastSaveMs = 0;
+
+uint32_t logCatalogKey(const String& day) {
+  if (day.length() != 10 || day.charAt(4) != '-' || day.charAt(7) != '-') return 0;
+  const uint32_t y = (uint32_t)day.substring(0, 4).toInt();
+  const uint32_t m = (uint32_t)day.substring(5, 7).toInt();
+  const uint32_t d = (uint32_t)day.substring(8, 10).toInt();
+  if (y < 1970 || m < 1 || m > 12 || d < 1 || d > 31) return 0;
+  return y * 10000u + m * 100u + d;
+}
+
+String logCatalogDayString(uint32_t key) {
+  char buf[32];
+  snprintf(buf, sizeof(buf), "%04u-%02u-%02u",
+           (unsigned)(key / 10000u), (unsigned)(key / 100u % 100u), (unsigned)(key % 100u));
+  return String(buf);
+}
+
+// Position des Tags bzw. Einfügeposition (aufsteigend sortiert)
+static uint16_t lowerBound(uint32_t key) {
+  uint16_t lo = 0, hi = g_count;
+  while (lo < hi) {
+    const uint16_t mid = lo + (hi - lo) / 2;
+    if (g_days[mid].day < key) lo = mid + 1;
+    else hi = mid;
+  }
+  return lo;
+}
+
+static LogCatalogDay* findDay(uint32_t key) {
+  const uint16_t i = lowerBound(key);
+  return (i < g_count && g_days[i].day == key) ? &g_days[i] : nullptr;
+}
+
+static LogCatalogDay* insertDay(uint32_t key) {
+  uint16_t i = lowerBound(key);
+  if (i < g_count && g_days[i].day == key) return &g_days[i];
+
+  if (g_count == LOG_CATALOG_MAX) {
+    // voll: ältesten Tag vergessen (liegt weiter auf der Karte)
+    if (i == 0) { g_complete = false; return nullptr; }
+    g_bytes -= g_days[0].bytes;
+    memmove(&g_days[0], &g_days[1], sizeof(LogCatalogDay) * (g_count - 1));
+    g_count--;
+    i--;
+    g_complete = false;
+  }
+  memmove(&g_days[i + 1], &g_days[i], sizeof(LogCatalogDay) * (g_count - i));
+  g_count++;
+  memset(&g_days[i], 0, sizeof(LogCatalogDay));
+  g_days[i].day = key;
+  g_urgent = true;
+  return &g_days[i];
+}
+
+static void removeAt(uint16_t i) {
+  g_bytes -= g_days[i].bytes;
+  memmove(&g_days[i], &g_days[i + 1], sizeof(LogCatalogDay) * (g_count - i - 1));
+  g_count--;
+  g_dirty = true;
+  g_urgent = true;
+}
+
+// ============================================================================
+// Tageswerte aus den Dateien (Neuaufbau / Abgleich nach Neustart)
+// ============================================================================
+static uint8_t extFormat(const String& base) {
+  if (base.endsWith(".csv")) return LOG_FMT_CSV;
+  if (base.endsWith(".bin")) return LOG_FMT_BIN;
+  if (base.endsWith(".gor")) return LOG_FMT_GOR;
+  return 0;
+}
+
+// .bin: Anzahl aus der Dateigröße, erster/letzter Record direkt
+static bool statBin(const String& day, LogCatalogDay& e) {
+  File f = SD.open(logPathForDay(day, ".bin"), FILE_READ);
+  if (!f) return false;
+  LogBinHeader h;
+  bool ok = logBinReadHeader(f, h);
+  if (ok) {
+    e.rows = logBinRecordCount(f, h);
+    e.first = e.last = 0;
+    if (e.rows) {
+      f.seek(h.header_size);
+      f.read((uint8_t*)&e.first, 4);
+      f.seek(h.header_size + (size_t)(e.rows - 1) * h.rec_size);
+      f.read((uint8_t*)&e.last, 4);
+    }
+  }
+  f.close();
+  return ok;
+}
+
+// .gor: nur die Blockheader
+static bool statGor(const String& day, LogCatalogDay& e) {
+  File f = SD.open(logPathForDay(day, ".gor"), FILE_READ);
+  if (!f) return false;
+  const uint32_t blocks = logGorBlockCount(f);
+  e.rows = e.first = e.last = 0;
+  for (uint32_t b = 0; b < blocks; b++) {
+    LogGorBlockHeader h;
+    f.seek((size_t)b * LOG_GOR_BLOCK_SIZE);
+    if (f.read((uint8_t*)&h, sizeof(h)) != sizeof(h)) break;
+    if (h.magic != LOG_GOR_MAGIC || !h.count) continue;
+    if (!e.first) e.first = h.first_epoch;
+    e.last = h.last_epoch;
+    e.rows += h.count;
+  }
+  f.close();
+  return true;
+}
+
+// .csv: Zeilen zählen; mit prev nur den Teil hinter dem bereits bekannten Stand
+static bool statCsv(const String& day, LogCatalogDay& e, const LogCatalogDay* prev) {
+  File f = SD.open(logPathForDay(day), FILE_READ);
+  if (!f) return false;
+  const uint32_t size = (uint32_t)f.size();
+
+  LogCsvReader rd(f);
+  bool crc = false;
+  bool firstIsData = false;
+  uint32_t dataStart = 0;
+  if (rd.next()) {
+    if (isDigit(rd.field(0)[0])) firstIsData = true;
+    else {
+      crc = rd.find(LOG_CSV_COL_CRC) >= 0;
+      dataStart = rd.offset();
+    }
+  }
+
+  e.rows = e.first = e.last = 0;
+  if (prev && prev->csv_bytes > dataStart && prev->csv_bytes <= size) {
+    e.rows = prev->rows;
+    e.first = prev->first;
+    e.last = prev->last;
+    rd.seek(prev->csv_bytes);
+  } else {
+    rd.seek(firstIsData ? 0 : dataStart);
+  }
+  rd.setCrc(crc);
+
+  while (rd.next()) {
+    uint32_t ep;
+    if (logCsvParseU32(rd.field(0), ep) != LOG_CSV_OK) continue;
+    if (!e.first) e.first = ep;
+    e.last = ep;
+    e.rows++;
+  }
+  f.close();
+  return true;
+}
+
+static void statDay(LogCatalogDay& e, const LogCatalogDay* prev) {
+  const String day = logCatalogDayString(e.day);
+  if ((e.formats & LOG_FMT_BIN) && statBin(day, e)) return;
+  if ((e.formats & LOG_FMT_GOR) && statGor(day, e)) return;
+  if (e.formats & LOG_FMT_CSV) statCsv(day, e, prev);
+}
+
+// Monatsarchiv: Tage direkt aus dem Inhaltsverzeichnis
+static void addArchive(File& f) {
+  LogArcToc toc;
+  if (!logArchiveReadToc(f, toc)) return;
+  for (uint8_t i = 0; i < LOG_ARC_DAYS; i++) {
+    const LogArcDay& d = toc.days[i];
+    if (d.kind == LOG_ARC_NONE) continue;
+    LogCatalogDay* e = insertDay(toc.month * 100u + i + 1u);
+    if (!e) continue;
+    e->bytes += d.length;
+    g_bytes += d.length;
+    e->formats |= LOG_CATALOG_ARC;
+    e->rows = d.rows;
+    e->first = d.first;
+    e->last = d.last;
+  }
+}
+
+static void rebuild() {
+  File dir = SD.open("/log");
+  if (!dir) return;
+
+  for (File f = dir.openNextFile(); f; f = dir.openNextFile()) {
+    if (!f.isDirectory()) {
+      String fn = String(f.name());
+      int slash = fn.lastIndexOf('/');
+      String base = (slash >= 0) ? fn.substring(slash + 1) : fn;
+      const uint32_t key = (base.length() == 14) ? logCatalogKey(base.substring(0, 10)) : 0;
+      const bool idx = base.endsWith(".idx") || base.endsWith(LOG_ENV_EXT);   // ohne eigenes Format
+      const uint8_t fmt = extFormat(base);
+      int y, m;
+      if (logArchiveParseName(base, y, m)) {
+        addArchive(f);
+      } else if (key && (fmt || idx)) {
+        LogCatalogDay* e = insertDay(key);
+        if (e) {
+          const uint32_t size = (uint32_t)f.size();
+          e->bytes += size;
+          g_bytes += size;
+          e->formats |= fmt;
+          if (fmt == LOG_FMT_CSV) e->csv_bytes = size;
+        }
+      }
+    }
+    f.close();
+  }
+  dir.close();
+
+  for (uint16_t i = 0; i < g_count; i++) statDay(g_days[i], nullptr);
+  g_dirty = true;
+  g_urgent = true;
+}
+
+// ============================================================================
+// Datei
+// ============================================================================
+static bool load(const char* path) {
+  if (!SD.exists(path)) return false;
+  File f = SD.open(path, FILE_READ);
+  if (!f) return false;
+
+  LogCatalogHeader h;
+  bool ok = f.read((uint8_t*)&h, sizeof(h)) == sizeof(h) &&
+            h.magic == LOG_CATALOG_MAGIC && h.version == LOG_CATALOG_VERSION &&
+            h.entry_size == sizeof(LogCatalogDay) && h.count <= LOG_CATALOG_MAX;
+  if (ok) {
+    const size_t n = sizeof(LogCatalogDay) * h.count;
+    ok = f.read((uint8_t*)g_days, n) == n && logCrc16((const uint8_t*)g_days, n) == h.crc;
+  }
+  f.close();
+  if (!ok) return false;
+
+  g_count = h.count;
+  g_bytes = 0;
+  for (uint16_t i = 0; i < g_count; i++) {
+    if (i && g_days[i].day <= g_days[i - 1].day) { g_count = 0; g_bytes = 0; return false; }
+    g_bytes += g_days[i].bytes;
+  }
+  g_complete = !(h.flags & 1);
+  return true;
+}
+
+static bool save() {
+  LogCatalogHeader h {};
+  h.magic = LOG_CATALOG_MAGIC;
+  h.version = LOG_CATALOG_VERSION;
+  h.flags = g_complete ? 0 : 1;
+  h.count = g_count;
+  h.entry_size = sizeof(LogCatalogDay);
+  const size_t n = sizeof(LogCatalogDay) * g_count;
+  h.crc = logCrc16((const uint8_t*)g_days, n);
+
+  // erst vollständig schreiben, dann austauschen -> es gibt immer eine gültige Datei
+  File f = SD.open(CATALOG_TMP, FILE_WRITE);
+  if (!f) return false;
+  const bool ok = f.write((const uint8_t*)&h, sizeof(h)) == sizeof(h) &&
+                  f.write((const uint8_t*)g_days, n) == n;
+  f.close();
+  if (!ok) return false;
+
+  SD.remove(CATALOG_PATH);
+  return SD.rename(CATALOG_TMP, CATALOG_PATH);
+}
+
+// ============================================================================
+// API
+// ============================================================================
+void logCatalogReset() {
+  g_count = 0;
+  g_bytes = 0;
+  g_ready = false;
+  g_complete = true;
+  g_dirty = false;
+  g_urgent = false;
+}
+
+void logCatalogBegin(bool rebuildAll) {
+  logCatalogReset();
+  const uint32_t t0 = millis();
+
+  const bool loaded = !rebuildAll && (load(CATALOG_PATH) || load(CATALOG_TMP));
+  if (!loaded) rebuild();
+  g_ready = true;
+  logCatalogSync(true);
+
+  Serial.printf("[logger] catalog %s: %u Tage, %lu kB (%lu ms)\n", loaded ? "geladen" : "neu aufgebaut",
+                (unsigned)g_count, (unsigned long)(g_bytes / 1024), (unsigned long)(millis() - t0));
+}
+
+void logCatalogRefresh(const String& day) {
+  const uint32_t key = logCatalogKey(day);
+  if (!g_ready || !key) return;
+
+  LogCatalogDay e {};
+  e.day = key;
+  static const char* const EXT[] = { ".csv", ".bin", ".gor", ".idx", LOG_ENV_EXT };
+  for (const char* ext : EXT) {
+    const String p = logPathForDay(day, ext);
+    if (!SD.exists(p)) continue;
+    File f = SD.open(p, FILE_READ);
+    if (!f) continue;
+    const uint32_t size = (uint32_t)f.size();
+    f.close();
+    e.bytes += size;
+    e.formats |= extFormat(p);
+    if (extFormat(p) == LOG_FMT_CSV) e.csv_bytes = size;
+  }
+
+  LogCatalogDay* cur = findDay(key);
+  if (!e.bytes) {
+    // archivierte Tage haben keine Einzeldateien mehr
+    if (cur && !(cur->formats & LOG_CATALOG_ARC)) removeAt((uint16_t)(cur - g_days));
+    return;
+  }
+  if (cur && cur->bytes == e.bytes) return;   // passt
+
+  statDay(e, cur);
+  if (!cur) cur = insertDay(key);
+  if (!cur) return;
+  g_bytes = g_bytes - cur->bytes + e.bytes;
+  *cur = e;
+  g_dirty = true;
+  g_urgent = true;
+}
+
+bool logCatalogReady()    { return g_ready; }
+bool logCatalogComplete() { return g_complete; }
+uint16_t logCatalogCount() { return g_count; }
+uint64_t logCatalogBytes() { return g_bytes; }
+
+void logCatalogAppend(const String& day, uint8_t formats, uint32_t rows, uint32_t first, uint32_t last,
+                      uint32_t bytes, uint32_t csvBytes) {
+  if (!g_ready) return;
+  LogCatalogDay* e = insertDay(logCatalogKey(day));
+  if (!e) return;
+
+  if (!e->first || first < e->first) e->first = first;
+  if (last > e->last) e->last = last;
+  e->rows += rows;
+  e->bytes += bytes;
+  e->csv_bytes += csvBytes;
+  e->formats |= formats;
+  g_bytes += bytes;
+  g_dirty = true;
+}
+
+void logCatalogRemove(const String& day) {
+  if (!g_ready) return;
+  LogCatalogDay* e = findDay(logCatalogKey(day));
+  if (e) removeAt((uint16_t)(e - g_days));
+}
+
+void logCatalogArchived(const String& day, uint32_t bytes) {
+  if (!g_ready) return;
+  LogCatalogDay* e = findDay(logCatalogKey(day));
+  if (!e) return;
+
+  g_bytes = g_bytes - e->bytes + bytes;
+  e->bytes = bytes;
+  e->csv_bytes = 0;
+  e->formats = LOG_CATALOG_ARC;
+  g_dirty = true;
+  g_urgent = true;
+}
+
+bool logCatalogGet(const String& day, LogCatalogDay& out) {
+  const LogCatalogDay* e = findDay(logCatalogKey(day));
+  if (!e) return false;
+  out = *e;
+  return true;
+}
+
+bool logCatalogOldest(LogCatalogDay& out) {
+  if (!g_count) return false;
+  out = g_days[0];
+  return true;
+}
+
+bool logCatalogAt(uint16_t i, LogCatalogDay& out) {
+  if (i >= g_count) return false;
+  out = g_days[i];
+  return true;
+}
+
+void logCatalogSync(bool force) {
+  if (!g_ready || !g_dirty) return;
+  if (!force && !g_urgent && (uint32_t)(millis() - g_lastSaveMs) < CATALOG_SYNC_MS) return;
+
+  if (save()) {
+    g_dirty = false;
+    g_urgent = false;
+  }
+  g_lastSaveMs = millis();
+}
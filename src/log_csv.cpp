@@ -0,0 +1,151 @@
+#include "log_csv.h"
+#include "log_format.h"
+#include <stdlib.h>
+
+LogCsvReader::LogCsvReader(File& f) : _f(f) {
+  _fileOff = (uint32_t)f.position();
+}
+
+bool LogCsvReader::fill() {
+  _fileOff += (uint32_t)_len;
+  _pos = 0;
+  const int r = _f.read((uint8_t*)_buf, sizeof(_buf));
+  _len = (r > 0) ? (size_t)r : 0;
+  return _len > 0;
+}
+
+void LogCsvReader::seek(uint32_t off) {
+  _f.seek(off);
+  _fileOff = off;
+  _len = 0;
+  _pos = 0;
+}
+
+void LogCsvReader::split(size_t len) {
+  _n = 0;
+  char* p = _line;
+  char* end = _line + len;
+
+  while (_n < MAX_FIELDS) {
+    while (p < end && *p == ' ') p++;
+    char* start = p;
+    while (p < end && *p != ',') p++;
+
+    char* e = p;
+    while (e > start && (e[-1] == ' ' || e[-1] == '\r')) e--;
+    const bool more = (p < end);
+    *e = '\0';
+    _fld[_n++] = start;
+
+    if (!more) break;
+    p++;
+  }
+}
+
+bool LogCsvReader::next() {
+  while (true) {
+    size_t len = 0;
+    bool any = false, overflow = false;
+
+    while (true) {
+      if (_pos == _len && !fill()) {
+        if (!any) return false;
+        break;   // letzte Zeile ohne '\n'
+      }
+      // Zeilenende im Puffer suchen, dann am Stück kopieren
+      const char* s = _buf + _pos;
+      const char* nl = (const char*)memchr(s, '\n', _len - _pos);
+      const size_t k = nl ? (size_t)(nl - s) : (_len - _pos);
+      any = true;
+
+      if (len + k < MAX_LINE) memcpy(_line + len, s, k);
+      else overflow = true;
+      len += k;
+      _pos += k;
+
+      if (nl) { _pos++; break; }
+    }
+
+    if (overflow) { _skipped++; continue; }
+    if (_crc && len && !logCsvLineCrcOk(_line, len)) { _crcErrors++; continue; }
+    split(len);
+    if (_n == 1 && !_fld[0][0]) continue;   // leere Zeile
+    return true;
+  }
+}
+
+int LogCsvReader::find(const char* name) const {
+  for (uint8_t i = 0; i < _n; i++) if (strcmp(_fld[i], name) == 0) return i;
+  return -1;
+}
+
+// ============================================================================
+// Zahlen
+// ============================================================================
+LogCsvField logCsvParseU32(const char* s, uint32_t& out) {
+  if (!*s) return LOG_CSV_EMPTY;
+  uint64_t v = 0;
+  const char* p = s;
+  for (; *p >= '0' && *p <= '9'; p++) {
+    v = v * 10 + (uint64_t)(*p - '0');
+    if (v > 0xFFFFFFFFull) return LOG_CSV_BAD;
+  }
+  if (p == s || *p) return LOG_CSV_BAD;
+  out = (uint32_t)v;
+  return LOG_CSV_OK;
+}
+
+LogCsvField logCsvParseFloat(const char* s, float& out) {
+  static const double POW10[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9 };
+  if (!*s) return LOG_CSV_EMPTY;
+
+  // Schnellpfad: so schreibt der Logger ("%.2f" bzw. Ganzzahl)
+  const char* p = s;
+  const bool neg = (*p == '-');
+  if (neg || *p == '+') p++;
+
+  uint32_t m = 0;
+  int digits = 0, frac = 0;
+  bool fast = true;
+  for (; *p >= '0' && *p <= '9'; p++, digits++) m = m * 10 + (uint32_t)(*p - '0');
+  if (*p == '.') {
+    for (p++; *p >= '0' && *p <= '9'; p++, digits++, frac++) m = m * 10 + (uint32_t)(*p - '0');
+  }
+  if (digits == 0 || digits > 9 || *p) fast = false;
+
+  if (fast) {
+    const double v = (double)m / POW10[frac];
+    out = (float)(neg ? -v : v);
+    return LOG_CSV_OK;
+  }
+
+  // Exponent, nan, sehr lange Zahlen ...
+  char* end = nullptr;
+  const float v = strtof(s, &end);
+  if (end == s || *end) return LOG_CSV_BAD;
+  out = v;
+  return LOG_CSV_OK;
+}
+
+// ============================================================================
+// Prüfsumme
+// ============================================================================
+// letztes Feld = CRC-16 (hex) über alles vor dem letzten ','
+bool logCsvLineCrcOk(const char* line, size_t len) {
+  while (len && line[len - 1] == '\r') len--;
+  size_t comma = len;
+  while (comma && line[comma - 1] != ',') comma--;
+  if (!comma || len - comma != 4) return false;
+
+  uint16_t want = 0;
+  for (size_t i = comma; i < len; i++) {
+    const char c = line[i];
+    uint8_t d;
+    if (c >= '0' && c <= '9') d = (uint8_t)(c - '0');
+    else if (c >= 'A' && c <= 'F') d = (uint8_t)(c - 'A' + 10);
+    else if (c >= 'a' && c <= 'f') d = (uint8_t)(c - 'a' + 10);
+    else return false;
+    want = (uint16_t)((want << 4) | d);
+  }
+  return logCrc16((const uint8_t*)line, comma - 1) == want;
+}
@@ -0,0 +1,211 @@
+#include "log_flash.h"
+#include <LittleFS.h>
+
+static constexpr uint32_t FLASH_META_EST = 64;   // Metadaten-Eintrag je Schreibvorgang (Schätzung)
+static constexpr uint8_t  FLASH_CHUNK    = 32;   // Records je Schreibvorgang (= Schreibpuffer des Loggers)
+
+static LogFlashSeg   g_segs[LOG_FLASH_MAX_SEGS];   // aufsteigend nach seq
+static uint8_t       g_count = 0;
+static uint8_t       g_max = 0;
+static bool          g_active = false;
+static LogFlashStats g_stats;
+
+static String segPath(uint32_t seq) {
+  char buf[32];
+  snprintf(buf, sizeof(buf), "%s/%08lu.bin", LOG_FLASH_DIR, (unsigned long)seq);
+  return String(buf);
+}
+
+// "NNNNNNNN.bin" -> seq
+static bool parseSegName(const String& base, uint32_t& seq) {
+  if (base.length() != 12 || !base.endsWith(".bin")) return false;
+  for (int i = 0; i < 8; i++) if (!isDigit(base.charAt(i))) return false;
+  seq = (uint32_t)strtoul(base.c_str(), nullptr, 10);
+  return true;
+}
+
+// Header + erster/letzter Record; kaputte Segmente (Header angerissen) -> false
+static bool scanSeg(File& f, LogFlashSeg& s) {
+  LogBinHeader h;
+  if (!logBinReadHeader(f, h)) return false;
+  s.mask = h.mask;
+  s.first = s.last = 0;
+  const uint32_t n = logBinRecordCount(f, h);
+  s.records = (uint16_t)n;
+  s.bytes = h.header_size + n * h.rec_size;
+  if (s.bytes != (uint32_t)f.size()) s.bytes = LOG_FLASH_SEG_BYTES;   // Rest nicht auf Record-Raster
+  if (!n) return true;
+  f.seek(h.header_size);
+  f.read((uint8_t*)&s.first, 4);
+  f.seek(h.header_size + (n - 1) * h.rec_size);
+  f.read((uint8_t*)&s.last, 4);
+  return true;
+}
+
+static void dropOldest() {
+  if (!g_count) return;
+  LittleFS.remove(segPath(g_segs[0].seq));
+  for (uint8_t i = 1; i < g_count; i++) g_segs[i - 1] = g_segs[i];
+  g_count--;
+  g_stats.wraps++;
+}
+
+bool logFlashBegin(uint32_t budgetBytes) {
+  g_active = false;
+  g_count = 0;
+  if (!LittleFS.exists(LOG_FLASH_DIR)) LittleFS.mkdir(LOG_FLASH_DIR);
+
+  File dir = LittleFS.open(LOG_FLASH_DIR);
+  uint32_t own = 0;
+  if (dir && dir.isDirectory()) {
+    File f;
+    while ((f = dir.openNextFile())) {
+      const String name = f.name();
+      const int slash = name.lastIndexOf('/');
+      const String base = slash >= 0 ? name.substring(slash + 1) : name;
+      const uint32_t size = (uint32_t)f.size();
+      LogFlashSeg s;
+      uint32_t seq;
+      const bool ok = !f.isDirectory() && parseSegName(base, seq) && scanSeg(f, s);
+      f.close();
+      if (!ok) {
+        LittleFS.remove(String(LOG_FLASH_DIR) + "/" + base);
+        continue;
+      }
+      s.seq = seq;
+      own += size;
+      // einsortieren; mehr als passen -> ältestes fällt weg
+      uint8_t i = g_count;
+      if (g_count == LOG_FLASH_MAX_SEGS) {
+        if (seq < g_segs[0].seq) { LittleFS.remove(segPath(seq)); continue; }
+        dropOldest();
+        i = g_count;
+      }
+      while (i > 0 && g_segs[i - 1].seq > seq) { g_segs[i] = g_segs[i - 1]; i--; }
+      g_segs[i] = s;
+      g_count++;
+    }
+  }
+  if (dir) dir.close();
+
+  // Budget: höchstens, was frei ist (eigene Segmente zählen als frei), abzüglich Reserve
+  const uint64_t total = LittleFS.totalBytes();
+  const uint64_t used = LittleFS.usedBytes();
+  const uint64_t avail = total > used + LOG_FLASH_RESERVE ? total - used - LOG_FLASH_RESERVE + own : own;
+  if (budgetBytes > avail) budgetBytes = (uint32_t)avail;
+  uint32_t maxSegs = budgetBytes / LOG_FLASH_SEG_BYTES;
+  if (maxSegs > LOG_FLASH_MAX_SEGS) maxSegs = LOG_FLASH_MAX_SEGS;
+  if (maxSegs < 2) {
+    Serial.printf("[logger] Flash-Ring: zu wenig Platz (%lu kB frei)\n", (unsigned long)(avail / 1024));
+    return false;
+  }
+  g_max = (uint8_t)maxSegs;
+  while (g_count > g_max) dropOldest();
+
+  g_stats = LogFlashStats();
+  g_active = true;
+  Serial.printf("[logger] Flash-Ring aktiv: %u/%u Segmente à %lu kB\n", g_count, g_max,
+                (unsigned long)(LOG_FLASH_SEG_BYTES / 1024));
+  return true;
+}
+
+void logFlashEnd() {
+  g_active = false;
+}
+
+bool logFlashActive() {
+  return g_active;
+}
+
+static bool newSegment(uint32_t mask, uint32_t epoch) {
+  if (g_count >= g_max) dropOldest();
+  LogFlashSeg s;
+  s.seq = g_count ? g_segs[g_count - 1].seq + 1 : 1;
+  s.mask = mask;
+
+  LogBinHeader h;
+  logBinInitHeader(h, mask, epoch);
+  File f = LittleFS.open(segPath(s.seq), FILE_WRITE);
+  if (!f) return false;
+  const bool ok = f.write((const uint8_t*)&h, sizeof(h)) == sizeof(h);
+  f.close();
+  if (!ok) return false;
+
+  s.bytes = sizeof(h);
+  g_segs[g_count++] = s;
+  g_stats.flashBytes += sizeof(h) + FLASH_META_EST;
+  return true;
+}
+
+bool logFlashAppend(uint32_t metricMask, const LogSample* rows, uint8_t n) {
+  if (!g_active) return false;
+
+  LogBinHeader h;
+  logBinInitHeader(h, metricMask, 0);
+  uint8_t done = 0;
+  while (done < n) {
+    LogFlashSeg* cur = g_count ? &g_segs[g_count - 1] : nullptr;
+    if (!cur || cur->mask != metricMask || cur->bytes + h.rec_size > LOG_FLASH_SEG_BYTES ||
+        (cur->last && rows[done].epoch < cur->last)) {
+      if (!newSegment(metricMask, rows[done].epoch)) return false;
+      continue;
+    }
+
+    uint32_t k = (LOG_FLASH_SEG_BYTES - cur->bytes) / h.rec_size;
+    if (k > (uint32_t)(n - done)) k = n - done;
+    // nur aufsteigend innerhalb eines Segments
+    uint32_t j = 1;
+    while (j < k && rows[done + j].epoch >= rows[done + j - 1].epoch) j++;
+    k = j;
+
+    uint8_t buf[FLASH_CHUNK * LOG_BIN_MAX_REC];
+    if (k > FLASH_CHUNK) k = FLASH_CHUNK;
+    size_t len = 0;
+    for (uint32_t r = 0; r < k; r++) len += logBinEncode(h, rows[done + r], buf + len);
+
+    File f = LittleFS.open(segPath(cur->seq), FILE_APPEND);
+    if (!f) return false;
+    const size_t w = f.write(buf, len);
+    f.close();
+    if (w != len) return false;
+
+    // angefangener Block wird kopiert, dazu Daten + Metadaten
+    g_stats.flashBytes += (cur->bytes % LOG_FLASH_BLOCK) + len + FLASH_META_EST;
+    g_stats.written += len;
+    g_stats.appends++;
+    if (!cur->first) cur->first = rows[done].epoch;
+    cur->last = rows[done + k - 1].epoch;
+    cur->bytes += len;
+    cur->records += (uint16_t)k;
+    done += k;
+  }
+  return true;
+}
+
+uint8_t logFlashSegmentCount() {
+  return g_count;
+}
+
+bool logFlashSegmentAt(uint8_t i, LogFlashSeg& out) {
+  if (i >= g_count) return false;
+  out = g_segs[i];
+  return true;
+}
+
+File logFlashOpen(const LogFlashSeg& s) {
+  return LittleFS.open(segPath(s.seq), FILE_READ);
+}
+
+LogFlashStats logFlashGetStats() {
+  LogFlashStats s = g_stats;
+  s.active = g_active;
+  s.segments = g_count;
+  s.maxSegments = g_max;
+  s.records = 0;
+  s.bytes = 0;
+  for (uint8_t i = 0; i < g_count; i++) {
+    s.records += g_segs[i].records;
+    s.bytes += g_segs[i].bytes;
+  }
+  return s;
+}
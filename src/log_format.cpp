@@ -0,0 +1,152 @@
+#include "log_format.h"
+#include <time.h>
+
+const LogMetricDef LOG_METRICS[LOG_METRIC_COUNT] = {
+  { LOG_TEMP,  "temp",  "temp_c"    },
+  { LOG_HUM,   "hum",   "hum_rh"    },
+  { LOG_PRESS, "press", "press_hpa" },
+  { LOG_CO2,   "co2",   "co2_ppm"   },
+};
+
+int logMetricIndexByKey(const String& key) {
+  for (int i = 0; i < LOG_METRIC_COUNT; i++) if (key == LOG_METRICS[i].key) return i;
+  return -1;
+}
+
+int logMetricIndexByCol(const String& col) {
+  for (int i = 0; i < LOG_METRIC_COUNT; i++) if (col == LOG_METRICS[i].col) return i;
+  return -1;
+}
+
+uint16_t logCrc16(const uint8_t* p, size_t n, uint16_t crc) {
+  while (n--) {
+    crc ^= (uint16_t)(*p++) << 8;
+    for (int b = 0; b < 8; b++) crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+  }
+  return crc;
+}
+
+String logDayStringFromEpoch(time_t t) {
+  struct tm tmLocal{};
+  localtime_r(&t, &tmLocal);
+  char buf[36];   // drei volle int (der Compiler kennt den Wertebereich von tm nicht)
+  snprintf(buf, sizeof(buf), "%04d-%02d-%02d",
+           tmLocal.tm_year + 1900, tmLocal.tm_mon + 1, tmLocal.tm_mday);
+  return String(buf);
+}
+
+String logPathForDay(const String& day, const char* ext) {
+  return String("/log/") + day + ext;
+}
+
+// ============================================================================
+// Binärformat
+// ============================================================================
+static uint8_t maskColumns(uint32_t mask) {
+  uint8_t n = 0;
+  for (int i = 0; i < LOG_METRIC_COUNT; i++) if (mask & LOG_METRICS[i].bit) n++;
+  return n;
+}
+
+static uint16_t recSize(uint8_t version, uint32_t mask) {
+  return (uint16_t)(4 + 4 * maskColumns(mask) + (version >= 2 ? 2 : 0));
+}
+
+void logBinInitHeader(LogBinHeader& h, uint32_t mask, uint32_t dayStart) {
+  h.magic       = LOG_BIN_MAGIC;
+  h.version     = LOG_BIN_VERSION;
+  h.header_size = sizeof(LogBinHeader);
+  h.mask        = mask;
+  h.rec_size    = recSize(LOG_BIN_VERSION, mask);
+  h.day_start   = dayStart;
+}
+
+bool logBinReadHeader(File& f, LogBinHeader& h, uint32_t base) {
+  f.seek(base);
+  if (f.read((uint8_t*)&h, sizeof(h)) != sizeof(h)) return false;
+  if (h.magic != LOG_BIN_MAGIC) return false;
+  if (h.version < 1 || h.version > LOG_BIN_VERSION) return false;
+  if (h.header_size < sizeof(LogBinHeader)) return false;
+  if (h.rec_size < 4 || h.rec_size > LOG_BIN_MAX_REC) return false;
+  if (h.rec_size != recSize(h.version, h.mask)) return false;
+  f.seek(base + h.header_size);
+  return true;
+}
+
+static uint32_t epochAt(File& f, const LogBinHeader& h, uint32_t base, uint32_t i) {
+  uint32_t e = 0;
+  f.seek(base + h.header_size + (size_t)i * h.rec_size);
+  if (f.read((uint8_t*)&e, 4) != 4) return 0;
+  return e;
+}
+
+uint32_t logBinRecordCount(File& f, const LogBinHeader& h, uint32_t base, uint32_t len) {
+  if (!len) {
+    const size_t sz = f.size();
+    len = (sz > base) ? (uint32_t)(sz - base) : 0;
+  }
+  if (len <= h.header_size) return 0;
+  // ein angerissener letzter Record wird ignoriert
+  const uint32_t n = (len - h.header_size) / h.rec_size;
+  if (!n || epochAt(f, h, base, n - 1) != 0) return n;
+
+  // vorbelegter Rest: erster leerer Record
+  uint32_t lo = 0, hi = n - 1;
+  while (lo < hi) {
+    const uint32_t mid = lo + (hi - lo) / 2;
+    if (epochAt(f, h, base, mid) != 0) lo = mid + 1;
+    else hi = mid;
+  }
+  return lo;
+}
+
+size_t logBinEncode(const LogBinHeader& h, const LogSample& s, uint8_t* out) {
+  size_t p = 0;
+  memcpy(out + p, &s.epoch, 4); p += 4;
+  for (int i = 0; i < LOG_METRIC_COUNT; i++) {
+    if (!(h.mask & LOG_METRICS[i].bit)) continue;
+    memcpy(out + p, &s.v[i], 4); p += 4;
+  }
+  if (h.version >= 2) {
+    const uint16_t crc = logCrc16(out, p);
+    memcpy(out + p, &crc, 2); p += 2;
+  }
+  return p;
+}
+
+bool logBinRecordOk(const LogBinHeader& h, const uint8_t* rec) {
+  if (h.version < 2) return true;
+  uint16_t crc;
+  memcpy(&crc, rec + h.rec_size - 2, 2);
+  return crc == logCrc16(rec, h.rec_size - 2);
+}
+
+void logBinDecode(const LogBinHeader& h, const uint8_t* rec, LogSample& s) {
+  size_t p = 0;
+  memcpy(&s.epoch, rec + p, 4); p += 4;
+  for (int i = 0; i < LOG_METRIC_COUNT; i++) {
+    if (!(h.mask & LOG_METRICS[i].bit)) { s.v[i] = NAN; continue; }
+    memcpy(&s.v[i], rec + p, 4); p += 4;
+  }
+}
+
+int logBinColumn(const LogBinHeader& h, int metricIdx) {
+  if (metricIdx < 0 || metricIdx >= LOG_METRIC_COUNT) return -1;
+  if (!(h.mask & LOG_METRICS[metricIdx].bit)) return -1;
+  int col = 0;
+  for (int i = 0; i < metricIdx; i++) if (h.mask & LOG_METRICS[i].bit) col++;
+  return col;
+}
+
+uint32_t logBinLowerBound(File& f, const LogBinHeader& h, uint32_t count, uint32_t ep, uint32_t base) {
+  uint32_t lo = 0, hi = count;
+  while (lo < hi) {
+    uint32_t mid = lo + (hi - lo) / 2;
+    uint32_t e = 0;
+    f.seek(base + h.header_size + (size_t)mid * h.rec_size);
+    if (f.read((uint8_t*)&e, 4) != 4) { hi = mid; continue; }
+    if (e < ep) lo = mid + 1;
+    else hi = mid;
+  }
+  return lo;
+}
@@ -0,0 +1,225 @@
+#include "log_gorilla.h"
+
+static constexpr uint16_t PAYLOAD_BITS = LOG_GOR_PAYLOAD * 8;
+
+static uint32_t floatBits(float f) {
+  uint32_t u;
+  memcpy(&u, &f, 4);
+  return u;
+}
+
+static float bitsFloat(uint32_t u) {
+  float f;
+  memcpy(&f, &u, 4);
+  return f;
+}
+
+// ============================================================================
+// Encoder
+// ============================================================================
+void LogGorEncoder::reset(uint32_t mask) {
+  memset(_blk, 0, sizeof(_blk));
+  LogGorBlockHeader& h = hdr();
+  h.magic = LOG_GOR_MAGIC;
+  h.mask = mask;
+  for (int i = 0; i < LOG_METRIC_COUNT; i++) { h.min[i] = NAN; h.max[i] = NAN; }
+  memset(&_st, 0, sizeof(_st));
+}
+
+bool LogGorEncoder::put(uint32_t v, uint8_t n) {
+  if (_st.bits + n > PAYLOAD_BITS) return false;
+  uint8_t* p = _blk + sizeof(LogGorBlockHeader);
+  while (n--) {
+    if ((v >> n) & 1u) p[_st.bits >> 3] |= (uint8_t)(0x80u >> (_st.bits & 7));
+    _st.bits++;
+  }
+  return true;
+}
+
+bool LogGorEncoder::putValue(int i, uint32_t bits) {
+  const uint32_t x = bits ^ _st.prev[i];
+  _st.prev[i] = bits;
+  if (x == 0) return put(0, 1);
+
+  const uint8_t lead  = (uint8_t)__builtin_clz(x);
+  const uint8_t trail = (uint8_t)__builtin_ctz(x);
+
+  // passt in das Fenster des Vorgängers -> nur die signifikanten Bits
+  if (_st.lead[i] + _st.trail[i] > 0 && lead >= _st.lead[i] && trail >= _st.trail[i]) {
+    return put(0x2, 2) && put(x >> _st.trail[i], (uint8_t)(32 - _st.lead[i] - _st.trail[i]));
+  }
+
+  const uint8_t sig = (uint8_t)(32 - lead - trail);
+  _st.lead[i] = lead;
+  _st.trail[i] = trail;
+  return put(0x3, 2) && put(lead, 5) && put((uint32_t)(sig - 1), 5) && put(x >> trail, sig);
+}
+
+bool LogGorEncoder::add(const LogSample& s) {
+  LogGorBlockHeader& h = hdr();
+  if (h.count == 0xFFFF) return false;
+  if (h.count && s.epoch < _st.prevEpoch) return false;   // Zeit rückwärts -> neuer Block
+
+  const State saved = _st;
+  bool ok = true;
+
+  if (h.count == 0) {
+    for (int i = 0; i < LOG_METRIC_COUNT && ok; i++) {
+      if (!(h.mask & LOG_METRICS[i].bit)) continue;
+      _st.prev[i] = floatBits(s.v[i]);
+      ok = put(_st.prev[i], 32);
+    }
+  } else {
+    const int32_t delta = (int32_t)(s.epoch - _st.prevEpoch);
+    const int32_t dod = delta - _st.prevDelta;
+    if (dod == 0)                        ok = put(0, 1);
+    else if (dod >= -63 && dod <= 64)     ok = put(0x2, 2) && put((uint32_t)(dod + 63), 7);
+    else if (dod >= -255 && dod <= 256)   ok = put(0x6, 3) && put((uint32_t)(dod + 255), 9);
+    else if (dod >= -2047 && dod <= 2048) ok = put(0xE, 4) && put((uint32_t)(dod + 2047), 12);
+    else                                  ok = put(0xF, 4) && put((uint32_t)dod, 32);
+    _st.prevDelta = delta;
+
+    for (int i = 0; i < LOG_METRIC_COUNT && ok; i++) {
+      if (!(h.mask & LOG_METRICS[i].bit)) continue;
+      ok = putValue(i, floatBits(s.v[i]));
+    }
+  }
+
+  if (!ok) {
+    // Block voll: angefangene Bits wieder löschen, Zustand zurück
+    uint8_t* p = _blk + sizeof(LogGorBlockHeader);
+    for (uint16_t b = saved.bits; b < _st.bits && b < PAYLOAD_BITS; b++) p[b >> 3] &= (uint8_t)~(0x80u >> (b & 7));
+    _st = saved;
+    return false;
+  }
+
+  _st.prevEpoch = s.epoch;
+  if (h.count == 0) h.first_epoch = s.epoch;
+  h.last_epoch = s.epoch;
+  h.count++;
+  h.bits = _st.bits;
+  for (int i = 0; i < LOG_METRIC_COUNT; i++) {
+    const float v = s.v[i];
+    if (!(h.mask & LOG_METRICS[i].bit) || isnan(v)) continue;
+    if (isnan(h.min[i]) || v < h.min[i]) h.min[i] = v;
+    if (isnan(h.max[i]) || v > h.max[i]) h.max[i] = v;
+  }
+  return true;
+}
+
+bool LogGorEncoder::resume(const uint8_t* block) {
+  LogGorDecoder dec;
+  if (!dec.begin(block)) return false;
+
+  // gleiche Eingabe -> gleiche Bits: Block einfach neu kodieren
+  reset(dec.header().mask);
+  LogSample s;
+  while (dec.next(s)) {
+    if (!add(s)) return false;
+  }
+  return hdr().count == dec.header().count;
+}
+
+// ============================================================================
+// Decoder
+// ============================================================================
+bool LogGorDecoder::begin(const uint8_t* block) {
+  memcpy(&_h, block, sizeof(_h));
+  if (_h.magic != LOG_GOR_MAGIC || _h.bits > PAYLOAD_BITS) return false;
+  _p = block + sizeof(LogGorBlockHeader);
+  _pos = 0;
+  _i = 0;
+  _prevEpoch = 0;
+  _prevDelta = 0;
+  memset(_prev, 0, sizeof(_prev));
+  memset(_lead, 0, sizeof(_lead));
+  memset(_trail, 0, sizeof(_trail));
+  return true;
+}
+
+bool LogGorDecoder::get(uint8_t n, uint32_t& v) {
+  if (_pos + n > _h.bits) return false;
+  v = 0;
+  while (n--) {
+    v = (v << 1) | ((_p[_pos >> 3] >> (7 - (_pos & 7))) & 1u);
+    _pos++;
+  }
+  return true;
+}
+
+bool LogGorDecoder::next(LogSample& s) {
+  if (_i >= _h.count) return false;
+  uint32_t b = 0;
+
+  if (_i == 0) {
+    s.epoch = _h.first_epoch;
+    for (int i = 0; i < LOG_METRIC_COUNT; i++) {
+      if (!(_h.mask & LOG_METRICS[i].bit)) { s.v[i] = NAN; continue; }
+      if (!get(32, _prev[i])) return false;
+      s.v[i] = bitsFloat(_prev[i]);
+    }
+  } else {
+    // Delta-of-Delta: 0 | 10+7 | 110+9 | 1110+12 | 1111+32
+    uint8_t ones = 0;
+    while (ones < 4) {
+      if (!get(1, b)) return false;
+      if (!b) break;
+      ones++;
+    }
+    int32_t dod = 0;
+    switch (ones) {
+      case 0: break;
+      case 1: if (!get(7, b))  return false; dod = (int32_t)b - 63;   break;
+      case 2: if (!get(9, b))  return false; dod = (int32_t)b - 255;  break;
+      case 3: if (!get(12, b)) return false; dod = (int32_t)b - 2047; break;
+      default: if (!get(32, b)) return false; dod = (int32_t)b;       break;
+    }
+    _prevDelta += dod;
+    s.epoch = _prevEpoch + (uint32_t)_prevDelta;
+
+    for (int i = 0; i < LOG_METRIC_COUNT; i++) {
+      if (!(_h.mask & LOG_METRICS[i].bit)) { s.v[i] = NAN; continue; }
+      if (!get(1, b)) return false;
+      if (b) {
+        uint32_t x = 0, ctl = 0;
+        if (!get(1, ctl)) return false;
+        if (ctl) {
+          uint32_t lead = 0, sig = 0;
+          if (!get(5, lead) || !get(5, sig)) return false;
+          sig += 1;
+          _lead[i] = (uint8_t)lead;
+          _trail[i] = (uint8_t)(32 - lead - sig);
+        }
+        if (!get((uint8_t)(32 - _lead[i] - _trail[i]), x)) return false;
+        _prev[i] ^= x << _trail[i];
+      }
+      s.v[i] = bitsFloat(_prev[i]);
+    }
+  }
+
+  _prevEpoch = s.epoch;
+  _i++;
+  return true;
+}
+
+// ============================================================================
+// Logisches Dateiende
+// ============================================================================
+static bool blockUsed(File& f, uint32_t b) {
+  uint32_t magic = 0;
+  f.seek((size_t)b * LOG_GOR_BLOCK_SIZE);
+  return f.read((uint8_t*)&magic, 4) == 4 && magic == LOG_GOR_MAGIC;
+}
+
+uint32_t logGorBlockCount(File& f) {
+  const uint32_t n = (uint32_t)f.size() / LOG_GOR_BLOCK_SIZE;
+  if (!n || blockUsed(f, n - 1)) return n;
+
+  uint32_t lo = 0, hi = n - 1;
+  while (lo < hi) {
+    const uint32_t mid = lo + (hi - lo) / 2;
+    if (blockUsed(f, mid)) lo = mid + 1;
+    else hi = mid;
+  }
+  return lo;
+}
@@ -0,0 +1,157 @@
+#include "log_index.h"
+#include "log_format.h"
+#include <SD.h>
+
+// kleinere CSV-Dateien werden ohne Index gelesen (ein paar Blöcke)
+static constexpr uint32_t LOG_INDEX_MIN_CSV = 4096;
+
+static String idxPath(const String& day) {
+  return logPathForDay(day, ".idx");
+}
+
+// epoch am Zeilenanfang lesen (f steht am Zeilenanfang)
+static bool readLineEpoch(File& f, uint32_t& ep) {
+  char b[12];
+  const size_t n = f.read((uint8_t*)b, sizeof(b));
+  ep = 0;
+  size_t i = 0;
+  for (; i < n && isDigit(b[i]); i++) ep = ep * 10 + (uint32_t)(b[i] - '0');
+  return i > 0 && i < n && (b[i] == ',' || b[i] == '\r' || b[i] == '\n');
+}
+
+bool logIndexLast(const String& day, LogIndexEntry& last) {
+  const String p = idxPath(day);
+  if (!SD.exists(p)) return false;
+  File f = SD.open(p, FILE_READ);
+  if (!f) return false;
+
+  const size_t sz = f.size();
+  bool ok = false;
+  if (sz >= sizeof(LogIndexEntry) && (sz % sizeof(LogIndexEntry)) == 0) {
+    f.seek(sz - sizeof(LogIndexEntry));
+    ok = f.read((uint8_t*)&last, sizeof(last)) == sizeof(last);
+  }
+  f.close();
+  return ok;
+}
+
+bool logIndexAppend(const String& day, const LogIndexEntry& e) {
+  File f = SD.open(idxPath(day), FILE_APPEND);
+  if (!f) return false;
+  const bool ok = f.write((const uint8_t*)&e, sizeof(e)) == sizeof(e);
+  f.close();
+  return ok;
+}
+
+bool logIndexValid(const String& day) {
+  LogIndexEntry last;
+  if (!logIndexLast(day, last)) return false;
+
+  File f = SD.open(logPathForDay(day), FILE_READ);
+  if (!f) return false;
+
+  bool ok = false;
+  if (last.offset < f.size()) {
+    // Eintrag muss auf einen Zeilenanfang zeigen ...
+    bool lineStart = (last.offset == 0);
+    if (!lineStart) {
+      f.seek(last.offset - 1);
+      lineStart = (f.read() == '\n');
+    }
+    // ... und die Zeile muss genau diesen Zeitstempel tragen
+    uint32_t ep = 0;
+    ok = lineStart && readLineEpoch(f, ep) && ep == last.epoch;
+  }
+  f.close();
+  return ok;
+}
+
+bool logIndexRebuild(const String& day) {
+  File in = SD.open(logPathForDay(day), FILE_READ);
+  if (!in) return false;
+  File out = SD.open(idxPath(day), FILE_WRITE);
+  if (!out) { in.close(); return false; }
+
+  // 0 = Zeilenanfang, 1 = epoch lesen, 2 = Rest der Zeile überspringen
+  uint8_t  state = 0;
+  uint32_t ep = 0, lineOff = 0, next = 0, pos = 0, entries = 0;
+
+  uint8_t buf[512];
+  size_t n;
+  while ((n = in.read(buf, sizeof(buf))) > 0) {
+    for (size_t i = 0; i < n; i++, pos++) {
+      const char c = (char)buf[i];
+      if (state == 0) {
+        if (isDigit(c)) { ep = (uint32_t)(c - '0'); lineOff = pos; state = 1; }
+        else if (c != '\n') state = 2;
+      } else if (state == 1) {
+        if (isDigit(c)) { ep = ep * 10 + (uint32_t)(c - '0'); continue; }
+        if (c == ',' || c == '\r' || c == '\n') {
+          if (ep >= next) {
+            LogIndexEntry e { ep, lineOff };
+            out.write((const uint8_t*)&e, sizeof(e));
+            next = ep + LOG_INDEX_STEP_SEC;
+            entries++;
+          }
+        }
+        state = (c == '\n') ? 0 : 2;
+      } else if (c == '\n') {
+        state = 0;
+      }
+    }
+  }
+
+  in.close();
+  out.close();
+  Serial.printf("[logger] index rebuilt: %s (%u entries)\n", day.c_str(), (unsigned)entries);
+  return true;
+}
+
+uint32_t logIndexSeekOffset(const String& day, uint32_t ep) {
+  const String p = idxPath(day);
+  if (!SD.exists(p)) return 0;
+  File f = SD.open(p, FILE_READ);
+  if (!f) return 0;
+
+  // letzter Eintrag mit epoch <= ep
+  const uint32_t count = f.size() / sizeof(LogIndexEntry);
+  uint32_t lo = 0, hi = count;
+  while (lo < hi) {
+    const uint32_t mid = lo + (hi - lo) / 2;
+    LogIndexEntry e {};
+    f.seek(mid * sizeof(LogIndexEntry));
+    if (f.read((uint8_t*)&e, sizeof(e)) != sizeof(e)) { hi = mid; continue; }
+    if (e.epoch <= ep) lo = mid + 1;
+    else hi = mid;
+  }
+
+  uint32_t off = 0;
+  if (lo > 0) {
+    LogIndexEntry e {};
+    f.seek((lo - 1) * sizeof(LogIndexEntry));
+    if (f.read((uint8_t*)&e, sizeof(e)) == sizeof(e)) off = e.offset;
+  }
+  f.close();
+  return off;
+}
+
+void logIndexEnsure(const String& day) {
+  const String csvPath = logPathForDay(day);
+  const String p = idxPath(day);
+
+  if (!SD.exists(csvPath)) {
+    if (SD.exists(p)) SD.remove(p);
+    return;
+  }
+
+  if (SD.exists(p)) {
+    if (!logIndexValid(day)) logIndexRebuild(day);
+    return;
+  }
+
+  File f = SD.open(csvPath, FILE_READ);
+  if (!f) return;
+  const size_t sz = f.size();
+  f.close();
+  if (sz >= LOG_INDEX_MIN_CSV) logIndexRebuild(day);
+}
@@ -0,0 +1,62 @@
+#include "log_interp.h"
+
+void LogInterp::begin(uint8_t cols) {
+  _cols = cols < 1 ? 1 : cols > LOG_INTERP_COLS ? LOG_INTERP_COLS : cols;
+  _head = 0;
+  _n = 0;
+  _final = false;
+  _filled = 0;
+  for (uint8_t c = 0; c < LOG_INTERP_COLS; c++) _has[c] = false;
+}
+
+void LogInterp::push(uint32_t ep, const float* vals) {
+  // ohne pop() dazwischen die älteste Zeile so freigeben, wie sie ist
+  if (_n == LOG_INTERP_ROWS) {
+    _head = (uint8_t)((_head + 1) % LOG_INTERP_ROWS);
+    _n--;
+  }
+  const uint8_t slot = (uint8_t)((_head + _n++) % LOG_INTERP_ROWS);
+  _ep[slot] = ep;
+  memcpy(_v[slot], vals, sizeof(float) * _cols);
+
+  for (uint8_t c = 0; c < _cols; c++) {
+    if (isnan(vals[c])) continue;
+    if (_has[c] && ep > _lastEp[c]) {
+      // leere Zellen seit dem letzten Wert dieser Spalte
+      const float slope = (vals[c] - _lastV[c]) / (float)(ep - _lastEp[c]);
+      for (uint8_t k = 0; k + 1 < _n; k++) {
+        const uint8_t r = (uint8_t)((_head + k) % LOG_INTERP_ROWS);
+        float& x = _v[r][c];
+        if (isnan(x) && _ep[r] > _lastEp[c] && _ep[r] < ep) {
+          x = _lastV[c] + slope * (float)(_ep[r] - _lastEp[c]);
+          _filled++;
+        }
+      }
+    }
+    _has[c] = true;
+    _lastEp[c] = ep;
+    _lastV[c] = vals[c];
+  }
+}
+
+// leere Zelle nach dem letzten bekannten Wert ihrer Spalte -> kann noch aufgefüllt werden
+bool LogInterp::waiting(uint8_t r) const {
+  for (uint8_t c = 0; c < _cols; c++) {
+    if (isnan(_v[r][c]) && _has[c] && _ep[r] > _lastEp[c]) return true;
+  }
+  return false;
+}
+
+bool LogInterp::pop(uint32_t& ep, float* vals) {
+  // Ring voll: die älteste Zeile geht auch mit offenen Zellen heraus
+  if (!_n || (!_final && _n < LOG_INTERP_ROWS && waiting(_head))) return false;
+  ep = _ep[_head];
+  memcpy(vals, _v[_head], sizeof(float) * _cols);
+  _head = (uint8_t)((_head + 1) % LOG_INTERP_ROWS);
+  _n--;
+  return true;
+}
+
+void LogInterp::finish() {
+  _final = true;
+}
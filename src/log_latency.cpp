@@ -0,0 +1,126 @@
+#include "log_latency.h"
+#include <SD.h>
+
+static const char* const OP_NAMES[LOG_OP_COUNT] = { "open", "write", "close", "mkdir", "remove" };
+
+static LogLatencyHist   g_hist[LOG_OP_COUNT];
+static LogLatencyHist   g_window;   // alle Operationen seit der letzten Bewertung
+static LogLatencyHealth g_health;
+
+void LogLatencyHist::add(uint32_t us) {
+  uint8_t k = 0;
+  while (k < LOG_LAT_BUCKETS - 1 && us >= (LOG_LAT_BASE_US << k)) k++;
+  buckets[k]++;
+  count++;
+  totalUs += us;
+  if (us > maxUs) maxUs = us;
+}
+
+uint32_t LogLatencyHist::percentileUs(uint16_t permille) const {
+  if (!count) return 0;
+  const uint64_t rank = ((uint64_t)count * permille + 999) / 1000;   // 1-basiert, aufgerundet
+  uint64_t seen = 0;
+  for (uint8_t k = 0; k < LOG_LAT_BUCKETS; k++) {
+    seen += buckets[k];
+    if (seen >= rank) {
+      const uint32_t lim = logLatencyBucketLimitUs(k);
+      return (lim && lim < maxUs) ? lim : maxUs;
+    }
+  }
+  return maxUs;
+}
+
+const char* logSdOpName(uint8_t op) {
+  return op < LOG_OP_COUNT ? OP_NAMES[op] : "?";
+}
+
+uint32_t logLatencyBucketLimitUs(uint8_t k) {
+  return k < LOG_LAT_BUCKETS - 1 ? (LOG_LAT_BASE_US << k) : 0;
+}
+
+// Fenster voll -> p99 gegen die Schwelle; zurück erst unter der halben Schwelle (kein Flattern)
+static void evaluateWindow() {
+  const uint32_t p99 = g_window.percentileUs(990);
+  const uint32_t thrUs = (uint32_t)g_health.thresholdMs * 1000ul;
+  g_health.windows++;
+  g_health.lastP99Us = p99;
+
+  if (thrUs && !g_health.slow && p99 >= thrUs) {
+    g_health.slow = true;
+    g_health.slowEvents++;
+    Serial.printf("[logger] SD langsam: p99 %.1f ms >= %u ms -> größere Schreibblöcke\n",
+                  p99 / 1000.0, (unsigned)g_health.thresholdMs);
+  } else if (g_health.slow && (!thrUs || p99 < thrUs / 2)) {
+    g_health.slow = false;
+    Serial.printf("[logger] SD wieder normal: p99 %.1f ms\n", p99 / 1000.0);
+  }
+  g_window = LogLatencyHist();
+}
+
+void logLatencyAdd(uint8_t op, uint32_t us) {
+  if (op >= LOG_OP_COUNT) return;
+  g_hist[op].add(us);
+  g_window.add(us);
+  if (g_health.thresholdMs && us >= (uint32_t)g_health.thresholdMs * 1000ul) g_health.stalls++;
+  if (g_window.count >= LOG_LAT_WINDOW) evaluateWindow();
+}
+
+bool logSdMkdir(const String& path) {
+  const uint32_t t0 = micros();
+  const bool ok = SD.mkdir(path);
+  logLatencyAdd(LOG_OP_MKDIR, micros() - t0);
+  return ok;
+}
+
+bool logSdRemove(const String& path) {
+  const uint32_t t0 = micros();
+  const bool ok = SD.remove(path);
+  logLatencyAdd(LOG_OP_REMOVE, micros() - t0);
+  return ok;
+}
+
+LogLatencyHist logLatencyGet(uint8_t op) {
+  return op < LOG_OP_COUNT ? g_hist[op] : LogLatencyHist();
+}
+
+void logLatencySetThreshold(uint16_t ms) {
+  g_health.thresholdMs = ms;
+  if (!ms) g_health.slow = false;
+}
+
+LogLatencyHealth logLatencyHealth() {
+  return g_health;
+}
+
+String logLatencyJson() {
+  const LogLatencyHealth h = g_health;
+  String j = "{\"threshold_ms\":" + String(h.thresholdMs) +
+             ",\"slow\":" + String(h.slow ? "true" : "false") +
+             ",\"slow_events\":" + String(h.slowEvents) +
+             ",\"stalls\":" + String(h.stalls) +
+             ",\"windows\":" + String(h.windows) +
+             ",\"window_p99_us\":" + String(h.lastP99Us) +
+             ",\"bucket_us\":[";
+  for (uint8_t k = 0; k < LOG_LAT_BUCKETS; k++) {
+    if (k) j += ",";
+    j += String(logLatencyBucketLimitUs(k));
+  }
+  j += "],\"ops\":{";
+  for (uint8_t op = 0; op < LOG_OP_COUNT; op++) {
+    const LogLatencyHist o = g_hist[op];
+    if (op) j += ",";
+    j += "\"" + String(OP_NAMES[op]) + "\":{\"count\":" + String(o.count) +
+         ",\"avg_us\":" + String(o.count ? (uint32_t)(o.totalUs / o.count) : 0) +
+         ",\"p50_us\":" + String(o.percentileUs(500)) +
+         ",\"p90_us\":" + String(o.percentileUs(900)) +
+         ",\"p99_us\":" + String(o.percentileUs(990)) +
+         ",\"max_us\":" + String(o.maxUs) + ",\"buckets\":[";
+    for (uint8_t k = 0; k < LOG_LAT_BUCKETS; k++) {
+      if (k) j += ",";
+      j += String(o.buckets[k]);
+    }
+    j += "]}";
+  }
+  j += "}}";
+  return j;
+}
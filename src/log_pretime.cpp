@@ -0,0 +1,130 @@
+#include "log_pretime.h"
+#include <esp_system.h>
+#include <stddef.h>
+
+static constexpr uint32_t PRE_MAGIC = 0x50524C4D;   // "MLRP"
+
+// im RTC-RAM nur Daten ohne Konstruktor (würde beim Start überschrieben)
+struct PreRec {
+  uint32_t ms;
+  float    v[3][LOG_METRIC_COUNT];   // Wert, Min, Max
+  uint16_t crc;                      // über ms + v
+  uint16_t reserved;
+};
+
+struct PreRtc {
+  uint32_t magic;
+  uint32_t lastMs;      // millis() der letzten Messung dieses Starts
+  uint8_t  head;        // ältester Eintrag
+  uint8_t  count;
+  uint16_t check;       // ~(head | count << 8)
+  PreRec   e[LOG_PRE_CAPACITY];
+};
+
+RTC_NOINIT_ATTR static PreRtc g_rtc;
+static LogPreStats g_stats;
+
+static uint16_t recCrc(const PreRec& r) {
+  return logCrc16((const uint8_t*)&r, offsetof(PreRec, crc));
+}
+
+static uint16_t headerCheck() {
+  return (uint16_t)~(g_rtc.head | (g_rtc.count << 8));
+}
+
+static bool rtcValid() {
+  return g_rtc.magic == PRE_MAGIC && g_rtc.head < LOG_PRE_CAPACITY && g_rtc.count <= LOG_PRE_CAPACITY &&
+         g_rtc.check == headerCheck();
+}
+
+static void rtcClear() {
+  g_rtc.magic = PRE_MAGIC;
+  g_rtc.lastMs = 0;
+  g_rtc.head = 0;
+  g_rtc.count = 0;
+  g_rtc.check = headerCheck();
+}
+
+void logPreBegin() {
+  static bool done = false;
+  if (done) return;
+  done = true;
+
+  g_stats = LogPreStats();
+  const esp_reset_reason_t why = esp_reset_reason();
+  if (why == ESP_RST_POWERON || why == ESP_RST_BROWNOUT || !rtcValid()) {
+    rtcClear();
+    return;
+  }
+
+  // Einträge des vorigen Starts liegen lastMs (bis zum Reset) vor millis() = 0 -> nach vorne schieben;
+  // kaputte Einträge fallen weg
+  PreRec keep[LOG_PRE_CAPACITY];
+  uint8_t n = 0;
+  for (uint8_t i = 0; i < g_rtc.count; i++) {
+    PreRec r = g_rtc.e[(g_rtc.head + i) % LOG_PRE_CAPACITY];
+    if (r.crc != recCrc(r) || (int32_t)(g_rtc.lastMs - r.ms) < 0) { g_stats.dropped++; continue; }
+    r.ms -= g_rtc.lastMs;
+    r.crc = recCrc(r);
+    keep[n++] = r;
+  }
+  rtcClear();
+  for (uint8_t i = 0; i < n; i++) g_rtc.e[i] = keep[i];
+  g_rtc.count = n;
+  g_rtc.check = headerCheck();
+  g_stats.restored = n;
+  if (n) Serial.printf("[logger] %u Werte ohne Uhrzeit aus dem RTC-RAM übernommen\n", n);
+}
+
+void logPrePush(const LogPreEntry& e) {
+  PreRec r {};
+  r.ms = e.ms;
+  for (int i = 0; i < LOG_METRIC_COUNT; i++) {
+    r.v[0][i] = e.s.v[i];
+    r.v[1][i] = e.mn.v[i];
+    r.v[2][i] = e.mx.v[i];
+  }
+  r.crc = recCrc(r);
+
+  if (g_rtc.count == LOG_PRE_CAPACITY) {
+    g_rtc.head = (g_rtc.head + 1) % LOG_PRE_CAPACITY;
+    g_rtc.count--;
+    g_stats.dropped++;
+  }
+  g_rtc.e[(g_rtc.head + g_rtc.count) % LOG_PRE_CAPACITY] = r;
+  g_rtc.count++;
+  g_rtc.lastMs = e.ms;
+  g_rtc.check = headerCheck();
+}
+
+void logPreTouch(uint32_t ms) {
+  if (g_rtc.count) g_rtc.lastMs = ms;
+}
+
+uint8_t logPreCount() {
+  return g_rtc.count;
+}
+
+bool logPreAt(uint8_t i, LogPreEntry& out) {
+  if (i >= g_rtc.count) return false;
+  const PreRec& r = g_rtc.e[(g_rtc.head + i) % LOG_PRE_CAPACITY];
+  out.ms = r.ms;
+  for (int k = 0; k < LOG_METRIC_COUNT; k++) {
+    out.s.v[k] = r.v[0][k];
+    out.mn.v[k] = r.v[1][k];
+    out.mx.v[k] = r.v[2][k];
+  }
+  return true;
+}
+
+void logPreClear(uint32_t recovered, uint32_t dropped) {
+  rtcClear();
+  g_stats.recovered += recovered;
+  g_stats.dropped += dropped;
+}
+
+LogPreStats logPreGetStats() {
+  LogPreStats s = g_stats;
+  s.pending = g_rtc.count;
+  return s;
+}
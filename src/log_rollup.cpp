@@ -0,0 +1,329 @@
+#include "log_rollup.h"
+#include <SD.h>
+#include "log_csv.h"
+#include "log_gorilla.h"
+
+static constexpr uint8_t  ROLLUP_SLOTS           = 31;
+static constexpr uint16_t BACKFILL_ROWS_PER_STEP = 64;
+static constexpr uint32_t BACKFILL_RESCAN_MS     = 6UL * 3600UL * 1000UL;
+
+// laufender Tag (RAM-Akkumulator)
+static LogRollupDay g_cur {};
+static String       g_curDay = "";
+
+// Backfill-Zustand
+enum BackfillState : uint8_t { BF_IDLE, BF_SCAN, BF_DAY };
+static BackfillState g_bfState = BF_IDLE;
+static uint32_t      g_bfNextScanMs = 0;
+static File          g_bfDir;
+static File          g_bfSrc;
+static String        g_bfDay = "";
+static LogRollupDay  g_bfAcc {};
+// Quelldatei des Backfills, bevorzugt .bin > .gor > .csv
+enum BackfillSrc : uint8_t { BF_SRC_CSV, BF_SRC_BIN, BF_SRC_GOR };
+static BackfillSrc   g_bfKind = BF_SRC_CSV;
+static LogBinHeader  g_bfHdr {};
+static int8_t        g_bfCol[LOG_METRIC_COUNT];   // CSV: Spalte je Metrik, -1 = fehlt
+static uint32_t      g_bfBad = 0;                 // fehlerhafte Felder/Records des Tages
+static bool          g_bfCrc = false;             // CSV mit Prüfsummenspalte
+
+static String sumPath(const String& day) {
+  return String("/log/") + day.substring(0, 7) + ".sum";
+}
+
+static int slotOf(const String& day) {
+  return (int)day.substring(8, 10).toInt() - 1;
+}
+
+static uint32_t dayNumber(const String& day) {
+  return (uint32_t)(day.substring(0, 4).toInt() * 10000 +
+                    day.substring(5, 7).toInt() * 100 +
+                    day.substring(8, 10).toInt());
+}
+
+static void initDay(LogRollupDay& d, const String& day) {
+  memset(&d, 0, sizeof(d));
+  d.day = dayNumber(day);
+}
+
+static void accumulate(LogRollupDay& d, const LogSample& s) {
+  for (int i = 0; i < LOG_METRIC_COUNT; i++) {
+    const float v = s.v[i];
+    if (isnan(v)) continue;
+    LogRollupMetric& m = d.m[i];
+    if (m.count == 0) {
+      m.min = v; m.max = v;
+      m.first = s.epoch;
+    } else {
+      if (v < m.min) m.min = v;
+      if (v > m.max) m.max = v;
+    }
+    m.sum += v;
+    m.count++;
+    m.last = s.epoch;
+  }
+}
+
+// Tages-Min/Max auf die Extremwerte des Intervalls erweitern (Hüllkurve, log_agg_mode)
+static void widen(LogRollupDay& d, const LogSample& mn, const LogSample& mx) {
+  for (int i = 0; i < LOG_METRIC_COUNT; i++) {
+    LogRollupMetric& m = d.m[i];
+    if (!m.count) continue;
+    if (!isnan(mn.v[i]) && mn.v[i] < m.min) m.min = mn.v[i];
+    if (!isnan(mx.v[i]) && mx.v[i] > m.max) m.max = mx.v[i];
+  }
+}
+
+bool logRollupRead(const String& day, LogRollupDay& out) {
+  const int slot = slotOf(day);
+  if (slot < 0 || slot >= ROLLUP_SLOTS) return false;
+
+  const String p = sumPath(day);
+  if (!SD.exists(p)) return false;
+  File f = SD.open(p, FILE_READ);
+  if (!f) return false;
+
+  bool ok = false;
+  if (f.size() >= (size_t)(slot + 1) * sizeof(LogRollupDay)) {
+    f.seek((size_t)slot * sizeof(LogRollupDay));
+    ok = f.read((uint8_t*)&out, sizeof(out)) == sizeof(out) && out.day == dayNumber(day);
+  }
+  f.close();
+  return ok;
+}
+
+static bool writeSlot(const String& day, const LogRollupDay& d) {
+  const int slot = slotOf(day);
+  if (slot < 0 || slot >= ROLLUP_SLOTS) return false;
+
+  const String p = sumPath(day);
+  if (!SD.exists(p)) {
+    // Monatsdatei einmalig mit leeren Slots anlegen
+    File c = SD.open(p, FILE_WRITE);
+    if (!c) return false;
+    LogRollupDay empty {};
+    for (int i = 0; i < ROLLUP_SLOTS; i++) c.write((const uint8_t*)&empty, sizeof(empty));
+    c.close();
+  }
+
+  File f = SD.open(p, "r+");
+  if (!f) return false;
+  f.seek((size_t)slot * sizeof(LogRollupDay));
+  const bool ok = f.write((const uint8_t*)&d, sizeof(d)) == sizeof(d);
+  f.close();
+  return ok;
+}
+
+float logRollupMean(const LogRollupDay& d, int metricIdx) {
+  if (metricIdx < 0 || metricIdx >= LOG_METRIC_COUNT) return NAN;
+  const LogRollupMetric& m = d.m[metricIdx];
+  if (m.count == 0) return NAN;
+  return (float)(m.sum / (double)m.count);
+}
+
+void logRollupAdd(const String& day, const LogSample& s, const LogSample* mn, const LogSample* mx) {
+  if (day != g_curDay) {
+    // Tageswechsel: Vortag abschließen
+    if (g_curDay.length() && g_cur.day) {
+      g_cur.flags |= LOG_ROLLUP_FINAL;
+      writeSlot(g_curDay, g_cur);
+    }
+
+    // nach Reboot: bereits geschriebenen Stand des Tages übernehmen
+    g_curDay = day;
+    if (!logRollupRead(day, g_cur) || (g_cur.flags & LOG_ROLLUP_BACKFILL)) initDay(g_cur, day);
+    g_cur.flags &= ~LOG_ROLLUP_FINAL;
+  }
+
+  accumulate(g_cur, s);
+  if (mn && mx) widen(g_cur, *mn, *mx);
+}
+
+void logRollupSync() {
+  if (g_curDay.length() && g_cur.day) writeSlot(g_curDay, g_cur);
+}
+
+void logRollupReset() {
+  g_curDay = "";
+  if (g_bfSrc) g_bfSrc.close();
+  if (g_bfDir) g_bfDir.close();
+  g_bfState = BF_IDLE;
+  g_bfNextScanMs = millis();
+}
+
+// ============================================================================
+// Backfill
+// ============================================================================
+static bool bfParseCsvHeader(const LogCsvReader& rd) {
+  for (int i = 0; i < LOG_METRIC_COUNT; i++) g_bfCol[i] = -1;
+  g_bfCrc = false;
+
+  if (strncmp(rd.field(0), "epoch", 5) != 0) {
+    // kein Header -> feste Positionen, erste Zeile ist bereits Daten
+    for (int i = 0; i < LOG_METRIC_COUNT; i++) g_bfCol[i] = (int8_t)(i + 1);
+    return false;
+  }
+
+  for (int i = 0; i < LOG_METRIC_COUNT; i++) g_bfCol[i] = (int8_t)rd.find(LOG_METRICS[i].col);
+  g_bfCrc = rd.find(LOG_CSV_COL_CRC) >= 0;
+  return true;
+}
+
+static bool bfParseCsvLine(const LogCsvReader& rd, LogSample& s) {
+  s.epoch = 0;
+  if (logCsvParseU32(rd.field(0), s.epoch) != LOG_CSV_OK) { g_bfBad++; return false; }
+
+  for (int i = 0; i < LOG_METRIC_COUNT; i++) {
+    s.v[i] = NAN;
+    if (g_bfCol[i] <= 0) continue;
+    float v;
+    const LogCsvField r = logCsvParseFloat(rd.field((uint8_t)g_bfCol[i]), v);
+    if (r == LOG_CSV_OK) s.v[i] = v;
+    else if (r == LOG_CSV_BAD) g_bfBad++;
+  }
+  return s.epoch != 0;
+}
+
+static void bfFinishDay() {
+  g_bfAcc.flags = LOG_ROLLUP_FINAL;
+  g_bfAcc.src_off = 0;
+  writeSlot(g_bfDay, g_bfAcc);
+  g_bfSrc.close();
+  g_bfState = BF_SCAN;
+  Serial.printf("[logger] rollup backfill fertig: %s (%lu fehlerhafte Felder/Records)\n",
+                g_bfDay.c_str(), (unsigned long)g_bfBad);
+}
+
+static const char* bfExt(BackfillSrc k) {
+  return (k == BF_SRC_BIN) ? ".bin" : (k == BF_SRC_GOR) ? ".gor" : ".csv";
+}
+
+static void bfStartDay(const String& day, BackfillSrc kind) {
+  g_bfDay = day;
+  g_bfKind = kind;
+  g_bfSrc = SD.open(logPathForDay(day, bfExt(kind)), FILE_READ);
+  if (!g_bfSrc) return;
+
+  LogRollupDay prev;
+  const bool resume = logRollupRead(day, prev) && (prev.flags & LOG_ROLLUP_BACKFILL);
+
+  uint32_t dataStart = 0;
+  if (kind == BF_SRC_BIN) {
+    if (!logBinReadHeader(g_bfSrc, g_bfHdr)) { g_bfSrc.close(); return; }
+    dataStart = g_bfHdr.header_size;
+  } else if (kind == BF_SRC_GOR) {
+    dataStart = 0;   // Blöcke ab Dateianfang, Fortschritt immer auf Blockgrenze
+  } else {
+    LogCsvReader rd(g_bfSrc);
+    rd.next();
+    // ohne Header ist die erste Zeile Daten -> wieder von vorne lesen
+    if (bfParseCsvHeader(rd)) dataStart = rd.offset();
+  }
+  g_bfBad = 0;
+
+  if (resume && prev.src_off >= dataStart) {
+    g_bfAcc = prev;
+    g_bfSrc.seek(prev.src_off);
+  } else {
+    initDay(g_bfAcc, day);
+    g_bfSrc.seek(dataStart);
+  }
+  g_bfState = BF_DAY;
+}
+
+static void bfScanNext(const String& today) {
+  File f = g_bfDir.openNextFile();
+  if (!f) {
+    g_bfDir.close();
+    g_bfState = BF_IDLE;
+    g_bfNextScanMs = millis() + BACKFILL_RESCAN_MS;
+    return;
+  }
+
+  const bool isDir = f.isDirectory();
+  String fn = String(f.name());
+  f.close();
+  if (isDir) return;
+
+  const int slash = fn.lastIndexOf('/');
+  const String base = (slash >= 0) ? fn.substring(slash + 1) : fn;
+  if (base.length() != 14 || base.charAt(4) != '-' || base.charAt(7) != '-') return;
+
+  BackfillSrc kind;
+  if (base.endsWith(".bin"))      kind = BF_SRC_BIN;
+  else if (base.endsWith(".gor")) kind = BF_SRC_GOR;
+  else if (base.endsWith(".csv")) kind = BF_SRC_CSV;
+  else return;
+
+  const String day = base.substring(0, 10);
+  if (!(day < today)) return;                          // heute läuft über logRollupAdd()
+  // je Tag nur eine Quelle: .bin > .gor > .csv
+  if (kind != BF_SRC_BIN && SD.exists(logPathForDay(day, ".bin"))) return;
+  if (kind == BF_SRC_CSV && SD.exists(logPathForDay(day, ".gor"))) return;
+
+  LogRollupDay d;
+  if (logRollupRead(day, d) && (d.flags & LOG_ROLLUP_FINAL)) return;
+
+  bfStartDay(day, kind);
+}
+
+static void bfProcessRows() {
+  uint16_t rows = 0;
+  LogSample s;
+
+  if (g_bfKind == BF_SRC_GOR) {
+    // ein Block je Aufruf (~100 Samples)
+    uint8_t blk[LOG_GOR_BLOCK_SIZE];
+    LogGorDecoder dec;
+    if (g_bfSrc.read(blk, sizeof(blk)) != sizeof(blk)) { bfFinishDay(); return; }
+    if (dec.begin(blk)) {
+      while (dec.next(s)) accumulate(g_bfAcc, s);
+    }
+  } else if (g_bfKind == BF_SRC_BIN) {
+    uint8_t rec[LOG_BIN_MAX_REC];
+    while (rows < BACKFILL_ROWS_PER_STEP) {
+      if (g_bfSrc.read(rec, g_bfHdr.rec_size) != g_bfHdr.rec_size) { bfFinishDay(); return; }
+      rows++;
+      if (!logBinRecordOk(g_bfHdr, rec)) { g_bfBad++; continue; }
+      logBinDecode(g_bfHdr, rec, s);
+      accumulate(g_bfAcc, s);
+    }
+  } else {
+    LogCsvReader rd(g_bfSrc);
+    rd.setCrc(g_bfCrc);
+    while (rows < BACKFILL_ROWS_PER_STEP) {
+      if (!rd.next()) { g_bfBad += rd.crcErrors(); bfFinishDay(); return; }
+      if (bfParseCsvLine(rd, s)) accumulate(g_bfAcc, s);
+      rows++;
+    }
+    g_bfBad += rd.crcErrors();
+    // der Leser puffert vor -> Datei auf das Ende der letzten Zeile stellen
+    g_bfSrc.seek(rd.offset());
+  }
+
+  // Zwischenstand sichern -> nach Reboot geht es hier weiter
+  g_bfAcc.flags = LOG_ROLLUP_BACKFILL;
+  g_bfAcc.src_off = (uint32_t)g_bfSrc.position();
+  writeSlot(g_bfDay, g_bfAcc);
+}
+
+void logRollupBackfillStep(const String& today) {
+  switch (g_bfState) {
+    case BF_IDLE:
+      if ((int32_t)(millis() - g_bfNextScanMs) < 0) return;
+      if (!SD.exists("/log")) { g_bfNextScanMs = millis() + BACKFILL_RESCAN_MS; return; }
+      g_bfDir = SD.open("/log");
+      if (!g_bfDir) { g_bfNextScanMs = millis() + BACKFILL_RESCAN_MS; return; }
+      g_bfState = BF_SCAN;
+      return;
+
+    case BF_SCAN:
+      bfScanNext(today);
+      return;
+
+    case BF_DAY:
+      if (!g_bfSrc) { g_bfState = BF_SCAN; return; }
+      bfProcessRows();
+      return;
+  }
+}
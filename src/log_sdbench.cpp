@@ -0,0 +1,203 @@
+#include "log_sdbench.h"
+#include "log_format.h"
+#include <SD.h>
+#include <time.h>
+
+static constexpr size_t TEST_BLOCK = 512;
+
+// reproduzierbares Muster je Durchgang (xorshift), damit verschobene/vertauschte Blöcke auffallen
+static void fillPattern(uint8_t* p, size_t n, uint32_t& seed) {
+  for (size_t i = 0; i < n; i += 4) {
+    seed ^= seed << 13;
+    seed ^= seed >> 17;
+    seed ^= seed << 5;
+    memcpy(p + i, &seed, 4);
+  }
+}
+
+uint32_t logSdCardId() {
+  const uint8_t type = SD.cardType();
+  if (type == CARD_NONE) return 0;
+  return ((uint32_t)type << 28) ^ (uint32_t)(SD.cardSize() >> 20);
+}
+
+bool logSdVerify(uint32_t bytes) {
+  uint8_t buf[TEST_BLOCK];
+  uint32_t seed = 0x9E3779B9u ^ micros();
+
+  File f = SD.open(LOG_SD_TEST_FILE, FILE_WRITE);
+  if (!f) return false;
+  uint16_t wcrc = 0xFFFF;
+  bool ok = true;
+  for (uint32_t done = 0; done < bytes && ok; done += TEST_BLOCK) {
+    fillPattern(buf, TEST_BLOCK, seed);
+    wcrc = logCrc16(buf, TEST_BLOCK, wcrc);
+    ok = f.write(buf, TEST_BLOCK) == TEST_BLOCK;
+  }
+  f.close();
+
+  uint16_t rcrc = 0xFFFF;
+  if (ok) {
+    f = SD.open(LOG_SD_TEST_FILE, FILE_READ);
+    ok = f && f.size() == bytes;
+    for (uint32_t done = 0; done < bytes && ok; done += TEST_BLOCK) {
+      ok = f.read(buf, TEST_BLOCK) == TEST_BLOCK;
+      rcrc = logCrc16(buf, TEST_BLOCK, rcrc);
+    }
+    if (f) f.close();
+  }
+  SD.remove(LOG_SD_TEST_FILE);
+  return ok && rcrc == wcrc;
+}
+
+static bool tryStep(LogSdMountFn mount, uint32_t hz, LogSdClock& out) {
+  const uint32_t t0 = micros();
+  const bool ok = mount(hz) && logSdVerify(LOG_SD_VERIFY_BYTES) && logSdVerify(LOG_SD_VERIFY_BYTES);
+  if (out.steps < sizeof(out.step) / sizeof(out.step[0])) {
+    LogSdStep& s = out.step[out.steps++];
+    s.hz = hz;
+    s.ok = ok;
+    s.us = micros() - t0;
+  }
+  return ok;
+}
+
+uint32_t logSdNegotiate(LogSdMountFn mount, uint32_t knownHz, LogSdClock& out) {
+  out.steps = 0;
+  out.negotiated = false;
+  out.hz = 0;
+
+  // gemerkter Takt dieser Karte: einmal prüfen genügt
+  if (knownHz && tryStep(mount, knownHz, out)) {
+    out.hz = knownHz;
+    return knownHz;
+  }
+
+  uint32_t best = 0, last = 0;
+  for (uint8_t i = 0; i < LOG_SD_HZ_STEP_COUNT; i++) {
+    last = LOG_SD_HZ_STEPS[i];
+    if (!tryStep(mount, last, out)) break;
+    best = last;
+  }
+  if (!best) {
+    // auch die langsamste Stufe fehlerhaft: trotzdem damit einhängen, falls die Karte überhaupt antwortet
+    best = LOG_SD_HZ_STEPS[0];
+  }
+  // zuletzt mit einer fehlerhaften Stufe eingehängt -> zurück auf die beste
+  const bool atBest = last == best && out.steps && out.step[out.steps - 1].ok;
+  if (!atBest && !mount(best)) return 0;
+
+  out.hz = best;
+  out.negotiated = true;
+  Serial.printf("[logger] SD-Takt ausgehandelt: %.1f MHz (%u Stufen geprüft)\n", best / 1e6, out.steps);
+  return best;
+}
+
+bool logSdRunBench(uint32_t hz, LogSdBench& out) {
+  out = LogSdBench();
+  out.hz = hz;
+  out.epoch = (uint32_t)time(nullptr);
+  const uint32_t tStart = millis();
+
+  static uint8_t buf[TEST_BLOCK * 8];   // 4 KB je Zugriff; statisch, läuft im Webserver-Handler
+  uint32_t seed = 0x2545F491u;
+
+  // sequentiell schreiben
+  File f = SD.open(LOG_SD_TEST_FILE, FILE_WRITE);
+  if (!f) return false;
+  uint16_t wcrc = 0xFFFF;
+  uint32_t t0 = micros();
+  uint32_t written = 0;
+  while (written < LOG_SD_BENCH_BYTES) {
+    fillPattern(buf, sizeof(buf), seed);
+    wcrc = logCrc16(buf, sizeof(buf), wcrc);
+    if (f.write(buf, sizeof(buf)) != sizeof(buf)) break;
+    written += sizeof(buf);
+  }
+  f.close();
+  uint32_t dt = micros() - t0;
+  out.seqBytes = written;
+  out.seqWriteKBs = dt ? (uint32_t)((uint64_t)written * 1000000ull / 1024 / dt) : 0;
+
+  // sequentiell lesen + vergleichen
+  f = SD.open(LOG_SD_TEST_FILE, FILE_READ);
+  uint16_t rcrc = 0xFFFF;
+  uint32_t read = 0;
+  t0 = micros();
+  while (f && read < written) {
+    if (f.read(buf, sizeof(buf)) != sizeof(buf)) break;
+    rcrc = logCrc16(buf, sizeof(buf), rcrc);
+    read += sizeof(buf);
+  }
+  dt = micros() - t0;
+  if (f) f.close();
+  out.seqReadKBs = dt ? (uint32_t)((uint64_t)read * 1000000ull / 1024 / dt) : 0;
+  if (read != written || rcrc != wcrc) out.crcErrors++;
+  SD.remove(LOG_SD_TEST_FILE);
+
+  // kleine Appends: offene Datei, je Record write + flush (FAT/Verzeichniseintrag wird mitgeschrieben)
+  f = SD.open(LOG_SD_TEST_FILE, FILE_APPEND);
+  if (f) {
+    uint64_t sum = 0;
+    for (uint16_t i = 0; i < LOG_SD_BENCH_APPENDS; i++) {
+      t0 = micros();
+      f.write(buf + (i % 64) * 24, 24);
+      f.flush();
+      dt = micros() - t0;
+      sum += dt;
+      if (dt > out.appendMaxUs) out.appendMaxUs = dt;
+    }
+    f.close();
+    out.appendAvgUs = (uint32_t)(sum / LOG_SD_BENCH_APPENDS);
+  }
+
+  // Öffnen + Schließen (jeder Schreibvorgang ohne offene Datei zahlt das)
+  t0 = micros();
+  uint16_t opens = 0;
+  for (; opens < LOG_SD_BENCH_OPENS; opens++) {
+    File g = SD.open(LOG_SD_TEST_FILE, FILE_APPEND);
+    if (!g) break;
+    g.close();
+  }
+  dt = micros() - t0;
+  out.openCloseAvgUs = opens ? dt / opens : 0;
+  SD.remove(LOG_SD_TEST_FILE);
+
+  out.durationMs = millis() - tStart;
+  out.ok = written == LOG_SD_BENCH_BYTES && opens == LOG_SD_BENCH_OPENS && !out.crcErrors;
+  Serial.printf("[logger] SD-Benchmark @ %.1f MHz: schreiben %lu KB/s, lesen %lu KB/s, append %lu us, open+close %lu us%s\n",
+                hz / 1e6, (unsigned long)out.seqWriteKBs, (unsigned long)out.seqReadKBs,
+                (unsigned long)out.appendAvgUs, (unsigned long)out.openCloseAvgUs, out.crcErrors ? ", CRC-FEHLER" : "");
+  return out.ok;
+}
+
+String logSdJson(const LogSdClock& c, const LogSdBench* b) {
+  String j = "{\"card\":{\"id\":" + String(c.cardId) +
+             ",\"type\":" + String(c.cardId >> 28) +
+             ",\"size_mb\":" + String(c.cardId & 0x0FFFFFFFu) +
+             "},\"clock\":{\"hz\":" + String(c.hz) +
+             ",\"mode\":\"" + (c.fixed ? "fixed" : c.negotiated ? "negotiated" : "remembered") +
+             "\",\"steps\":[";
+  for (uint8_t i = 0; i < c.steps; i++) {
+    if (i) j += ",";
+    j += "{\"hz\":" + String(c.step[i].hz) + ",\"ok\":" + (c.step[i].ok ? "true" : "false") +
+         ",\"us\":" + String(c.step[i].us) + "}";
+  }
+  j += "]},\"bench\":";
+  if (!b || !b->epoch) {
+    j += "null}";
+    return j;
+  }
+  j += "{\"ok\":" + String(b->ok ? "true" : "false") +
+       ",\"epoch\":" + String(b->epoch) +
+       ",\"hz\":" + String(b->hz) +
+       ",\"seq_bytes\":" + String(b->seqBytes) +
+       ",\"seq_write_kbs\":" + String(b->seqWriteKBs) +
+       ",\"seq_read_kbs\":" + String(b->seqReadKBs) +
+       ",\"append_avg_us\":" + String(b->appendAvgUs) +
+       ",\"append_max_us\":" + String(b->appendMaxUs) +
+       ",\"open_close_avg_us\":" + String(b->openCloseAvgUs) +
+       ",\"crc_errors\":" + String(b->crcErrors) +
+       ",\"duration_ms\":" + String(b->durationMs) + "}}";
+  return j;
+}
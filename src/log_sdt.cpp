@@ -0,0 +1,134 @@
+#include "log_sdt.h"
+
+void LogSdt::configure(const float* tol) {
+  _on = false;
+  for (int i = 0; i < LOG_METRIC_COUNT; i++) {
+    _tol[i] = tol[i] > 0 ? tol[i] * 0.999f : 0;   // Reserve für Rundung (float)
+    if (_tol[i] > 0) _on = true;
+    _d[i] = Door();
+  }
+  _head = 0;
+  _count = 0;
+}
+
+// P mit dem Wert auf der Geraden A -> P im Korridor speichern, P wird neuer Anfang
+void LogSdt::keepHeld(int i) {
+  Door& d = _d[i];
+  if (d.held < 0) return;
+  const float dt = (float)(d.tp - d.ta);
+  float slope = (d.p - d.a) / dt;
+  if (slope < d.lo) slope = d.lo;
+  if (slope > d.hi) slope = d.hi;
+  const float v = d.a + slope * dt;
+
+  _rows[d.held].v[i] = v;
+  _open[d.held] &= (uint8_t)~(1u << i);
+  _kept++;
+  d.ta = d.tp;
+  d.a = v;
+  d.ra = d.rp;
+  d.held = -1;
+}
+
+void LogSdt::holdNew(int i, uint8_t slot, uint32_t t, float v) {
+  Door& d = _d[i];
+  const float dt = (float)(t - d.ta);
+  d.held = slot;
+  d.tp = t;
+  d.p = v;
+  d.lo = (v - _tol[i] - d.a) / dt;
+  d.hi = (v + _tol[i] - d.a) / dt;
+  d.rp = _seq;
+  _open[slot] |= (uint8_t)(1u << i);
+}
+
+// offene Punkte der ältesten Zeile speichern, damit sie mit dem nächsten pop() herausgeht
+void LogSdt::closeHead() {
+  for (int i = 0; i < LOG_METRIC_COUNT; i++) {
+    if (_open[_head] & (1u << i)) keepHeld(i);
+  }
+}
+
+void LogSdt::push(const LogSample& s) {
+  // nach push() + pop() ist immer Platz (siehe Ende); ohne pop() dazwischen die älteste Zeile
+  // überschreiben statt den neuen Wert zu verwerfen
+  if (_count == LOG_SDT_RING) {
+    closeHead();
+    _head = slotAt(1);
+    _count--;
+  }
+
+  const uint8_t slot = slotAt(_count++);
+  _rows[slot] = s;
+  _open[slot] = 0;
+
+  for (int i = 0; i < LOG_METRIC_COUNT; i++) {
+    const float v = s.v[i];
+    if (isnan(v)) continue;
+    _in++;
+    Door& d = _d[i];
+
+    // aus bzw. erster Wert / Zeit rückwärts: speichern, ist der neue Anfang
+    if (_tol[i] <= 0 || !d.anchor || s.epoch <= d.ta || (d.held >= 0 && s.epoch <= d.tp)) {
+      keepHeld(i);
+      d.anchor = true;
+      d.ta = s.epoch;
+      d.a = v;
+      d.ra = _seq;
+      _kept++;
+      continue;
+    }
+    if (d.held < 0) {
+      holdNew(i, slot, s.epoch, v);
+      continue;
+    }
+
+    const float dt = (float)(s.epoch - d.ta);
+    float lo = (v - _tol[i] - d.a) / dt;
+    float hi = (v + _tol[i] - d.a) / dt;
+    if (lo < d.lo) lo = d.lo;
+    if (hi > d.hi) hi = d.hi;
+    if (lo > hi || _seq - d.ra > LOG_SDT_RING) {
+      // Korridor leer bzw. Lücke sonst länger als der Ring: P speichern, neuer Korridor ab P
+      keepHeld(i);
+      holdNew(i, slot, s.epoch, v);
+      continue;
+    }
+    // P wird durch die Gerade abgedeckt -> verwerfen, der neue Punkt wird zurückgehalten
+    _rows[d.held].v[i] = NAN;
+    _open[d.held] &= (uint8_t)~(1u << i);
+    d.held = slot;
+    d.tp = s.epoch;
+    d.p = v;
+    d.lo = lo;
+    d.hi = hi;
+    d.rp = _seq;
+    _open[slot] |= (uint8_t)(1u << i);
+  }
+  _seq++;
+
+  // Ring voll: älteste Zeile abschließen -> pop() macht Platz für den nächsten push()
+  if (_count == LOG_SDT_RING) closeHead();
+}
+
+bool LogSdt::pop(LogSample& out) {
+  while (_count && !_open[_head]) {
+    const LogSample& r = _rows[_head];
+    _head = slotAt(1);
+    _count--;
+    for (int i = 0; i < LOG_METRIC_COUNT; i++) {
+      if (!isnan(r.v[i])) { out = r; return true; }
+    }
+  }
+  return false;
+}
+
+bool LogSdt::peek(uint8_t k, LogSample& out) const {
+  if (k >= _count) return false;
+  out = _rows[slotAt(k)];
+  return true;
+}
+
+void LogSdt::finish() {
+  for (int i = 0; i < LOG_METRIC_COUNT; i++) keepHeld(i);
+}
@@ -4,12 +4,31 @@
 #include <math.h>
 #include "sensor_data.h"
 #include "log_bits.h"
+#include "log_format.h"
+#include "log_index.h"
+#include "log_rollup.h"
+#include "log_gorilla.h"
+#include "log_csv.h"
+#include "log_catalog.h"
+#include "log_archive.h"
+#include "log_latency.h"
+#include "log_flash.h"
+#include "log_agg.h"
+#include "log_pretime.h"
+#include "log_burst.h"
+#include "log_sdt.h"
+#include "log_sdbench.h"
+#include <unistd.h>
 
 #include "pins.h"
 
 #if defined(ESP32)
   #include <SD.h>
   #include <SPI.h>
+  #include <freertos/FreeRTOS.h>
+  #include <freertos/queue.h>
+  #include <freertos/semphr.h>
+  #include <freertos/task.h>
 #else
   #error "Logger SD-only: aktuell nur fuer ESP32 vorgesehen"
 #endif
@@ -18,12 +37,125 @@ static bool     g_sd_ok = false;
 static uint32_t g_lastLogMs = 0;
 static String   g_curDay = "";
 static bool     g_headerWritten = false;
+static bool     g_csvCrc = true;          // CSV von g_curDay hat die Spalte "crc"
+static LogBinHeader g_binHdr {};
+static bool     g_binHdrValid = false;    // g_binHdr gehoert zu g_curDay
+static uint32_t g_binEnd = 0;             // logisches Dateiende der .bin von g_curDay
+static bool     g_idxReady = false;       // Index fuer g_curDay geprueft
+static uint32_t g_idxNextEpoch = 0;       // ab hier naechster Indexeintrag
+// Write-behind: Samples im RAM sammeln, gebündelt schreiben
+static constexpr uint8_t LOG_WB_CAPACITY = 32;
+static LogSample g_wb[LOG_WB_CAPACITY];
+static uint8_t  g_wbCount = 0;
+static uint32_t g_wbFirstMs = 0;          // millis() beim ältesten Sample im Puffer
+static String   g_wbDay = "";             // Tag aller Samples im Puffer
+static uint32_t g_wbFormat = 0;           // log_format_mask beim Puffern
+static uint32_t g_wbMetrics = 0;          // log_metric_mask beim Puffern
+static bool     g_wbEnv = false;          // Puffer enthält Min/Max (log_agg_mode = Mittel + Min/Max)
+static LogSample g_wbMin[LOG_WB_CAPACITY];   // Hüllkurve parallel zu g_wb (nur mit g_wbEnv)
+static LogSample g_wbMax[LOG_WB_CAPACITY];
+// Kompression (log_sdt_*): zwischen Puffer und Tagesdateien, hält bis zu LOG_SDT_RING Zeilen zurück
+static LogSdt    g_sdt;
+static uint16_t  g_sdtTol[LOG_METRIC_COUNT] = {};    // log_sdt_* (Hundertstel), mit denen g_sdt läuft
+static LogSample g_sdtOut[LOG_WB_CAPACITY + LOG_SDT_RING];
+static LogBinHeader g_envHdr {};
+static bool     g_envHdrValid = false;    // g_envHdr gehoert zu g_curDay
+static bool     g_prealloc = false;       // log_prealloc: .bin/.gor beim ersten Schreiben des Tages vorbelegen
+static uint16_t g_intervalMin = 30;       // log_interval_min (Größe der Vorbelegung)
+static uint32_t g_logTick = 0;            // Log-Zeitpunkte seit Start (loop), für log_every_*
+static LoggerStats g_stats;
+
+static LogGorEncoder g_gor;
+static bool     g_gorValid = false;       // g_gor gehoert zu g_curDay
+static uint32_t g_gorBlockOff = 0;        // Dateioffset des offenen Blocks
 
 static uint32_t g_lastCleanupEpoch = 0;   // 1x pro Tag Cleanup
 
+// Messungen seit dem letzten Log-Zeitpunkt (nur loop(), nicht der Storage-Task)
+static LogAgg   g_agg;
+// Werte ohne gültige Zeit (log_pretime.h) liegen beim Storage-Task -> loop() puffert nicht weiter
+static volatile bool g_preBusy = false;
+
+// Storage-Task: besitzt die SD, loop() reicht nur Aufträge über die Queue weiter
+static constexpr uint8_t  STORAGE_QUEUE_LEN  = 16;
+static constexpr uint32_t STORAGE_STACK      = 6144;
+static constexpr uint32_t STORAGE_IDLE_MS    = 250;    // Haltefenster/Backfill auch ohne Aufträge
+static constexpr uint32_t STORAGE_BUSY_MS    = 10;     // Pause zwischen zwei Aufräum-Schritten
+static constexpr uint32_t STORAGE_FLUSH_WAIT = 3000;   // loggerFlush(): max. Wartezeit
+static constexpr uint16_t SLOW_FLUSH_FACTOR  = 4;      // langsame Karte: Haltefenster vervielfachen ...
+static constexpr uint16_t SLOW_FLUSH_MIN_SEC = 600;    // ... mindestens so lang (Puffer begrenzt ohnehin)
+static constexpr uint16_t FLASH_FLUSH_MIN_SEC = 7200;  // Flash-Ring: selten schreiben (Blockkopie je Vorgang)
+
+enum LogJobType : uint8_t { LOG_JOB_APPEND, LOG_JOB_FLUSH, LOG_JOB_CLEANUP, LOG_JOB_PRETIME };
+
+struct LogJob {
+  LogJobType   type;
+  LogSample    s;               // PRETIME: nur s.epoch = Zeit bei refMs
+  uint32_t     refMs;           // PRETIME: millis() zu s.epoch
+  LogSample    mn, mx;          // Min/Max des Intervalls (nur mit envelope)
+  bool         envelope;        // log_agg_mode = Mittel + Min/Max
+  uint32_t     format;          // log_format_mask
+  uint32_t     metrics;         // log_metric_mask
+  uint16_t     flushSec;        // log_flush_sec
+  uint16_t     retentionDays;   // log_retention_days
+  uint16_t     cleanupBudgetMs; // log_cleanup_budget_ms
+  uint32_t     maxBytes;        // log_max_bytes
+  uint16_t     intervalMin;     // log_interval_min
+  bool         prealloc;        // log_prealloc
+  uint16_t     archiveDays;     // log_archive_days
+  bool         archiveCompress; // log_archive_compress
+  uint16_t     slowMs;          // log_slow_ms
+  uint16_t     sdtTol[LOG_METRIC_COUNT];   // log_sdt_* (Hundertstel)
+  TaskHandle_t notify;          // nach Abschluss benachrichtigen (nullptr = niemand)
+};
+
+static QueueHandle_t     g_queue = nullptr;
+static SemaphoreHandle_t g_sdMutex = nullptr;
+static TaskHandle_t      g_task = nullptr;
+static uint16_t          g_flushSec = 300;       // zuletzt übergebenes Haltefenster
+static uint16_t          g_arcDays = 0;          // zuletzt übergebene Archiv-Parameter
+static bool              g_arcCompress = true;
+static uint32_t          g_flashBudget = 0;      // log_flash_kb in Bytes (Ersatz ohne SD, 0 = aus)
+
 bool loggerSdOk() { return g_sd_ok; }
+bool loggerFlashActive() { return !g_sd_ok && logFlashActive(); }
+
+// irgendwo kann geschrieben werden: SD, sonst Flash-Ring
+static bool storageOk() { return g_sd_ok || logFlashActive(); }
+
+// SPI-Takt der SD (log_sdbench.h): fest (log_sd_hz) oder ausgehandelt und je Karte gemerkt
+static uint32_t   g_sdHzFixed = 0;      // log_sd_hz (0 = aushandeln)
+static uint32_t   g_sdHzKnown = 0;      // log_sd_auto_hz
+static uint32_t   g_sdCardKnown = 0;    // log_sd_card
+static LogSdClock g_sdClock;
+static LogSdBench g_sdBench;
+
+static bool sdMountAt(uint32_t hz) {
+  SD.end();
+  return SD.begin(PIN_SD_CS, SPI, hz);
+}
 
-const uint32_t spiHz = 10000000; // 10 MHz
+static void takeSdClockConfig(const AppConfig& cfg) {
+  g_sdHzFixed = cfg.log_sd_hz;
+  g_sdHzKnown = cfg.log_sd_auto_hz;
+  g_sdCardKnown = cfg.log_sd_card;
+}
+
+// einhängen: fester Takt, sonst der für diese Karte gemerkte (geprüft), sonst aushandeln
+static bool mountSd() {
+  g_sdClock = LogSdClock();
+  if (g_sdHzFixed) {
+    g_sdClock.fixed = true;
+    if (!SD.begin(PIN_SD_CS, SPI, g_sdHzFixed)) return false;
+    g_sdClock.hz = g_sdHzFixed;
+    g_sdClock.cardId = logSdCardId();
+    return true;
+  }
+  if (!SD.begin(PIN_SD_CS, SPI, LOG_SD_HZ_STEPS[0])) return false;
+  g_sdClock.cardId = logSdCardId();
+  const uint32_t known = (g_sdClock.cardId == g_sdCardKnown) ? g_sdHzKnown : 0;
+  return logSdNegotiate(sdMountAt, known, g_sdClock) != 0;
+}
 
 static bool timeIsValid() {
   time_t now = time(nullptr);
@@ -31,113 +163,578 @@ static bool timeIsValid() {
   return (now > 1672531200);
 }
 
-static String dayStringLocal() {
-  time_t now = time(nullptr);
-  struct tm t {};
-  localtime_r(&now, &t);
-  char buf[16];
-  snprintf(buf, sizeof(buf), "%04d-%02d-%02d", t.tm_year + 1900, t.tm_mon + 1, t.tm_mday);
-  return String(buf);
+static time_t localMidnight(time_t t) {
+  struct tm tmLocal{};
+  localtime_r(&t, &tmLocal);
+  tmLocal.tm_hour = 0;
+  tmLocal.tm_min  = 0;
+  tmLocal.tm_sec  = 0;
+  return mktime(&tmLocal);
 }
 
-static String logPathForDay(const String& day) {
-  return String("/log/") + day + ".csv";
+static bool truncateLog(const String& path, uint32_t len);
+
+// SD-Aufrufe des Schreibpfads mit Zeitmessung (Latenz-Histogramme, Erkennung langsamer Karten);
+// mkdir/remove: logSdMkdir/logSdRemove (log_latency.h, auch für die Burst-Aufzeichnung)
+static File sdOpen(const String& path, const char* mode) {
+  const uint32_t t0 = micros();
+  File f = SD.open(path, mode);
+  logLatencyAdd(LOG_OP_OPEN, micros() - t0);
+  return f;
+}
+
+static size_t sdWrite(File& f, const uint8_t* buf, size_t len) {
+  const uint32_t t0 = micros();
+  const size_t n = f.write(buf, len);
+  logLatencyAdd(LOG_OP_WRITE, micros() - t0);
+  return n;
+}
+
+static void sdClose(File& f) {
+  const uint32_t t0 = micros();
+  f.close();
+  logLatencyAdd(LOG_OP_CLOSE, micros() - t0);
 }
 
 static void ensureLogDir() {
-  if (!SD.exists("/log")) SD.mkdir("/log");
+  if (!SD.exists("/log")) logSdMkdir("/log");
 }
 
-static void writeHeaderIfNeeded(const AppConfig& cfg, File& f) {
-  if (g_headerWritten) return;
+// true, wenn die CSV einen Header mit Prüfsummenspalte hat (ältere Dateien: ohne)
+static bool csvHasCrc(const String& path) {
+  File r = SD.open(path, FILE_READ);
+  if (!r) return false;
+  LogCsvReader rd(r);
+  const bool crc = rd.next() && rd.find(LOG_CSV_COL_CRC) >= 0;
+  r.close();
+  return crc;
+}
+
+// liefert die Anzahl geschriebener Bytes (0 = Header war schon da)
+static size_t writeHeaderIfNeeded(const String& path, uint32_t metricMask, File& f) {
+  if (g_headerWritten) return 0;
 
-  // falls Datei schon Inhalt hat -> Header als vorhanden ansehen
+  // falls Datei schon Inhalt hat -> Header als vorhanden ansehen, dessen Format gilt weiter
   if (f.size() > 0) {
     g_headerWritten = true;
-    return;
+    g_csvCrc = csvHasCrc(path);
+    return 0;
   }
 
   String h = "epoch";
-  if (cfg.log_metric_mask & LOG_TEMP)  h += ",temp_c";
-  if (cfg.log_metric_mask & LOG_HUM)   h += ",hum_rh";
-  if (cfg.log_metric_mask & LOG_PRESS) h += ",press_hpa";
-  if (cfg.log_metric_mask & LOG_CO2)   h += ",co2_ppm";
+  if (metricMask & LOG_TEMP)  h += ",temp_c";
+  if (metricMask & LOG_HUM)   h += ",hum_rh";
+  if (metricMask & LOG_PRESS) h += ",press_hpa";
+  if (metricMask & LOG_CO2)   h += ",co2_ppm";
+  h += ",";
+  h += LOG_CSV_COL_CRC;
   h += "\n";
+  g_csvCrc = true;
 
-  f.print(h);
+  sdWrite(f, (const uint8_t*)h.c_str(), h.length());
   g_headerWritten = true;
+  return h.length();
 }
 
-static void appendLine(const AppConfig& cfg, const SensorData& d) {
-  if (!g_sd_ok) return;
-  if (!timeIsValid()) return;
+// eigenes Intervall einer Metrik (log_every_*) in Log-Zeitpunkten
+static uint8_t metricEvery(const AppConfig& cfg, int i) {
+  const uint8_t every[LOG_METRIC_COUNT] = { cfg.log_every_temp, cfg.log_every_hum, cfg.log_every_press, cfg.log_every_co2 };
+  return every[i] ? every[i] : 1;
+}
+
+// Metriken, die an diesem Log-Zeitpunkt dran sind (zählt die Log-Zeitpunkte mit)
+static uint32_t dueMetrics(const AppConfig& cfg) {
+  uint32_t due = 0;
+  for (int i = 0; i < LOG_METRIC_COUNT; i++) if (g_logTick % metricEvery(cfg, i) == 0) due |= LOG_METRICS[i].bit;
+  g_logTick++;
+  return due;
+}
+
+// Log-Zeitpunkt: Mittelwert der Messungen seit dem letzten, sonst (log_agg_mode = 0 oder keine
+// Messung im Intervall) der Momentanwert; mn/mx = Extremwerte bzw. der Momentanwert.
+// Metriken mit eigenem, längerem Intervall bleiben zwischen ihren Zeitpunkten NAN (dünn besetzte Zeile).
+static void makeSample(const AppConfig& cfg, const SensorData& d, uint32_t epoch,
+                       LogSample& s, LogSample& mn, LogSample& mx) {
+  const float vals[LOG_METRIC_COUNT] = { d.temperature_c, d.humidity_rh, d.pressure_hpa, d.co2_ppm };
+  const uint32_t due = dueMetrics(cfg);
+  LogSample mean;
+  if (cfg.log_agg_mode != LOG_AGG_LAST) g_agg.take(mean, mn, mx, due);
+  else g_agg.reset();
 
-  const String day = dayStringLocal();
-  if (day != g_curDay) {
-    g_curDay = day;
-    g_headerWritten = false;
+  s.epoch = mn.epoch = mx.epoch = epoch;
+  for (int i = 0; i < LOG_METRIC_COUNT; i++) {
+    const bool on = (cfg.log_metric_mask & due & LOG_METRICS[i].bit) != 0;
+    const bool agg = on && !isnan(mean.v[i]);
+    s.v[i]  = !on ? NAN : agg ? mean.v[i] : vals[i];
+    mn.v[i] = agg ? mn.v[i] : s.v[i];
+    mx.v[i] = agg ? mx.v[i] : s.v[i];
   }
+}
 
-  ensureLogDir();
+// SD.open im Schreibpfad; /log nur anlegen, wenn das Öffnen scheitert (Karte getauscht, Ordner gelöscht)
+static File openLog(const String& path, const char* mode) {
+  g_stats.fileOpens++;
+  File f = sdOpen(path, mode);
+  if (!f) {
+    ensureLogDir();
+    f = sdOpen(path, mode);
+  }
+  if (!f) Serial.println("[logger] SD.open FAILED: " + path);
+  return f;
+}
+
+// liefert die geschriebenen CSV-Bytes, idxBytes = neue Indexbytes
+static uint32_t appendCsv(uint32_t metricMask, const String& day, const LogSample* rows, uint8_t n, uint32_t& idxBytes) {
   const String path = logPathForDay(day);
 
-  Serial.println("[logger] try write: " + path);
-  Serial.println("[logger] /log exists? " + String(SD.exists("/log")));
+  // nach Reboot / Tageswechsel: Index gegen die CSV prüfen, ggf. neu aufbauen
+  if (!g_idxReady) {
+    logIndexEnsure(day);
+    LogIndexEntry last;
+    g_idxNextEpoch = logIndexLast(day, last) ? last.epoch + LOG_INDEX_STEP_SEC : 0;
+    g_idxReady = true;
+  }
 
-  File f = SD.open(path, FILE_APPEND);
-    if (!f) {
-    Serial.println("[logger] SD.open FAILED: " + path);
-    return;
+  File f = openLog(path, FILE_APPEND);
+  if (!f) return 0;
+
+  // size() vor dem Schreiben: gepufferte Daten zählen dort noch nicht mit
+  const uint32_t size0 = (uint32_t)f.size();
+  uint32_t lineOff = size0 + (uint32_t)writeHeaderIfNeeded(path, metricMask, f);
+
+  LogIndexEntry idx[LOG_WB_CAPACITY];
+  uint8_t idxCount = 0;
+
+  char buf[512];
+  size_t len = 0;
+  for (uint8_t r = 0; r < n; r++) {
+    const LogSample& s = rows[r];
+    // Platz für den ungünstigsten Fall: "%.2f" von ±FLT_MAX sind 43 Zeichen je Wert
+    char line[12 + LOG_METRIC_COUNT * 48 + 8];
+    int k = snprintf(line, sizeof(line), "%lu", (unsigned long)s.epoch);
+    for (int i = 0; i < LOG_METRIC_COUNT; i++) {
+      if (!(metricMask & LOG_METRICS[i].bit)) continue;
+      line[k++] = ',';
+      // wenn NAN -> leer lassen (",")
+      if (!isnan(s.v[i])) k += snprintf(line + k, sizeof(line) - k, "%.2f", (double)s.v[i]);
+    }
+    if (g_csvCrc) k += snprintf(line + k, sizeof(line) - k, ",%04X", logCrc16((const uint8_t*)line, (size_t)k));
+    line[k++] = '\n';
+
+    if (s.epoch >= g_idxNextEpoch) {
+      idx[idxCount++] = LogIndexEntry { s.epoch, lineOff };
+      g_idxNextEpoch = s.epoch + LOG_INDEX_STEP_SEC;
+    }
+    lineOff += (uint32_t)k;
+
+    if (len + (size_t)k > sizeof(buf)) { sdWrite(f, (const uint8_t*)buf, len); len = 0; }
+    memcpy(buf + len, line, (size_t)k);
+    len += (size_t)k;
   }
-  Serial.println("[logger] SD.open OK");
+  if (len) sdWrite(f, (const uint8_t*)buf, len);
+  sdClose(f);
 
+  for (uint8_t i = 0; i < idxCount; i++) if (logIndexAppend(day, idx[i])) idxBytes += sizeof(LogIndexEntry);
+  return lineOff - size0;
+}
 
-  writeHeaderIfNeeded(cfg, f);
+// ===== Vorbelegung (log_prealloc) =====
+// .bin/.gor werden beim ersten Schreiben des Tages einmal mit Nullen auf die erwartete Größe gebracht:
+// die FAT-Kette wächst dann nicht mehr je Schreibvorgang, die Datei liegt möglichst zusammenhängend.
+// Geschrieben wird ab dem logischen Ende; beim Tageswechsel wird dort gekürzt.
+static constexpr uint32_t PREALLOC_DAY_SEC = 25ul * 3600ul;   // längster Tag (Zeitumstellung)
 
-  time_t now = time(nullptr);
-  String line = String((uint32_t)now);
-
-  auto addVal = [&](bool enabled, float v) {
-    if (!enabled) return;
-    line += ",";
-    if (!isnan(v)) line += String(v, 2);
-    // wenn NAN -> leer lassen (",")
-  };
-
-  addVal(cfg.log_metric_mask & LOG_TEMP,  d.temperature_c);
-  addVal(cfg.log_metric_mask & LOG_HUM,   d.humidity_rh);
-  addVal(cfg.log_metric_mask & LOG_PRESS, d.pressure_hpa);
-  addVal(cfg.log_metric_mask & LOG_CO2,   d.co2_ppm);
-
-  line += "\n";
-  f.print(line);
+// erwartete Tagesgröße: Samples je Tag * Recordgröße der Metrikmaske;
+// .gor braucht je nach Verlauf ~40 % davon -> mit der Hälfte gerechnet
+static uint32_t preallocBytes(uint32_t metricMask, bool gor) {
+  const uint32_t sec = (uint32_t)(g_intervalMin ? g_intervalMin : 1) * 60ul;
+  LogBinHeader h;
+  logBinInitHeader(h, metricMask, 0);
+  const uint32_t recs = PREALLOC_DAY_SEC / sec + 1;
+  if (!gor) return h.header_size + recs * h.rec_size;
+  return (recs * h.rec_size / 2 / LOG_GOR_BLOCK_SIZE + 1) * LOG_GOR_BLOCK_SIZE;
+}
+
+// Datei von size0 bis size mit Nullen verlängern; liefert die neue Größe
+static uint32_t preallocate(File& f, uint32_t size0, uint32_t size) {
+  if (size0 >= size) return size0;
+  uint8_t zero[LOG_GOR_BLOCK_SIZE] = {};
+  uint32_t sz = size0;
+  f.seek(sz);
+  while (sz < size) {
+    const uint32_t k = (size - sz < sizeof(zero)) ? size - sz : sizeof(zero);
+    if (sdWrite(f, zero, k) != k) break;
+    sz += k;
+  }
+  return sz;
+}
+
+// liefert das Wachstum der Datei in Bytes
+static uint32_t appendBin(uint32_t metricMask, const String& day, const LogSample* rows, uint8_t n) {
+  const String path = logPathForDay(day, ".bin");
+  const bool exists = SD.exists(path);
+
+  // nach Reboot / Tageswechsel: Header einer bestehenden Datei übernehmen (deren Maske gilt weiter),
+  // weiter geht es am logischen Ende (vorbelegte Datei: erster leerer Record)
+  if (!g_binHdrValid && exists) {
+    File r = SD.open(path, FILE_READ);
+    if (r && r.size() > 0) {
+      if (!logBinReadHeader(r, g_binHdr)) {
+        r.close();
+        Serial.println("[logger] bin header ungueltig: " + path);
+        return 0;
+      }
+      g_binEnd = g_binHdr.header_size + logBinRecordCount(r, g_binHdr) * g_binHdr.rec_size;
+      g_binHdrValid = true;
+    }
+    if (r) r.close();
+  }
+
+  File f = openLog(path, exists ? "r+" : FILE_WRITE);
+  if (!f) return 0;
+
+  // size() vor dem Schreiben: gepufferte Daten zählen dort noch nicht mit
+  const uint32_t size0 = (uint32_t)f.size();
+  uint32_t size1 = size0;
+  if (size0 == 0) {
+    logBinInitHeader(g_binHdr, metricMask, (uint32_t)localMidnight((time_t)rows[0].epoch));
+    sdWrite(f, (const uint8_t*)&g_binHdr, sizeof(g_binHdr));
+    g_binEnd = size1 = sizeof(g_binHdr);
+    g_binHdrValid = true;
+  }
+  if (g_prealloc) size1 = preallocate(f, size1, preallocBytes(g_binHdr.mask, false));
+
+  uint8_t buf[LOG_WB_CAPACITY * LOG_BIN_MAX_REC];
+  size_t len = 0;
+  for (uint8_t r = 0; r < n; r++) len += logBinEncode(g_binHdr, rows[r], buf + len);
+  f.seek(g_binEnd);
+  g_binEnd += sdWrite(f, buf, len);
+  sdClose(f);
+  if (g_binEnd > size1) size1 = g_binEnd;
+  return size1 - size0;
+}
+
+// Hüllkurve: je Sample ein Min- und ein Max-Record; liefert die geschriebenen Bytes (ohne Vorbelegung)
+static uint32_t appendEnv(uint32_t metricMask, const String& day, const LogSample* mn, const LogSample* mx, uint8_t n) {
+  const String path = logPathForDay(day, LOG_ENV_EXT);
+
+  // bestehende Datei: deren Maske gilt weiter
+  if (!g_envHdrValid && SD.exists(path)) {
+    File r = SD.open(path, FILE_READ);
+    if (r && r.size() > 0) {
+      if (!logBinReadHeader(r, g_envHdr)) {
+        r.close();
+        Serial.println("[logger] env header ungueltig: " + path);
+        return 0;
+      }
+      g_envHdrValid = true;
+    }
+    if (r) r.close();
+  }
+
+  File f = openLog(path, FILE_APPEND);
+  if (!f) return 0;
+
+  uint32_t bytes = 0;
+  if (f.size() == 0) {
+    logBinInitHeader(g_envHdr, metricMask, (uint32_t)localMidnight((time_t)mn[0].epoch));
+    bytes += sdWrite(f, (const uint8_t*)&g_envHdr, sizeof(g_envHdr));
+    g_envHdrValid = true;
+  }
+
+  uint8_t buf[LOG_WB_CAPACITY * LOG_BIN_MAX_REC];
+  size_t len = 0;
+  for (uint8_t r = 0; r < n; r++) {
+    if (len + 2 * g_envHdr.rec_size > sizeof(buf)) { bytes += sdWrite(f, buf, len); len = 0; }
+    len += logBinEncode(g_envHdr, mn[r], buf + len);
+    len += logBinEncode(g_envHdr, mx[r], buf + len);
+  }
+  if (len) bytes += sdWrite(f, buf, len);
+  sdClose(f);
+  return bytes;
+}
+
+// liefert das Wachstum der Datei in Bytes
+static uint32_t appendGor(uint32_t metricMask, const String& day, const LogSample* rows, uint8_t n) {
+  const String path = logPathForDay(day, ".gor");
+  const bool exists = SD.exists(path);
+
+  // nach Reboot / Tageswechsel: letzten Block vor dem logischen Ende weiterführen
+  if (!g_gorValid) {
+    g_gor.reset(metricMask);
+    g_gorBlockOff = 0;
+    if (exists) {
+      File r = SD.open(path, FILE_READ);
+      if (r) {
+        const uint32_t blocks = logGorBlockCount(r);
+        g_gorBlockOff = blocks * LOG_GOR_BLOCK_SIZE;   // angerissener Rest wird überschrieben
+        if (blocks) {
+          uint8_t blk[LOG_GOR_BLOCK_SIZE];
+          r.seek(g_gorBlockOff - LOG_GOR_BLOCK_SIZE);
+          if (r.read(blk, sizeof(blk)) == sizeof(blk) && g_gor.resume(blk)) g_gorBlockOff -= LOG_GOR_BLOCK_SIZE;
+          else g_gor.reset(metricMask);
+        }
+        r.close();
+      }
+    }
+    g_gorValid = true;
+  }
+
+  File f = openLog(path, exists ? "r+" : FILE_WRITE);
+  if (!f) return 0;
+  const uint32_t size0 = (uint32_t)f.size();
+  uint32_t size1 = size0;
+  if (g_prealloc) size1 = preallocate(f, size0, preallocBytes(metricMask, true));
+
+  for (uint8_t r = 0; r < n; r++) {
+    // Block voll oder Metriken geändert -> Block abschließen, neuer Block dahinter
+    if (g_gor.mask() != metricMask || !g_gor.add(rows[r])) {
+      if (!g_gor.empty()) {
+        f.seek(g_gorBlockOff);
+        sdWrite(f, g_gor.block(), LOG_GOR_BLOCK_SIZE);
+        g_gorBlockOff += LOG_GOR_BLOCK_SIZE;
+      }
+      g_gor.reset(metricMask);
+      g_gor.add(rows[r]);
+    }
+  }
+
+  f.seek(g_gorBlockOff);
+  sdWrite(f, g_gor.block(), LOG_GOR_BLOCK_SIZE);
+  sdClose(f);
+  if (g_gorBlockOff + LOG_GOR_BLOCK_SIZE > size1) size1 = g_gorBlockOff + LOG_GOR_BLOCK_SIZE;
+  return size1 - size0;
+}
+
+// Datei auf len kürzen, falls länger; true = gekürzt
+static bool trimTo(const String& path, uint32_t len) {
+  File f = SD.open(path, FILE_READ);
+  if (!f) return false;
+  const uint32_t size = (uint32_t)f.size();
   f.close();
+  return size > len && truncateLog(path, len);
+}
+
+// Tageswechsel: vorbelegten Rest von .bin/.gor des bisherigen Tags freigeben
+static void trimDayFiles() {
+  if (!g_curDay.length()) return;
+  bool trimmed = false;
+  if (g_binHdrValid) trimmed |= trimTo(logPathForDay(g_curDay, ".bin"), g_binEnd);
+  if (g_gorValid) trimmed |= trimTo(logPathForDay(g_curDay, ".gor"), g_gorBlockOff + (g_gor.empty() ? 0 : LOG_GOR_BLOCK_SIZE));
+  if (trimmed) logCatalogRefresh(g_curDay);
+}
+
+// Puffer durch die Kompression: fertige Zeilen nach g_sdtOut, final = zurückgehaltene mitnehmen
+static uint8_t sdtRun(bool final) {
+  uint8_t n = 0;
+  for (uint8_t i = 0; i < g_wbCount; i++) {
+    g_sdt.push(g_wb[i]);
+    while (g_sdt.pop(g_sdtOut[n])) n++;
+  }
+  if (final) {
+    g_sdt.finish();
+    while (g_sdt.pop(g_sdtOut[n])) n++;
+  }
+  g_stats.sdtIn = g_sdt.valuesIn();
+  g_stats.sdtKept = g_sdt.valuesKept();
+  return n;
+}
+
+// Kompression neu beginnen (nächstes Sample übernimmt log_sdt_* aus dem Auftrag); zurückgehaltene Zeilen verfallen
+static void sdtReset() {
+  const float off[LOG_METRIC_COUNT] = {};
+  memset(g_sdtTol, 0, sizeof(g_sdtTol));
+  g_sdt.configure(off);
+}
+
+// Puffer in alle Formate schreiben: je Format ein open/close für alle Samples.
+// final: auch die von der Kompression zurückgehaltenen Zeilen (Tages-/Konfigurationswechsel, loggerFlush)
+static void flushPending(bool final = false) {
+  if (!g_wbCount && !(final && g_sdt.pending())) return;
+  const uint32_t t0 = micros();
+
+  if (g_sd_ok) {
+    const String& day = g_wbDay;
+    if (day != g_curDay) {
+      trimDayFiles();
+      g_curDay = day;
+      g_headerWritten = false;
+      g_binHdrValid = false;
+      g_idxReady = false;
+      g_gorValid = false;
+      g_envHdrValid = false;
+    }
+
+    // Tagesdateien: mit Kompression nur die nötigen Punkte; Hüllkurve und Zusammenfassung aus allen
+    const LogSample* rows = g_wb;
+    uint8_t n = g_wbCount;
+    if (g_sdt.enabled()) {
+      n = sdtRun(final);
+      rows = g_sdtOut;
+    }
+
+    uint32_t csvBytes = 0, idxBytes = 0, binBytes = 0, gorBytes = 0, envBytes = 0;
+    for (uint8_t k = 0; k < n; k += LOG_WB_CAPACITY) {   // Zeilenpuffer der Formate: LOG_WB_CAPACITY
+      const uint8_t c = n - k < LOG_WB_CAPACITY ? n - k : LOG_WB_CAPACITY;
+      if (g_wbFormat & LOG_FMT_CSV) csvBytes += appendCsv(g_wbMetrics, day, rows + k, c, idxBytes);
+      if (g_wbFormat & LOG_FMT_BIN) binBytes += appendBin(g_wbMetrics, day, rows + k, c);
+      if (g_wbFormat & LOG_FMT_GOR) gorBytes += appendGor(g_wbMetrics, day, rows + k, c);
+    }
+    if (g_wbEnv && g_wbCount) envBytes = appendEnv(g_wbMetrics, day, g_wbMin, g_wbMax, g_wbCount);
+
+    // .bin/.gor wachsen mit Vorbelegung nicht bei jedem Schreiben -> Formate aus dem Auftrag
+    if (n || g_wbCount) {
+      const uint8_t written = (csvBytes ? LOG_FMT_CSV : 0) | (uint8_t)(n ? g_wbFormat & (LOG_FMT_BIN | LOG_FMT_GOR) : 0);
+      const uint32_t first = n ? rows[0].epoch : g_wb[0].epoch;
+      const uint32_t last = g_wbCount ? g_wb[g_wbCount - 1].epoch : rows[n - 1].epoch;
+      logCatalogAppend(day, written, n, first, last, csvBytes + idxBytes + binBytes + gorBytes + envBytes, csvBytes);
+    }
+
+    for (uint8_t i = 0; i < g_wbCount; i++) {
+      logRollupAdd(day, g_wb[i], g_wbEnv ? &g_wbMin[i] : nullptr, g_wbEnv ? &g_wbMax[i] : nullptr);
+    }
+    logRollupSync();
+  } else if (logFlashActive()) {
+    logFlashAppend(g_wbMetrics, g_wb, g_wbCount);
+  }
+
+  g_wbCount = 0;
+
+  const uint32_t dt = micros() - t0;
+  g_stats.flushes++;
+  g_stats.lastFlushUs = dt;
+  if (dt > g_stats.maxFlushUs) g_stats.maxFlushUs = dt;
+  g_stats.totalFlushUs += dt;
+}
+
+// Haltefenster in ms; bei langsamer Karte länger -> weniger, dafür größere Schreibvorgänge
+static uint32_t flushWindowMs() {
+  uint32_t sec = g_flushSec;
+  if (!g_sd_ok) {
+    if (sec < FLASH_FLUSH_MIN_SEC) sec = FLASH_FLUSH_MIN_SEC;
+  } else if (logLatencyHealth().slow) {
+    sec *= SLOW_FLUSH_FACTOR;
+    if (sec < SLOW_FLUSH_MIN_SEC) sec = SLOW_FLUSH_MIN_SEC;
+  }
+  return sec * 1000ul;
+}
+
+// (Storage-Task) Sample in den RAM-Puffer; geschrieben wird gebündelt (Größe, Alter, Tageswechsel, Neustart)
+static void storeSample(const LogJob& job) {
+  if (!storageOk()) return;
+
+  const LogSample& s = job.s;
+  const String day = logDayStringFromEpoch((time_t)s.epoch);
+  g_flushSec = job.flushSec;
+  g_prealloc = job.prealloc;
+  g_intervalMin = job.intervalMin;
+
+  // ein Puffer = ein Tag + eine Konfiguration; die Kompression läuft nicht über einen Wechsel hinweg
+  const bool sdtChanged = memcmp(job.sdtTol, g_sdtTol, sizeof(g_sdtTol)) != 0;
+  if ((g_wbCount || g_sdt.pending()) && (day != g_wbDay || job.format != g_wbFormat || job.metrics != g_wbMetrics ||
+                                         job.envelope != g_wbEnv || sdtChanged)) {
+    flushPending(true);
+  }
+  if (sdtChanged) {
+    memcpy(g_sdtTol, job.sdtTol, sizeof(g_sdtTol));
+    float tol[LOG_METRIC_COUNT];
+    for (int i = 0; i < LOG_METRIC_COUNT; i++) tol[i] = g_sdtTol[i] / 100.0f;
+    g_sdt.configure(tol);
+  }
+  if (!g_wbCount) {
+    g_wbDay = day;
+    g_wbFormat = job.format;
+    g_wbMetrics = job.metrics;
+    g_wbEnv = job.envelope;
+    g_wbFirstMs = millis();
+  }
+
+  g_wbMin[g_wbCount] = job.mn;
+  g_wbMax[g_wbCount] = job.mx;
+  g_wb[g_wbCount++] = s;
+  g_stats.samples++;
+
+  if (g_wbCount >= LOG_WB_CAPACITY || flushWindowMs() == 0) flushPending();
+}
+
+// (Storage-Task) Werte aus der Zeit ohne Uhrzeit: millis() -> epoch über den Bezugspunkt im Auftrag,
+// dann wie normale Samples puffern und gesammelt schreiben
+static void storePreTime(const LogJob& job) {
+  const uint8_t n = logPreCount();
+  uint32_t ok = 0, bad = 0;
+  for (uint8_t i = 0; i < n; i++) {
+    LogPreEntry e;
+    if (!logPreAt(i, e)) break;
+    const uint32_t ageMs = job.refMs - e.ms;   // unsigned: auch über den millis()-Überlauf (~49 Tage)
+    const int64_t ep = (int64_t)job.s.epoch - ageMs / 1000;
+    if (ep < 1672531200 || ep > (int64_t)job.s.epoch) { bad++; continue; }   // wie timeIsValid()
+
+    LogJob j = job;
+    j.s = e.s;
+    j.mn = e.mn;
+    j.mx = e.mx;
+    j.s.epoch = j.mn.epoch = j.mx.epoch = (uint32_t)ep;
+    storeSample(j);
+    ok++;
+  }
+  flushPending();
+  logPreClear(ok, bad);
+  g_preBusy = false;
+  if (n) Serial.printf("[logger] %lu Werte ohne Uhrzeit nachgetragen, %lu verworfen\n", (unsigned long)ok, (unsigned long)bad);
+}
+
+LoggerStats loggerGetStats() {
+  LoggerStats s = g_stats;
+  s.pending = g_wbCount;
+  s.queueDepth = g_queue ? (uint8_t)uxQueueMessagesWaiting(g_queue) : 0;
+  const LogArchiveStats a = logArchiveGetStats();
+  s.archiveDays = a.days;
+  s.archiveBytesIn = a.bytesIn;
+  s.archiveBytesOut = a.bytesOut;
+  const LogFlashStats f = logFlashGetStats();
+  s.flashActive = f.active && !g_sd_ok;
+  s.flashRecords = f.records;
+  s.flashBytes = f.bytes;
+  s.flashSegments = f.segments;
+  s.flashMaxSegments = f.maxSegments;
+  s.flashWraps = f.wraps;
+  s.flashWritten = f.written;
+  s.flashProgrammed = f.flashBytes;
+  const LogPreStats p = logPreGetStats();
+  s.preCapacity = p.capacity;
+  s.prePending = p.pending;
+  s.preRestored = p.restored;
+  s.preRecovered = p.recovered;
+  s.preDropped = p.dropped;
+  return s;
+}
+
+// Kartengröße/Belegung nur beim Einhängen abfragen (SD.usedBytes() liest die ganze FAT),
+// danach die Belegung über die Änderung der Log-Dateien laut Katalog nachführen
+static uint64_t g_sdTotal = 0;
+static uint64_t g_sdUsedAtMount = 0;
+static uint64_t g_logBytesAtMount = 0;
+
+static void readSdUsage() {
+  g_sdTotal = SD.totalBytes();
+  g_sdUsedAtMount = SD.usedBytes();
+  g_logBytesAtMount = logCatalogBytes();
 }
 
 LoggerSdInfo loggerGetSdInfo() {
   LoggerSdInfo s;
   s.ok = g_sd_ok;
   if (!g_sd_ok) return s;
-  s.total = SD.totalBytes();
-  s.used  = SD.usedBytes();
+  const int64_t used = (int64_t)g_sdUsedAtMount + (int64_t)logCatalogBytes() - (int64_t)g_logBytesAtMount;
+  s.total = g_sdTotal;
+  s.used  = (used > 0) ? (uint64_t)used : 0;
   s.free  = (s.total > s.used) ? (s.total - s.used) : 0;
   return s;
 }
 
 uint16_t loggerCountLogDays() {
   if (!g_sd_ok) return 0;
-  if (!SD.exists("/log")) return 0;   // <-- wichtig
-
-  File dir = SD.open("/log");
-  if (!dir) return 0;
-
-  uint16_t cnt = 0;
-  for (File f = dir.openNextFile(); f; f = dir.openNextFile()) {
-    if (!f.isDirectory()) cnt++;
-    f.close();
-  }
-  dir.close();
-  return cnt;
+  return logCatalogCount();
 }
 
 
@@ -146,10 +743,11 @@ static int32_t daysBetween(time_t a, time_t b) {
 }
 
 static bool parseDayFromFilename(const String& name, int& y, int& m, int& d) {
-  // erwartet: "YYYY-MM-DD.csv"
+  // erwartet: "YYYY-MM-DD.csv" (bzw. .bin / .gor / .idx / .env)
   if (name.length() != 14) return false;
   if (name.charAt(4) != '-' || name.charAt(7) != '-') return false;
-  if (!name.endsWith(".csv")) return false;
+  if (!name.endsWith(".csv") && !name.endsWith(".bin") && !name.endsWith(".gor") && !name.endsWith(".idx") &&
+      !name.endsWith(LOG_ENV_EXT)) return false;
 
   y = name.substring(0, 4).toInt();
   m = name.substring(5, 7).toInt();
@@ -166,51 +764,582 @@ static time_t dayStartEpochLocal(int y, int m, int d) {
   return mktime(&t); // local time
 }
 
-static void retentionCleanup(const AppConfig& cfg) {
+// ============================================================================
+// Aufräumen: fortsetzbare Zustandsmaschine. Je Schritt nur so viele Katalog-/Verzeichniseinträge
+// bzw. Löschungen, wie in log_cleanup_budget_ms passen (mind. einer).
+//  - Alter: Tage älter als log_retention_days werden gelöscht
+//  - Quota: liegt /log über log_max_bytes, wird der älteste Tag (nie der laufende) komplett entfernt,
+//    bis die Quota eingehalten ist
+// Normalerweise kommen ältester Tag und Gesamtgröße aus dem Katalog (CLEAN_PICK, O(1));
+// nur ohne vollständigen Katalog wird /log gescannt (CLEAN_SCAN).
+// ============================================================================
+enum CleanupState : uint8_t { CLEAN_IDLE, CLEAN_PICK, CLEAN_SCAN, CLEAN_EVICT };
+
+static constexpr uint32_t CLEAN_QUOTA_EVERY_MS = 3600ul * 1000ul;   // Quota-Prüfung max. 1x pro Stunde
+static const char* const  CLEAN_DAY_EXT[] = { ".csv", ".bin", ".gor", ".idx", LOG_ENV_EXT };
+
+static CleanupState g_clState = CLEAN_IDLE;
+static File     g_clDir;
+static uint16_t g_clRetention = 0;      // zuletzt übergebene Parameter
+static uint32_t g_clMaxBytes = 0;
+static uint16_t g_clBudgetMs = 20;
+static bool     g_clRequested = false;  // Durchgang sofort starten (Zeit gültig geworden, manuell)
+static uint32_t g_clLastPassMs = 0;
+static time_t   g_clNow = 0;            // Bezugszeit des laufenden Durchgangs
+static String   g_clToday;
+static uint64_t g_clTotal = 0;          // Summe der Dateien in /log nach Altersbereinigung
+static String   g_clOldest;             // ältester Tag außer dem laufenden
+static uint64_t g_clOldestBytes = 0;
+static uint8_t  g_clEvictExt = 0;
+static bool     g_clCatalog = false;    // Durchgang arbeitet mit dem Katalog
+
+static void cleanupSetParams(uint16_t retentionDays, uint32_t maxBytes, uint16_t budgetMs) {
+  g_clRetention = retentionDays;
+  g_clMaxBytes = maxBytes;
+  g_clBudgetMs = budgetMs;
+}
+
+static bool cleanupOpenScan() {
+  g_clDir = SD.open("/log");
+  g_clTotal = 0;
+  g_clOldest = "";
+  g_clOldestBytes = 0;
+  g_clState = g_clDir ? CLEAN_SCAN : CLEAN_IDLE;
+  return g_clState == CLEAN_SCAN;
+}
+
+static void cleanupFinish() {
+  if (g_clDir) g_clDir.close();
+  g_clState = CLEAN_IDLE;
+  g_stats.logBytes = g_clCatalog ? logCatalogBytes() : g_clTotal;
+  g_stats.cleanupPasses++;
+  logCatalogSync(true);
+}
+
+// Katalog: ältesten Tag prüfen; false = nichts (mehr) zu tun
+static bool cleanupPickOne() {
+  LogCatalogDay o;
+  if (!logCatalogOldest(o)) { cleanupFinish(); return false; }
+
+  const String day = logCatalogDayString(o.day);
+  const time_t dayEpoch = dayStartEpochLocal((int)(o.day / 10000u), (int)(o.day / 100u % 100u), (int)(o.day % 100u));
+  const bool tooOld = g_clRetention != 0 && daysBetween(g_clNow, dayEpoch) > (int32_t)g_clRetention;
+  const bool overQuota = g_clMaxBytes != 0 && logCatalogBytes() > g_clMaxBytes &&
+                         day != g_clToday && day != g_curDay;
+  if (!tooOld && !overQuota) { cleanupFinish(); return false; }
+
+  g_clOldest = day;
+  g_clOldestBytes = o.bytes;
+  g_clEvictExt = 0;
+  g_clState = CLEAN_EVICT;
+  return true;
+}
+
+// ein Verzeichniseintrag; false = Scan fertig
+static bool cleanupScanOne() {
+  File f = g_clDir.openNextFile();
+  if (!f) {
+    g_clDir.close();
+    if (g_clMaxBytes && g_clTotal > g_clMaxBytes && g_clOldest.length()) {
+      g_clState = CLEAN_EVICT;
+      g_clEvictExt = 0;
+    } else {
+      cleanupFinish();
+    }
+    return false;
+  }
+  if (f.isDirectory()) { f.close(); return true; }
+
+  String fn = String(f.name());
+  const uint32_t size = (uint32_t)f.size();
+  f.close();
+
+  // basename
+  int slash = fn.lastIndexOf('/');
+  String base = (slash >= 0) ? fn.substring(slash + 1) : fn;
+
+  int y,m,d;
+  if (logArchiveParseName(base, y, m)) {
+    // Monatsarchiv als Ganzes: weg, wenn auch sein letzter Tag zu alt ist; sonst Kandidat wie ein Tag
+    if (g_clRetention != 0 && daysBetween(g_clNow, dayStartEpochLocal(y, m + 1, 0)) > (int32_t)g_clRetention) {
+      if (logSdRemove(String("/log/") + base)) {
+        g_stats.cleanupFiles++;
+        g_stats.cleanupBytes += size;
+      }
+      return true;
+    }
+    g_clTotal += size;
+    const String month = base.substring(0, 7);
+    if (!g_clOldest.length() || month < g_clOldest) { g_clOldest = month; g_clOldestBytes = size; }
+    return true;
+  }
+  if (!parseDayFromFilename(base, y, m, d)) { g_clTotal += size; return true; }   // .sum u.ä. zählen mit
+
+  const int32_t ageDays = daysBetween(g_clNow, dayStartEpochLocal(y, m, d));
+  if (g_clRetention != 0 && ageDays > (int32_t)g_clRetention) {
+    logCatalogRemove(base.substring(0, 10));
+    if (logSdRemove(String("/log/") + base)) {
+      g_stats.cleanupFiles++;
+      g_stats.cleanupBytes += size;
+    }
+    return true;
+  }
+
+  g_clTotal += size;
+  const String day = base.substring(0, 10);
+  if (day == g_clToday || day == g_curDay) return true;
+  if (!g_clOldest.length() || day < g_clOldest) { g_clOldest = day; g_clOldestBytes = size; }
+  else if (day == g_clOldest) g_clOldestBytes += size;
+  return true;
+}
+
+// eine Datei des ältesten Tags löschen; false = Tag erledigt
+// (Scan ohne Katalog: g_clOldest kann ein ganzes Monatsarchiv "YYYY-MM" sein)
+static bool cleanupEvictOne() {
+  const bool month = g_clOldest.length() == 7;
+  if (!month && g_clEvictExt < sizeof(CLEAN_DAY_EXT) / sizeof(CLEAN_DAY_EXT[0])) {
+    const String p = logPathForDay(g_clOldest, CLEAN_DAY_EXT[g_clEvictExt++]);
+    if (SD.exists(p) && logSdRemove(p)) g_stats.cleanupFiles++;
+    return true;
+  }
+
+  if (month) {
+    if (logSdRemove(logArchivePath(g_clOldest))) g_stats.cleanupFiles++;
+  } else if (logArchiveDropDay(g_clOldest)) {
+    g_stats.cleanupFiles++;
+  }
+  g_stats.cleanupBytes += g_clOldestBytes;
+  logCatalogRemove(g_clOldest);
+
+  if (g_clCatalog) {
+    Serial.printf("[logger] cleanup: %s entfernt (%lu kB), /log jetzt %lu kB\n", g_clOldest.c_str(),
+                  (unsigned long)(g_clOldestBytes / 1024), (unsigned long)(logCatalogBytes() / 1024));
+    g_clState = CLEAN_PICK;
+    return false;
+  }
+
+  g_clTotal -= g_clOldestBytes;
+  Serial.printf("[logger] quota: %s entfernt (%lu kB), /log jetzt %lu kB\n", g_clOldest.c_str(),
+                (unsigned long)(g_clOldestBytes / 1024), (unsigned long)(g_clTotal / 1024));
+
+  // nächstältester Tag steht erst nach einem neuen Scan fest
+  if (g_clTotal > g_clMaxBytes) cleanupOpenScan();
+  else cleanupFinish();
+  return false;
+}
+
+static void cleanupMaybeStart() {
+  if (g_clState != CLEAN_IDLE) return;
   if (!g_sd_ok) return;
   if (!timeIsValid()) return;
 
-  // 0 = nie löschen
-  if (cfg.log_retention_days == 0) return;
+  const time_t now = time(nullptr);
+  const bool catalog  = logCatalogReady() && logCatalogComplete();
+  const bool ageDue   = g_clRetention != 0 &&
+                        (g_lastCleanupEpoch == 0 || daysBetween(now, (time_t)g_lastCleanupEpoch) >= 1);
+  // mit Katalog kostet die Quota-Prüfung nichts -> sofort, sonst höchstens stündlich scannen
+  const bool quotaDue = g_clMaxBytes != 0 &&
+                        (catalog ? (logCatalogBytes() > g_clMaxBytes && logCatalogCount() > 1)
+                                 : (g_clLastPassMs == 0 || (uint32_t)(millis() - g_clLastPassMs) >= CLEAN_QUOTA_EVERY_MS));
+  if (!g_clRequested && !ageDue && !quotaDue) return;
 
-  time_t now = time(nullptr);
+  g_clRequested = false;
+  if (ageDue) g_lastCleanupEpoch = (uint32_t)now;
+  g_clLastPassMs = millis() | 1;
+  g_clNow = now;
+  g_clToday = logDayStringFromEpoch(now);
+  g_clCatalog = catalog;
+  if (catalog) g_clState = CLEAN_PICK;
+  else cleanupOpenScan();
+}
+
+// (Storage-Task) eine Zeitscheibe Aufräumen
+static void cleanupStep() {
+  cleanupMaybeStart();
+  if (g_clState == CLEAN_IDLE) return;
+
+  const uint32_t t0 = micros();
+  const uint32_t budgetUs = (uint32_t)g_clBudgetMs * 1000ul;
+  do {
+    if (g_clState == CLEAN_PICK) cleanupPickOne();
+    else if (g_clState == CLEAN_SCAN) cleanupScanOne();
+    else if (g_clState == CLEAN_EVICT) cleanupEvictOne();
+  } while (g_clState != CLEAN_IDLE && (uint32_t)(micros() - t0) < budgetUs);
 
-  // max 1x pro Tag
-  if (g_lastCleanupEpoch != 0 && daysBetween(now, (time_t)g_lastCleanupEpoch) < 1) return;
-  g_lastCleanupEpoch = (uint32_t)now;
+  const uint32_t dt = micros() - t0;
+  g_stats.cleanupSteps++;
+  g_stats.cleanupLastStepUs = dt;
+  if (dt > g_stats.cleanupMaxStepUs) g_stats.cleanupMaxStepUs = dt;
+}
+
+// ============================================================================
+// Recovery: nach Stromausfall angerissene Records am Ende der letzten Tagesdatei kürzen.
+// Geprüft wird nur das Dateiende -> Laufzeit unabhängig von der Dateigröße.
+// ============================================================================
+static constexpr const char* SD_MOUNT          = "/sd";   // Standard-Mountpoint von SD.begin()
+static constexpr uint32_t    LOG_RECOVER_TAIL  = 1024;    // CSV: so viele Bytes am Ende
+static constexpr uint32_t    LOG_RECOVER_RECS  = 64;      // .bin: so viele Records am Ende
+
+// fs::File kann nicht kürzen -> über das VFS
+static bool truncateLog(const String& path, uint32_t len) {
+  return ::truncate((String(SD_MOUNT) + path).c_str(), (off_t)len) == 0;
+}
+
+// Datenzeile ohne Prüfsumme: mindestens "epoch," bzw. "epoch", keine Nullbytes
+static bool csvLinePlausible(const char* p, size_t n) {
+  if (memchr(p, '\0', n)) return false;
+  size_t i = 0;
+  while (i < n && isDigit(p[i])) i++;
+  return i > 0 && (i == n || p[i] == ',' || p[i] == '\r');
+}
+
+// neue Dateilänge (= sz, wenn alles in Ordnung)
+static uint32_t recoverCsv(File& f) {
+  const uint32_t sz = (uint32_t)f.size();
+  char buf[LOG_RECOVER_TAIL];
+
+  // Header: endet er nicht mit '\n', wurde schon der Header angerissen
+  f.seek(0);
+  const size_t hn = f.read((uint8_t*)buf, sz < LogCsvReader::MAX_LINE ? sz : LogCsvReader::MAX_LINE);
+  const char* nl = (const char*)memchr(buf, '\n', hn);
+  uint32_t dataStart = 0;
+  bool crc = false;
+  if (hn && !isDigit(buf[0])) {
+    if (!nl) return (sz < LogCsvReader::MAX_LINE) ? 0 : sz;
+    dataStart = (uint32_t)(nl - buf) + 1;
+    size_t he = (size_t)(nl - buf);
+    while (he && buf[he - 1] == '\r') he--;
+    const size_t cl = strlen(LOG_CSV_COL_CRC);
+    crc = he > cl && buf[he - cl - 1] == ',' && memcmp(buf + he - cl, LOG_CSV_COL_CRC, cl) == 0;
+  }
+  if (sz <= dataStart) return sz;
 
+  const uint32_t from = (sz - dataStart > LOG_RECOVER_TAIL) ? sz - LOG_RECOVER_TAIL : dataStart;
+  const size_t n = sz - from;
+  f.seek(from);
+  if (f.read((uint8_t*)buf, n) != n) return sz;
+
+  // von hinten: letzte Zeile prüfen, solange sie angerissen/ungültig ist abschneiden
+  size_t cut = n;
+  while (cut > 0) {
+    const bool terminated = (buf[cut - 1] == '\n');
+    const size_t le = terminated ? cut - 1 : cut;
+    size_t ls = le;
+    while (ls > 0 && buf[ls - 1] != '\n') ls--;
+    if (ls == 0 && from > dataStart) break;   // Zeilenanfang liegt vor dem Fenster
+
+    const bool ok = crc ? logCsvLineCrcOk(buf + ls, le - ls) : csvLinePlausible(buf + ls, le - ls);
+    if (terminated && ok) break;
+    cut = ls;
+  }
+  return from + (uint32_t)cut;
+}
+
+static uint32_t recoverBin(File& f) {
+  const uint32_t sz = (uint32_t)f.size();
+  if (sz < sizeof(LogBinHeader)) return 0;   // Header angerissen -> neu anlegen
+
+  LogBinHeader h;
+  if (!logBinReadHeader(f, h)) return sz;    // fremde Datei: nicht anfassen
+
+  uint32_t recs = logBinRecordCount(f, h);
+  uint8_t rec[LOG_BIN_MAX_REC];
+  for (uint32_t k = 0; k < LOG_RECOVER_RECS && recs > 0; k++) {
+    f.seek(h.header_size + (size_t)(recs - 1) * h.rec_size);
+    if (f.read(rec, h.rec_size) != h.rec_size) break;
+    uint32_t ep;
+    memcpy(&ep, rec, 4);
+    if (ep != 0 && logBinRecordOk(h, rec)) break;
+    recs--;
+  }
+  return h.header_size + recs * h.rec_size;
+}
+
+static uint32_t recoverGor(File& f) {
+  uint32_t blocks = logGorBlockCount(f);
+  if (!blocks) return 0;
+
+  // letzter Block wird in-place überschrieben: muss sich vollständig und passend zum Header dekodieren lassen
+  uint8_t blk[LOG_GOR_BLOCK_SIZE];
+  f.seek((blocks - 1) * LOG_GOR_BLOCK_SIZE);
+  LogGorDecoder dec;
+  bool ok = f.read(blk, sizeof(blk)) == sizeof(blk) && dec.begin(blk);
+  if (ok) {
+    LogSample s;
+    uint16_t n = 0;
+    while (dec.next(s)) n++;
+    ok = n == dec.header().count && (n == 0 || s.epoch == dec.header().last_epoch);
+  }
+  if (!ok) blocks--;
+  return blocks * LOG_GOR_BLOCK_SIZE;
+}
+
+static void recoverFile(const String& path, uint32_t (*check)(File&)) {
+  if (!SD.exists(path)) return;
+  File f = SD.open(path, FILE_READ);
+  if (!f) return;
+  const uint32_t sz = (uint32_t)f.size();
+  const uint32_t len = check(f);
+  f.close();
+  if (len >= sz) return;
+
+  const bool ok = truncateLog(path, len);
+  Serial.printf("[logger] recovery %s: %lu Bytes am Ende verworfen (%lu -> %lu)%s\n",
+                path.c_str(), (unsigned long)(sz - len), (unsigned long)sz, (unsigned long)len,
+                ok ? "" : " - Kürzen fehlgeschlagen");
+}
+
+// nur der jüngste Tag kann beim Stromausfall offen gewesen sein (Zeit ist beim Boot evtl. noch nicht gültig)
+static String recoverLastDay() {
   File dir = SD.open("/log");
-  if (!dir) return;
+  if (!dir) return "";
 
+  String last;
   for (File f = dir.openNextFile(); f; f = dir.openNextFile()) {
-    if (f.isDirectory()) { f.close(); continue; }
-
-    String fn = String(f.name());
+    if (!f.isDirectory()) {
+      String fn = String(f.name());
+      int slash = fn.lastIndexOf('/');
+      String base = (slash >= 0) ? fn.substring(slash + 1) : fn;
+      int y, m, d;
+      if (parseDayFromFilename(base, y, m, d) && !base.endsWith(".idx")) {
+        const String day = base.substring(0, 10);
+        if (day > last) last = day;
+      }
+    }
     f.close();
+  }
+  dir.close();
+  if (!last.length()) return last;
 
-    // basename
-    int slash = fn.lastIndexOf('/');
-    String base = (slash >= 0) ? fn.substring(slash + 1) : fn;
+  const uint32_t t0 = millis();
+  recoverFile(logPathForDay(last), recoverCsv);
+  recoverFile(logPathForDay(last, ".bin"), recoverBin);
+  recoverFile(logPathForDay(last, ".gor"), recoverGor);
+  recoverFile(logPathForDay(last, LOG_ENV_EXT), recoverBin);
+  Serial.printf("[logger] recovery %s geprüft (%lu ms)\n", last.c_str(), (unsigned long)(millis() - t0));
+  return last;
+}
+
+// ============================================================================
+// Storage-Task
+// ============================================================================
+static void handleJob(const LogJob& job) {
+  switch (job.type) {
+    case LOG_JOB_APPEND:
+      cleanupSetParams(job.retentionDays, job.maxBytes, job.cleanupBudgetMs);
+      g_arcDays = job.archiveDays;
+      g_arcCompress = job.archiveCompress;
+      logLatencySetThreshold(job.slowMs);
+      storeSample(job);
+      break;
+    case LOG_JOB_PRETIME:
+      cleanupSetParams(job.retentionDays, job.maxBytes, job.cleanupBudgetMs);
+      storePreTime(job);
+      break;
+    case LOG_JOB_FLUSH:
+      flushPending(true);     // inkl. der von der Kompression zurückgehaltenen Zeilen
+      logCatalogSync(true);   // vor Neustart o.ä.
+      break;
+    case LOG_JOB_CLEANUP:
+      cleanupSetParams(job.retentionDays, job.maxBytes, job.cleanupBudgetMs);
+      g_clRequested = true;
+      break;
+  }
+}
 
-    int y,m,d;
-    if (!parseDayFromFilename(base, y, m, d)) continue;
+static void storageTask(void*) {
+  LogJob job;
+  for (;;) {
+    const uint32_t waitMs = (g_clState != CLEAN_IDLE || logArchiveBusy()) ? STORAGE_BUSY_MS : STORAGE_IDLE_MS;
+    const bool got = xQueueReceive(g_queue, &job, pdMS_TO_TICKS(waitMs)) == pdTRUE;
 
-    time_t dayEpoch = dayStartEpochLocal(y, m, d);
-    int32_t ageDays = daysBetween(now, dayEpoch);
+    xSemaphoreTake(g_sdMutex, portMAX_DELAY);
+    if (got) handleJob(job);
 
-    if (ageDays > (int32_t)cfg.log_retention_days) {
-      SD.remove(String("/log/") + base);
+    // Haltefenster abgelaufen -> Puffer schreiben
+    if (g_wbCount && (uint32_t)(millis() - g_wbFirstMs) >= flushWindowMs()) flushPending();
+
+    // laufende Burst-Aufzeichnung blockweise aus dem Ring schreiben
+    if (g_sd_ok) logBurstStep();
+
+    // Aufräumen in Zeitscheiben (Alter/Quota)
+    cleanupStep();
+    logCatalogSync(false);
+
+    // Tageszusammenfassungen vergangener Tage nachrechnen, danach ältere Tage ins Monatsarchiv
+    if (g_sd_ok && timeIsValid()) {
+      logRollupBackfillStep(logDayStringFromEpoch(time(nullptr)));
+      logArchiveStep(time(nullptr), g_arcDays, g_arcCompress);
     }
+    xSemaphoreGive(g_sdMutex);
+
+    if (got && job.notify) xTaskNotifyGive(job.notify);
   }
+}
 
-  dir.close();
+// Auftrag an den Storage-Task; blockiert nie (Queue voll -> verwerfen + zählen)
+static bool enqueueJob(const LogJob& job) {
+  if (!g_queue) {
+    g_stats.dropped++;   // Storage-Task nicht gestartet
+    return false;
+  }
+
+  const uint32_t t0 = micros();
+  const bool ok = xQueueSend(g_queue, &job, 0) == pdTRUE;
+  const uint32_t dt = micros() - t0;
+
+  if (dt > g_stats.maxEnqueueUs) g_stats.maxEnqueueUs = dt;
+  if (!ok) {
+    g_stats.dropped++;
+    return false;
+  }
+  const uint8_t depth = (uint8_t)uxQueueMessagesWaiting(g_queue);
+  if (depth > g_stats.queueMax) g_stats.queueMax = depth;
+  return true;
+}
+
+// Konfiguration, mit der der Storage-Task Samples puffert und schreibt
+static void fillJobConfig(LogJob& job, const AppConfig& cfg) {
+  job.envelope = cfg.log_agg_mode == LOG_AGG_MINMAX;
+  job.format = cfg.log_format_mask;
+  job.metrics = cfg.log_metric_mask;
+  job.flushSec = cfg.log_flush_sec;
+  job.retentionDays = cfg.log_retention_days;
+  job.cleanupBudgetMs = cfg.log_cleanup_budget_ms;
+  job.maxBytes = cfg.log_max_bytes;
+  job.intervalMin = cfg.log_interval_min;
+  job.prealloc = cfg.log_prealloc;
+  job.archiveDays = cfg.log_archive_days;
+  job.archiveCompress = cfg.log_archive_compress;
+  job.slowMs = cfg.log_slow_ms;
+  job.sdtTol[0] = cfg.log_sdt_temp;
+  job.sdtTol[1] = cfg.log_sdt_hum;
+  job.sdtTol[2] = cfg.log_sdt_press;
+  job.sdtTol[3] = cfg.log_sdt_co2;
+}
+
+static void appendLine(const AppConfig& cfg, const SensorData& d) {
+  if (!storageOk()) return;
+  if (!timeIsValid()) return;
+
+  LogJob job {};
+  job.type = LOG_JOB_APPEND;
+  makeSample(cfg, d, (uint32_t)time(nullptr), job.s, job.mn, job.mx);
+  fillJobConfig(job, cfg);
+  enqueueJob(job);
+}
+
+// Log-Zeitpunkt ohne gültige Zeit: mit millis() merken (log_pretime.h)
+static void appendPreTime(const AppConfig& cfg, const SensorData& d) {
+  if (g_preBusy) return;
+  LogPreEntry e;
+  makeSample(cfg, d, 0, e.s, e.mn, e.mx);
+  e.ms = millis();
+  logPrePush(e);
+}
+
+// Zeit ist gültig geworden: gemerkte Werte in einem Auftrag an den Storage-Task
+static void replayPreTime(const AppConfig& cfg) {
+  if (!logPreCount() || g_preBusy) return;
+  LogJob job {};
+  job.type = LOG_JOB_PRETIME;
+  job.s.epoch = (uint32_t)time(nullptr);
+  job.refMs = millis();
+  fillJobConfig(job, cfg);
+  g_preBusy = true;
+  if (!enqueueJob(job)) g_preBusy = false;   // nächster Versuch beim nächsten Log-Zeitpunkt
+}
+
+static void requestCleanup(const AppConfig& cfg) {
+  LogJob job {};
+  job.type = LOG_JOB_CLEANUP;
+  job.retentionDays = cfg.log_retention_days;
+  job.cleanupBudgetMs = cfg.log_cleanup_budget_ms;
+  job.maxBytes = cfg.log_max_bytes;
+  enqueueJob(job);
+}
+
+// Flush ohne zu warten (Loop-Task): Puffer und zurückgehaltene Zeilen schreibt der Storage-Task
+static bool requestFlush() {
+  LogJob job {};
+  job.type = LOG_JOB_FLUSH;
+  return enqueueJob(job);
+}
+
+void loggerFlush() {
+  if (!g_queue) return;
+
+  LogJob job {};
+  job.type = LOG_JOB_FLUSH;
+  job.notify = xTaskGetCurrentTaskHandle();
+  if (!enqueueJob(job)) return;
+  ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(STORAGE_FLUSH_WAIT));
+}
+
+uint16_t loggerPendingCount() {
+  return g_sdt.pending() + g_wbCount;
+}
+
+bool loggerPendingGet(uint16_t i, LogSample& s, LogSample* mn, LogSample* mx) {
+  // zuerst die von der Kompression zurückgehaltenen Zeilen (älter als der Puffer);
+  // ihre Hüllkurve steht schon in der .env
+  const uint8_t held = g_sdt.pending();
+  if (i < held) {
+    if (!g_sdt.peek(i, s) || ((mn || mx) && g_wbEnv)) return false;
+    if (mn) *mn = s;
+    if (mx) *mx = s;
+    return true;
+  }
+  i -= held;
+  if (i >= g_wbCount) return false;
+  s = g_wb[i];
+  if (mn) *mn = g_wbEnv ? g_wbMin[i] : s;
+  if (mx) *mx = g_wbEnv ? g_wbMax[i] : s;
+  return true;
+}
+
+bool loggerSdLock(uint32_t timeoutMs) {
+  if (!g_sdMutex) return true;   // noch kein Task -> niemand sonst auf der SD
+  return xSemaphoreTake(g_sdMutex, pdMS_TO_TICKS(timeoutMs)) == pdTRUE;
+}
+
+void loggerSdUnlock() {
+  if (g_sdMutex) xSemaphoreGive(g_sdMutex);
+}
+
+// Queue + Storage-Task einmalig anlegen; schlägt das fehl, wird nicht geloggt
+static void startStorageTask() {
+  if (g_task) return;
+  if (!g_queue) g_queue = xQueueCreate(STORAGE_QUEUE_LEN, sizeof(LogJob));
+  if (!g_queue || xTaskCreate(storageTask, "log_sd", STORAGE_STACK, nullptr, 1, &g_task) != pdPASS) {
+    Serial.println("[logger] Storage-Task konnte nicht gestartet werden (kein Logging).");
+    g_sd_ok = false;
+    logFlashEnd();
+  }
 }
 
 void loggerBegin(const AppConfig& cfg) {
+  if (!g_sdMutex) g_sdMutex = xSemaphoreCreateMutex();
+  LoggerSdGuard lock;
+
   g_sd_ok = false;
+  g_wbCount = 0;
+  sdtReset();
   g_lastLogMs = 0;
   g_curDay = "";
   g_headerWritten = false;
+  g_binHdrValid = false;
+  g_idxReady = false;
+  g_gorValid = false;
+  g_envHdrValid = false;
+  g_agg.reset();
+  g_flushSec = cfg.log_flush_sec;
+  g_arcDays = cfg.log_archive_days;
+  g_arcCompress = cfg.log_archive_compress;
+  g_flashBudget = (uint32_t)cfg.log_flash_kb * 1024ul;
+  logLatencySetThreshold(cfg.log_slow_ms);
+  logPreBegin();
+  takeSdClockConfig(cfg);
 
   #if defined(PIN_SD_SCK) && defined(PIN_SD_MISO) && defined(PIN_SD_MOSI)
     SPI.begin(PIN_SD_SCK, PIN_SD_MISO, PIN_SD_MOSI, PIN_SD_CS);
@@ -218,18 +1347,31 @@ void loggerBegin(const AppConfig& cfg) {
     SPI.begin();
   #endif
 
-  if (!SD.begin(PIN_SD_CS, SPI, spiHz)) {
-    Serial.println("SD init fehlgeschlagen (kein Logging).");
-    return;
-  }
+  if (mountSd()) {
+    g_sd_ok = true;
+    logFlashEnd();
+    ensureLogDir();
+    logRollupReset();
+    logArchiveReset();
 
-  g_sd_ok = true;
-  ensureLogDir();
+    // Katalog laden/aufbauen, den zuletzt beschriebenen Tag gegen seine Dateien abgleichen
+    const String lastDay = recoverLastDay();
+    logCatalogBegin();
+    logCatalogRefresh(lastDay);
+    readSdUsage();
+
+    Serial.printf("SD OK: cardType=%u %.1f MHz total=%.2fMB used=%.2fMB\n",
+                  SD.cardType(), g_sdClock.hz / 1e6,
+                  g_sdTotal / 1024.0 / 1024.0,
+                  g_sdUsedAtMount / 1024.0 / 1024.0);
+  } else if (g_flashBudget && logFlashBegin(g_flashBudget)) {
+    Serial.println("SD init fehlgeschlagen -> Logging in den internen Flash (Ringspeicher).");
+  } else {
+    Serial.println("SD init fehlgeschlagen (kein Logging bis zum Rescan).");
+  }
 
-  Serial.printf("SD OK: cardType=%u total=%.2fMB used=%.2fMB\n",
-                SD.cardType(),
-                SD.totalBytes() / 1024.0 / 1024.0,
-                SD.usedBytes()  / 1024.0 / 1024.0);
+  // auch ohne Speicher: ein späterer loggerRescan() kann die Karte einhängen
+  startStorageTask();
 }
 
 
@@ -237,14 +1379,24 @@ void loggerLoop(const AppConfig& cfg, const SensorData& data) {
   static bool wasTimeValid = false;
   bool tv = timeIsValid();
   if (tv && !wasTimeValid) {
-  // Zeit wurde gerade gültig -> sofort einmal schreiben
+  // Zeit wurde gerade gültig -> Werte von davor nachtragen, sofort einmal schreiben
   wasTimeValid = true;
-  retentionCleanup(cfg);
+  requestCleanup(cfg);
+  if (cfg.log_enabled) replayPreTime(cfg);
   appendLine(cfg, data);
   g_lastLogMs = millis();
   return;
 }
-if (!tv) { wasTimeValid = false; return; }
+if (!tv) {
+  // ohne Uhrzeit im Intervall weiter messen, mit millis() gemerkt
+  wasTimeValid = false;
+  const uint32_t preMs = (uint32_t)cfg.log_interval_min * 60ul * 1000ul;
+  if (!cfg.log_enabled || !storageOk() || !preMs) { g_agg.reset(); return; }
+  if ((uint32_t)(millis() - g_lastLogMs) < preMs) return;
+  g_lastLogMs = millis();
+  appendPreTime(cfg, data);
+  return;
+}
 
   static uint32_t dbg=0;
   if (millis() - dbg > 10000) {
@@ -253,8 +1405,15 @@ if (!tv) { wasTimeValid = false; return; }
         cfg.log_enabled, g_sd_ok, cfg.log_interval_min, timeIsValid());
   }
 
-  if (!cfg.log_enabled) return;
-  if (!g_sd_ok) return;
+  // Logging aus -> einmal den Rest im Puffer schreiben lassen (Queue voll: nächster Durchlauf)
+  static bool flushOnOff = false;
+  if (!cfg.log_enabled) {
+    g_agg.reset();
+    if (flushOnOff && requestFlush()) flushOnOff = false;
+    return;
+  }
+  flushOnOff = true;
+  if (!storageOk()) { g_agg.reset(); return; }
 
   const uint32_t intervalMs = (uint32_t)cfg.log_interval_min * 60ul * 1000ul;
   if (intervalMs == 0) return;
@@ -262,31 +1421,96 @@ if (!tv) { wasTimeValid = false; return; }
   if ((uint32_t)(millis() - g_lastLogMs) < intervalMs) return;
   g_lastLogMs = millis();
 
-  retentionCleanup(cfg);
+  replayPreTime(cfg);   // falls beim Gültigwerden der Zeit die Queue voll war
   appendLine(cfg, data);
 }
 
+void loggerAccumulate(const SensorData& fresh) {
+  const float vals[LOG_METRIC_COUNT] = { fresh.temperature_c, fresh.humidity_rh, fresh.pressure_hpa, fresh.co2_ppm };
+  g_agg.add(vals);
+  logPreTouch(millis());
+}
+
+void loggerBurst(const AppConfig& cfg, const SensorData& live) {
+  LogBurstConfig b;
+  b.postSec = g_sd_ok ? cfg.log_burst_sec : 0;   // nur auf die SD
+  b.slopePpmMin = cfg.log_burst_slope;
+  b.everyH = cfg.log_burst_every_h;
+  b.metricMask = cfg.log_metric_mask;
+  logBurstPush(b, time(nullptr), live);
+}
+
 void loggerForceOnce(const AppConfig& cfg, const SensorData& data) {
   if (!cfg.log_enabled) return;
-  if (!g_sd_ok) return;
+  if (!storageOk()) return;
   if (!timeIsValid()) return;
 
-  retentionCleanup(cfg);
+  requestCleanup(cfg);
   appendLine(cfg, data);
+  loggerFlush();   // manuell ausgelöst -> sofort auf die Karte
 
   // Intervall-Timer neu setzen, damit nicht direkt nochmal geloggt wird
   g_lastLogMs = millis();
 }
 
-void loggerRescan(){
+void loggerRescan(const AppConfig& cfg){
+  loggerFlush();
+  LoggerSdGuard lock;
+  sdtReset();   // andere Karte: nicht an die Punkte der alten anschließen
+  takeSdClockConfig(cfg);
+  g_flashBudget = (uint32_t)cfg.log_flash_kb * 1024ul;
+
   g_sd_ok = false;
+  logBurstReset();
+  logRollupReset();   // offene Dateien schließen, bevor die Karte weg ist
+  logArchiveReset();
+  logCatalogReset();
+  if (g_clDir) g_clDir.close();
+  g_clState = CLEAN_IDLE;
   SD.end();
   delay(50);
-  if (!SD.begin(PIN_SD_CS, SPI, spiHz)) {
+  if (!mountSd()) {
     Serial.println("[logger] SD rescan failed");
+    if (g_flashBudget && !logFlashActive() && logFlashBegin(g_flashBudget)) {
+      Serial.println("[logger] Logging in den internen Flash (Ringspeicher).");
+      startStorageTask();
+    }
     return;
   }
   g_sd_ok = true;
+  startStorageTask();   // beim Start evtl. fehlgeschlagen
+  logFlashEnd();   // Karte wieder da -> ab jetzt dorthin, die Segmente im Flash bleiben liegen
   ensureLogDir();
-  Serial.println("[logger] SD rescan OK");
+  recoverLastDay();
+  logCatalogBegin(true);   // Karte evtl. am PC geändert -> Katalog neu aufbauen
+  readSdUsage();
+  g_curDay = "";   // andere Karte -> Tagesdateien neu prüfen
+  Serial.printf("[logger] SD rescan OK (%.1f MHz)\n", g_sdClock.hz / 1e6);
 }
+
+bool loggerStoreSdClock(AppConfig& cfg) {
+  if (!g_sd_ok || g_sdClock.fixed || !g_sdClock.hz) return false;
+  if (cfg.log_sd_auto_hz == g_sdClock.hz && cfg.log_sd_card == g_sdClock.cardId) return false;
+  cfg.log_sd_auto_hz = g_sdClock.hz;
+  cfg.log_sd_card = g_sdClock.cardId;
+  g_sdHzKnown = cfg.log_sd_auto_hz;
+  g_sdCardKnown = cfg.log_sd_card;
+  return saveConfig(cfg);
+}
+
+bool loggerSdBench() {
+  if (!g_sd_ok) return false;
+  loggerFlush();
+  LoggerSdGuard lock(10000);
+  if (!lock.held()) return false;
+  return logSdRunBench(g_sdClock.hz, g_sdBench);
+}
+
+String loggerSdClockJson() {
+  LoggerSdGuard lock;   // Zustand ändert sich nur beim Einhängen/Benchmark unter der Sperre
+  return logSdJson(g_sdClock, &g_sdBench);
+}
+
+LogSdBench loggerGetSdBench() { return g_sdBench; }
+
+uint32_t loggerSdHz() { return g_sd_ok ? g_sdClock.hz : 0; }
@@ -17,6 +17,7 @@
 #include "sensors_ctrl.h"
 #include "mqtt_client.h"
 #include "logger.h"
+#include "sample_ring.h"
 
 static WebServer server(80);
 static AppConfig cfg;
@@ -50,6 +51,7 @@ static bool wifiReallyConnected() {
 }
 
 void wifiResetAndReboot() {
+  loggerFlush();
   delay(200);
   ESP.restart();
 }
@@ -107,6 +109,7 @@ void setup() {
 
   // Logger init (falls der intern FS nutzt etc.)
   loggerBegin(cfg);
+  loggerStoreSdClock(cfg);   // neu ausgehandelten SD-Takt merken
 
   // mDNS/NTP/MQTT starten wir kontrolliert in loop() nach "stabil"
   netStarted = false;
@@ -130,9 +133,20 @@ void loop() {
     SensorData s = scdRead();
     if (!isnan(s.co2_ppm)) liveData.co2_ppm = s.co2_ppm;
 
+    // nur frische Werte in den Intervall-Mittelwert des Loggers (SCD liefert nicht jede Sekunde)
+    b.co2_ppm = s.co2_ppm;
+    loggerAccumulate(b);
+
+    // hochaufgelöster Verlauf (1h/live) im RAM
+    sampleRingPush(time(nullptr), liveData);
+    loggerBurst(cfg, liveData);
+
     lastReadMs = millis();
   }
 
+  // Logger auch ohne WLAN: SD/Flash brauchen kein Netz, ohne Uhrzeit puffert er bis NTP (log_pretime.h)
+  loggerLoop(cfg, liveData);
+
     // Wenn nicht verbunden: keine Netzwerk-Subsysteme laufen lassen,
   // aber Webserver + Portal müssen weiter laufen (handleClient läuft ja)
   if (!wifiMgrIsConnected()) {
@@ -177,9 +191,6 @@ if (!wifiMgrIsConnected()) ipPrinted = false;
   mqttLoop(cfg);
   ntpLoop();
 
-  // Logger (wenn du es online loggen willst: hier ist passend)
-  loggerLoop(cfg, liveData);
-
   // UDP/MQTT Publish nur wenn connected
   if (millis() - lastSend >= cfg.send_interval_ms) {
     lastSend = millis();
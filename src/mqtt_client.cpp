@@ -4,6 +4,7 @@
 #include <WiFiClientSecure.h>
 #include <PubSubClient.h>
 #include <ArduinoJson.h>
+#include "log_burst.h"
 
 // Forward declarations (wichtig für C++)
 static String safeSensorId(const AppConfig &cfg);
@@ -47,6 +48,20 @@ static String willTopic(const AppConfig &cfg) {
   return String("multisensor/") + safeSensorId(cfg) + "/status";
 }
 
+// multisensor/<sensor_id>/cmd/burst -> Burst-Aufzeichnung starten (Payload egal)
+static String burstTopic(const AppConfig &cfg) {
+  return baseTopic(cfg) + "/cmd/burst";
+}
+
+static void onMessage(char* topic, byte* payload, unsigned int len) {
+  (void)payload;
+  (void)len;
+  if (String(topic).endsWith("/cmd/burst")) {
+    const bool ok = logBurstTrigger(LOG_BURST_MQTT);
+    Serial.printf("[mqtt] burst %s\n", ok ? "angefordert" : "aus (log_burst_sec = 0)");
+  }
+}
+
 void mqttBegin(const AppConfig &cfg) {
   useTls = cfg.mqtt_tls_enabled;
 
@@ -66,6 +81,8 @@ void mqttBegin(const AppConfig &cfg) {
 
   // Optional: Keepalive aus Config setzen (PubSubClient default 15s)
   mqtt.setKeepAlive(cfg.mqtt_keepalive);
+
+  mqtt.setCallback(onMessage);
 }
 
 void mqttLoop(const AppConfig &cfg) {
@@ -109,6 +126,7 @@ static bool mqttConnect(const AppConfig &cfg) {
 
   if (ok) {
     mqttPublishHADiscovery(cfg);
+    mqtt.subscribe(burstTopic(cfg).c_str());
   }
   
 
@@ -0,0 +1,19 @@
+#include <Arduino.h>
+#include <WebServer.h>
+#include "pages.h"
+#include "settings_config/settings_common.h"
+#include "logger.h"
+#include "log_latency.h"
+
+// /api/log/latency: Histogramme je SD-Operation + Bewertung (langsame Karte), z.B. für Fernabfrage
+void apiLogLatency(WebServer &server) {
+  AppConfig* cfg = settingsRequireCfgAndAuth(server);
+  if (!cfg) return;
+
+  if (!loggerSdOk()) {
+    server.send(503, "application/json", "{\"error\":\"sd_not_ready\"}");
+    return;
+  }
+
+  server.send(200, "application/json; charset=utf-8", logLatencyJson());
+}
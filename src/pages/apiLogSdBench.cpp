@@ -0,0 +1,19 @@
+#include <Arduino.h>
+#include <WebServer.h>
+#include "pages.h"
+#include "settings_config/settings_common.h"
+#include "logger.h"
+
+// /api/log/sdbench: SPI-Takt (fest/ausgehandelt, geprüfte Stufen) + letzter Benchmark,
+// zum Vergleich der Karten verschiedener Geräte. Benchmark starten: /settings/logger
+void apiLogSdBench(WebServer &server) {
+  AppConfig* cfg = settingsRequireCfgAndAuth(server);
+  if (!cfg) return;
+
+  if (!loggerSdOk()) {
+    server.send(503, "application/json", "{\"error\":\"sd_not_ready\"}");
+    return;
+  }
+
+  server.send(200, "application/json; charset=utf-8", loggerSdClockJson());
+}
@@ -4,6 +4,7 @@
 #include "pages.h"
 #include "auth.h"
 #include "settings.h"
+#include "logger.h"
 
 static File gUploadFile;
 
@@ -94,6 +95,7 @@ void pageFactoryResetDo(WebServer &server) {
   if (LittleFS.exists("/config.json")) LittleFS.remove("/config.json");
 
   server.send(200, "text/plain; charset=utf-8", "OK, reboot...");
+  loggerFlush();
   delay(300);
   ESP.restart();
 }
@@ -14,6 +14,7 @@ void pageLogger(WebServer &server) {
   html += "<div class='form-row'><label>Zeitraum</label>"
           "<select id='range'>"
           "<option value='1h'>Letzte 1 Stunde</option>"
+          "<option value='live'>Live (10 Minuten)</option>"
           "<option value='12h'>Letzte 12 Stunden</option>"
           "<option value='24h'>Letzte 24 Stunden</option>"
           "<option value='7d'>Letzte 7 Tage</option>"
@@ -38,6 +39,8 @@ void pageLogger(WebServer &server) {
   html += "<div class='hint warn logger-err' id='err' hidden></div>";
   html += "<canvas id='c' width='900' height='320' class='logger-canvas'></canvas>";
 
+  html += "<div class='actions'><a class='btn btn-secondary' href='/api/log/csv'>CSV-Export (heute)</a></div>";
+
   html += "</div>"; // card
 
   // Minimaler Canvas-Renderer (Linie + Achsen + Legend)
@@ -5,6 +5,7 @@
 #include "pages.h"
 #include "auth.h"
 #include "crypto_utils.h"
+#include "logger.h"
 
 static String gOtaToken;
 static uint32_t gOtaTokenAtMs = 0;
@@ -237,6 +238,7 @@ void pageOtaUpload(WebServer &server){
     html += pagesFooter();
 
     server.send(200, "text/html; charset=utf-8", html);
+    loggerFlush();
     delay(500);
     ESP.restart();
   }
@@ -6,6 +6,7 @@
 #include "pages.h"
 #include "auth.h"
 #include "version.h"
+#include "sample_ring.h"
 
 #include <esp_system.h>
 #include <esp_chip_info.h>
@@ -188,6 +189,19 @@ static String cardHeapDetails() {
   return h;
 }
 
+static String cardSampleRing() {
+  const uint16_t n = sampleRingCount();
+
+  String h;
+  h += "<div class='card'><h2>Verlaufspuffer (RAM)</h2><table class='tbl'>";
+  h += "<tr><th>Raster</th><td>" + String(SAMPLE_RING_STEP_SEC) + " s</td></tr>";
+  h += "<tr><th>Einträge</th><td>" + String(n) + " / " + String(SAMPLE_RING_CAPACITY) + "</td></tr>";
+  h += "<tr><th>Abgedeckt</th><td>" + String((uint32_t)n * SAMPLE_RING_STEP_SEC / 60) + " min</td></tr>";
+  h += "<tr><th>Speicher (fest)</th><td>" + fmtBytes(sampleRingBytes()) + "</td></tr>";
+  h += "</table></div>";
+  return h;
+}
+
 static String cardTasks() {
   String h;
   h += "<div class='card'><h2>Detailinformationen zu Tasks</h2>";
@@ -230,6 +244,7 @@ void pageSystemInfo(WebServer &server) {
   html += cardHardware();
   html += cardMemoryOverview();
   html += cardHeapDetails();
+  html += cardSampleRing();
   html += cardTasks();
 
   html += pagesFooter();
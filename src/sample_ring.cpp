@@ -0,0 +1,75 @@
+#include "sample_ring.h"
+#include "sensor_data.h"
+
+static const float SCALE[LOG_METRIC_COUNT] = { 100.0f, 100.0f, 10.0f, 1.0f };
+
+static SampleRingEntry g_ring[SAMPLE_RING_CAPACITY];
+static uint16_t g_head  = 0;   // nächster Schreibplatz
+static uint16_t g_count = 0;
+
+// laufendes Intervall
+static uint32_t g_slot = 0;
+static float    g_sum[LOG_METRIC_COUNT] = {};
+static uint8_t  g_n[LOG_METRIC_COUNT] = {};
+
+static int16_t pack(float v, float scale) {
+  if (isnan(v)) return INT16_MIN;
+  const float x = roundf(v * scale);
+  if (x <= (float)INT16_MIN) return INT16_MIN + 1;
+  if (x >= (float)INT16_MAX) return INT16_MAX;
+  return (int16_t)x;
+}
+
+static void commitSlot() {
+  SampleRingEntry& e = g_ring[g_head];
+  e.epoch = g_slot * SAMPLE_RING_STEP_SEC;
+  for (int i = 0; i < LOG_METRIC_COUNT; i++) {
+    e.v[i] = g_n[i] ? pack(g_sum[i] / g_n[i], SCALE[i]) : INT16_MIN;
+    g_sum[i] = 0;
+    g_n[i] = 0;
+  }
+  g_head = (uint16_t)((g_head + 1) % SAMPLE_RING_CAPACITY);
+  if (g_count < SAMPLE_RING_CAPACITY) g_count++;
+}
+
+void sampleRingPush(time_t now, const SensorData& d) {
+  if (now < 1672531200) return;   // Uhr noch nicht gestellt
+
+  const uint32_t slot = (uint32_t)now / SAMPLE_RING_STEP_SEC;
+  if (g_slot && slot != g_slot) {
+    // Zeitsprung (NTP) rückwärts: Puffer verwerfen, damit epoch aufsteigend bleibt
+    if (slot < g_slot) { g_count = 0; g_head = 0; }
+    else commitSlot();
+  }
+  g_slot = slot;
+
+  const float v[LOG_METRIC_COUNT] = { d.temperature_c, d.humidity_rh, d.pressure_hpa, d.co2_ppm };
+  for (int i = 0; i < LOG_METRIC_COUNT; i++) {
+    if (isnan(v[i])) continue;
+    g_sum[i] += v[i];
+    g_n[i]++;
+  }
+}
+
+uint16_t sampleRingCount() {
+  return g_count;
+}
+
+uint32_t sampleRingOldest() {
+  if (!g_count) return 0;
+  return g_ring[(g_head + SAMPLE_RING_CAPACITY - g_count) % SAMPLE_RING_CAPACITY].epoch;
+}
+
+bool sampleRingGet(uint16_t i, LogSample& s) {
+  if (i >= g_count) return false;
+  const SampleRingEntry& e = g_ring[(g_head + SAMPLE_RING_CAPACITY - g_count + i) % SAMPLE_RING_CAPACITY];
+  s.epoch = e.epoch;
+  for (int k = 0; k < LOG_METRIC_COUNT; k++) {
+    s.v[k] = (e.v[k] == INT16_MIN) ? NAN : (float)e.v[k] / SCALE[k];
+  }
+  return true;
+}
+
+size_t sampleRingBytes() {
+  return sizeof(g_ring);
+}
@@ -41,6 +41,33 @@ bool loadConfig(AppConfig &cfg) {
   cfg.log_metric_mask  = doc["log_metric_mask"] | cfg.log_metric_mask;
 
   cfg.log_retention_days = doc["log_retention_days"] | cfg.log_retention_days;
+  cfg.log_format_mask    = doc["log_format_mask"]    | cfg.log_format_mask;
+  cfg.log_format_mask &= LOG_FMT_ALL;
+  if (cfg.log_format_mask == 0) cfg.log_format_mask = LOG_FMT_CSV;
+  cfg.log_flush_sec      = doc["log_flush_sec"]      | cfg.log_flush_sec;
+  cfg.log_max_bytes      = doc["log_max_bytes"]      | cfg.log_max_bytes;
+  cfg.log_cleanup_budget_ms = doc["log_cleanup_budget_ms"] | cfg.log_cleanup_budget_ms;
+  if (cfg.log_cleanup_budget_ms == 0) cfg.log_cleanup_budget_ms = 1;
+  cfg.log_archive_days     = doc["log_archive_days"]     | cfg.log_archive_days;
+  cfg.log_archive_compress = doc["log_archive_compress"] | cfg.log_archive_compress;
+  cfg.log_prealloc         = doc["log_prealloc"] | cfg.log_prealloc;
+  cfg.log_slow_ms          = doc["log_slow_ms"] | cfg.log_slow_ms;
+  cfg.log_flash_kb         = doc["log_flash_kb"] | cfg.log_flash_kb;
+  cfg.log_sd_hz            = doc["log_sd_hz"] | cfg.log_sd_hz;
+  cfg.log_sd_auto_hz       = doc["log_sd_auto_hz"] | cfg.log_sd_auto_hz;
+  cfg.log_sd_card          = doc["log_sd_card"] | cfg.log_sd_card;
+  cfg.log_agg_mode         = doc["log_agg_mode"] | cfg.log_agg_mode;
+  cfg.log_every_temp       = doc["log_every_temp"] | cfg.log_every_temp;
+  cfg.log_every_hum        = doc["log_every_hum"] | cfg.log_every_hum;
+  cfg.log_every_press      = doc["log_every_press"] | cfg.log_every_press;
+  cfg.log_every_co2        = doc["log_every_co2"] | cfg.log_every_co2;
+  cfg.log_sdt_temp         = doc["log_sdt_temp"] | cfg.log_sdt_temp;
+  cfg.log_sdt_hum          = doc["log_sdt_hum"] | cfg.log_sdt_hum;
+  cfg.log_sdt_press        = doc["log_sdt_press"] | cfg.log_sdt_press;
+  cfg.log_sdt_co2          = doc["log_sdt_co2"] | cfg.log_sdt_co2;
+  cfg.log_burst_sec        = doc["log_burst_sec"] | cfg.log_burst_sec;
+  cfg.log_burst_slope      = doc["log_burst_slope"] | cfg.log_burst_slope;
+  cfg.log_burst_every_h    = doc["log_burst_every_h"] | cfg.log_burst_every_h;
 
   cfg.ui_root_order = doc["ui_root_order"] | cfg.ui_root_order;
   cfg.ui_info_order = doc["ui_info_order"] | cfg.ui_info_order;
@@ -116,6 +143,30 @@ bool saveConfig(const AppConfig &cfg) {
   doc["log_metric_mask"]  = cfg.log_metric_mask;
 
   doc["log_retention_days"] = cfg.log_retention_days;
+  doc["log_format_mask"]    = cfg.log_format_mask;
+  doc["log_flush_sec"]      = cfg.log_flush_sec;
+  doc["log_max_bytes"]      = cfg.log_max_bytes;
+  doc["log_cleanup_budget_ms"] = cfg.log_cleanup_budget_ms;
+  doc["log_archive_days"]      = cfg.log_archive_days;
+  doc["log_archive_compress"]  = cfg.log_archive_compress;
+  doc["log_prealloc"]          = cfg.log_prealloc;
+  doc["log_slow_ms"]           = cfg.log_slow_ms;
+  doc["log_flash_kb"]          = cfg.log_flash_kb;
+  doc["log_sd_hz"]             = cfg.log_sd_hz;
+  doc["log_sd_auto_hz"]        = cfg.log_sd_auto_hz;
+  doc["log_sd_card"]           = cfg.log_sd_card;
+  doc["log_agg_mode"]          = cfg.log_agg_mode;
+  doc["log_every_temp"]        = cfg.log_every_temp;
+  doc["log_every_hum"]         = cfg.log_every_hum;
+  doc["log_every_press"]       = cfg.log_every_press;
+  doc["log_every_co2"]         = cfg.log_every_co2;
+  doc["log_sdt_temp"]          = cfg.log_sdt_temp;
+  doc["log_sdt_hum"]           = cfg.log_sdt_hum;
+  doc["log_sdt_press"]         = cfg.log_sdt_press;
+  doc["log_sdt_co2"]           = cfg.log_sdt_co2;
+  doc["log_burst_sec"]         = cfg.log_burst_sec;
+  doc["log_burst_slope"]       = cfg.log_burst_slope;
+  doc["log_burst_every_h"]     = cfg.log_burst_every_h;
 
   doc["ui_root_order"] = cfg.ui_root_order;
   doc["ui_info_order"] = cfg.ui_info_order;  
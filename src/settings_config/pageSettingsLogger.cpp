@@ -5,6 +5,9 @@
 #include "logger.h"
 #include <math.h>
 #include "log_bits.h"
+#include "log_latency.h"
+#include "log_burst.h"
+#include "log_sdbench.h"
 
 // helpers wie bei UDP
 static bool isAvailFloat(float v) { return !isnan(v); }
@@ -28,6 +31,10 @@ static String fmtGB(uint64_t bytes) {
   return String(gb, 2) + " GB";
 }
 
+static String fmtMB(uint64_t bytes) {
+  return String((double)bytes / (1024.0 * 1024.0), 1) + " MB";
+}
+
 void pageSettingsLogger(WebServer &server) {
   AppConfig* cfg = settingsRequireCfgAndAuth(server);
   if (!cfg) return;
@@ -39,9 +46,13 @@ void pageSettingsLogger(WebServer &server) {
     const bool wantRescan = server.hasArg("sd_rescan");
 
   if (wantRescan) {
-    // hier: SD refresh / remount / infos neu lesen
-    // z.B. loggerRescan(); (bauen wir gleich)
+    loggerRescan(*cfg);
+    loggerStoreSdClock(*cfg);
     msg = "SD aktualisiert.";
+  } else if (server.hasArg("sd_bench")) {
+    msg = loggerSdBench() ? "SD-Benchmark fertig." : "SD-Benchmark fehlgeschlagen.";
+  } else if (server.hasArg("burst_now")) {
+    msg = logBurstTrigger(LOG_BURST_WEB) ? "Burst gestartet." : "Burst ist aus (erst Nachlauf wählen und speichern).";
   } else {
     // normales Speichern
     cfg->log_enabled = server.hasArg("log_enabled");
@@ -58,6 +69,121 @@ void pageSettingsLogger(WebServer &server) {
       cfg->log_retention_days = (uint16_t)v;
     }
 
+    if (server.hasArg("log_flush_sec")) {
+      int v = toIntSafe(server.arg("log_flush_sec"), (int)cfg->log_flush_sec);
+      if (v < 0) v = 0;
+      if (v > 3600) v = 3600;
+      cfg->log_flush_sec = (uint16_t)v;
+    }
+
+    if (server.hasArg("log_max_mb")) {
+      int v = toIntSafe(server.arg("log_max_mb"), (int)(cfg->log_max_bytes / (1024ul * 1024ul)));
+      if (v < 0) v = 0;
+      if (v > 4095) v = 4095;
+      cfg->log_max_bytes = (uint32_t)v * 1024ul * 1024ul;
+    }
+
+    if (server.hasArg("log_cleanup_budget_ms")) {
+      int v = toIntSafe(server.arg("log_cleanup_budget_ms"), (int)cfg->log_cleanup_budget_ms);
+      if (v < 1) v = 1;
+      if (v > 500) v = 500;
+      cfg->log_cleanup_budget_ms = (uint16_t)v;
+    }
+
+    if (server.hasArg("log_archive_days")) {
+      int v = toIntSafe(server.arg("log_archive_days"), (int)cfg->log_archive_days);
+      if (v < 0) v = 0;
+      if (v > 365) v = 365;
+      cfg->log_archive_days = (uint16_t)v;
+    }
+
+    if (server.hasArg("log_archive_compress")) {
+      cfg->log_archive_compress = toIntSafe(server.arg("log_archive_compress"), cfg->log_archive_compress ? 1 : 0) != 0;
+    }
+
+    if (server.hasArg("log_prealloc")) {
+      cfg->log_prealloc = toIntSafe(server.arg("log_prealloc"), cfg->log_prealloc ? 1 : 0) != 0;
+    }
+
+    if (server.hasArg("log_flash_kb")) {
+      int v = toIntSafe(server.arg("log_flash_kb"), (int)cfg->log_flash_kb);
+      if (v < 0) v = 0;
+      if (v > 1024) v = 1024;
+      cfg->log_flash_kb = (uint16_t)v;
+    }
+
+    if (server.hasArg("log_agg_mode")) {
+      int v = toIntSafe(server.arg("log_agg_mode"), (int)cfg->log_agg_mode);
+      if (v < 0) v = 0;
+      if (v > 2) v = 2;
+      cfg->log_agg_mode = (uint8_t)v;
+    }
+
+    if (server.hasArg("log_burst_sec")) {
+      int v = toIntSafe(server.arg("log_burst_sec"), (int)cfg->log_burst_sec);
+      if (v < 0) v = 0;
+      if (v > LOG_BURST_MAX_SEC) v = LOG_BURST_MAX_SEC;
+      cfg->log_burst_sec = (uint16_t)v;
+    }
+
+    if (server.hasArg("log_burst_slope")) {
+      int v = toIntSafe(server.arg("log_burst_slope"), (int)cfg->log_burst_slope);
+      if (v < 0) v = 0;
+      if (v > 5000) v = 5000;
+      cfg->log_burst_slope = (uint16_t)v;
+    }
+
+    if (server.hasArg("log_burst_every_h")) {
+      int v = toIntSafe(server.arg("log_burst_every_h"), (int)cfg->log_burst_every_h);
+      if (v < 0) v = 0;
+      if (v > 24) v = 24;
+      cfg->log_burst_every_h = (uint8_t)v;
+    }
+
+    if (server.hasArg("log_sd_hz")) {
+      int v = toIntSafe(server.arg("log_sd_hz"), (int)cfg->log_sd_hz);
+      if (v < 0) v = 0;
+      if (v > 40000000) v = 40000000;
+      cfg->log_sd_hz = (uint32_t)v;
+    }
+
+    if (server.hasArg("log_slow_ms")) {
+      int v = toIntSafe(server.arg("log_slow_ms"), (int)cfg->log_slow_ms);
+      if (v < 0) v = 0;
+      if (v > 5000) v = 5000;
+      cfg->log_slow_ms = (uint16_t)v;
+    }
+
+    if (server.hasArg("log_format_mask")) {
+      uint32_t fm = (uint32_t)toIntSafe(server.arg("log_format_mask"), (int)cfg->log_format_mask);
+      fm &= LOG_FMT_ALL;
+      cfg->log_format_mask = fm ? fm : LOG_FMT_CSV;
+    }
+
+    auto every = [&](const char* name, uint8_t& field) {
+      if (!server.hasArg(name)) return;
+      int v = toIntSafe(server.arg(name), (int)field);
+      if (v < 1) v = 1;
+      if (v > 60) v = 60;
+      field = (uint8_t)v;
+    };
+    every("log_every_temp",  cfg->log_every_temp);
+    every("log_every_hum",   cfg->log_every_hum);
+    every("log_every_press", cfg->log_every_press);
+    every("log_every_co2",   cfg->log_every_co2);
+
+    auto sdtTol = [&](const char* name, uint16_t& field) {
+      if (!server.hasArg(name)) return;
+      int v = toIntSafe(server.arg(name), (int)field);
+      if (v < 0) v = 0;
+      if (v > 10000) v = 10000;
+      field = (uint16_t)v;
+    };
+    sdtTol("log_sdt_temp",  cfg->log_sdt_temp);
+    sdtTol("log_sdt_hum",   cfg->log_sdt_hum);
+    sdtTol("log_sdt_press", cfg->log_sdt_press);
+    sdtTol("log_sdt_co2",   cfg->log_sdt_co2);
+
     uint32_t mask = 0;
     if (server.hasArg("m_temp"))  mask |= LOG_TEMP;
     if (server.hasArg("m_hum"))   mask |= LOG_HUM;
@@ -132,13 +258,261 @@ void pageSettingsLogger(WebServer &server) {
   optRet(365, "1 Jahr");
   html += "</select></div>";
 
+  // Speicher-Obergrenze (MB)
+  const int maxMb = (int)(cfg->log_max_bytes / (1024ul * 1024ul));
+  html += "<div class='form-row'><label>Max. Speicher</label><select name='log_max_mb'>";
+  auto optMax = [&](int v, const char* txt){
+    html += "<option value='" + String(v) + "' " + String(maxMb == v ? "selected" : "") + ">"
+         + txt + "</option>";
+  };
+  optMax(0,    "Unbegrenzt");
+  optMax(16,   "16 MB");
+  optMax(64,   "64 MB");
+  optMax(256,  "256 MB");
+  optMax(1024, "1 GB");
+  optMax(4095, "4 GB");
+  html += "</select></div>";
+
+  html += "<div class='form-row'><label>Aufräumen je Schritt</label><select name='log_cleanup_budget_ms'>";
+  auto optBudget = [&](int v, const char* txt){
+    html += "<option value='" + String(v) + "' " + String((int)cfg->log_cleanup_budget_ms == v ? "selected" : "") + ">"
+         + txt + "</option>";
+  };
+  optBudget(5,   "max. 5 ms");
+  optBudget(20,  "max. 20 ms");
+  optBudget(50,  "max. 50 ms");
+  optBudget(200, "max. 200 ms");
+  html += "</select></div>";
+  html += "<div class='hint'>Alte Tage werden in kleinen Schritten gelöscht; wird der Speicher knapp, "
+          "zuerst die ältesten.</div>";
+
+  // Dateiformat
+  html += "<div class='form-row'><label>Dateiformat</label><select name='log_format_mask'>";
+  auto optFmt = [&](uint32_t v, const char* txt){
+    html += "<option value='" + String(v) + "' " + String(cfg->log_format_mask == v ? "selected" : "") + ">"
+         + txt + "</option>";
+  };
+  optFmt(LOG_FMT_CSV,               "CSV");
+  optFmt(LOG_FMT_BIN,               "Binär (schneller Verlauf)");
+  optFmt(LOG_FMT_CSV | LOG_FMT_BIN, "CSV + Binär");
+  optFmt(LOG_FMT_GOR,               "Komprimiert (lange Aufbewahrung)");
+  optFmt(LOG_FMT_CSV | LOG_FMT_GOR, "CSV + Komprimiert");
+  html += "</select></div>";
+  html += "<div class='hint'>Binär- und komprimierte Dateien werden beim CSV-Export automatisch umgewandelt. "
+          "Komprimiert braucht bei 1-Minuten-Intervall nur einen Bruchteil des CSV-Platzes.</div>";
+
+  // Monatsarchiv
+  html += "<div class='form-row'><label>Monatsarchiv</label><select name='log_archive_days'>";
+  auto optArc = [&](int v, const char* txt){
+    html += "<option value='" + String(v) + "' " + String((int)cfg->log_archive_days == v ? "selected" : "") + ">"
+         + txt + "</option>";
+  };
+  optArc(0,  "Aus");
+  optArc(7,  "Tage älter als 7 Tage");
+  optArc(30, "Tage älter als 30 Tage");
+  optArc(90, "Tage älter als 90 Tage");
+  html += "</select></div>";
+  html += "<div class='form-row'><label>Archivformat</label><select name='log_archive_compress'>";
+  html += "<option value='1' " + String(cfg->log_archive_compress ? "selected" : "") + ">Komprimiert</option>";
+  html += "<option value='0' " + String(cfg->log_archive_compress ? "" : "selected") + ">Binär</option>";
+  html += "</select></div>";
+  html += "<div class='hint'>Ältere Tage werden im Hintergrund zu einer Datei je Monat zusammengefasst "
+          "(weniger Dateien auf der Karte). Verlauf und CSV-Export lesen sie dort weiter.</div>";
+
+  // Verdichtung je Intervall
+  html += "<div class='form-row'><label>Wert je Intervall</label><select name='log_agg_mode'>";
+  html += "<option value='0' " + String(cfg->log_agg_mode == 0 ? "selected" : "") + ">Momentanwert</option>";
+  html += "<option value='1' " + String(cfg->log_agg_mode == 1 ? "selected" : "") + ">Mittelwert</option>";
+  html += "<option value='2' " + String(cfg->log_agg_mode == 2 ? "selected" : "") + ">Mittelwert + Min/Max</option>";
+  html += "</select></div>";
+  html += "<div class='hint'>Gemessen wird jede Sekunde. Mittelwert: geloggt wird der Durchschnitt seit dem letzten Eintrag "
+          "statt eines zufälligen Augenblicks (wichtig bei langen Intervallen, z.B. CO2 beim Lüften). "
+          "Min/Max landen zusätzlich in einer eigenen Datei je Tag (/api/history?envelope=1).</div>";
+
+  // Burst-Aufzeichnung
+  html += "<div class='form-row'><label>Burst (1 s) Nachlauf</label><select name='log_burst_sec'>";
+  auto optBurst = [&](int v, const char* txt){
+    html += "<option value='" + String(v) + "' " + String((int)cfg->log_burst_sec == v ? "selected" : "") + ">"
+         + txt + "</option>";
+  };
+  optBurst(0,    "Aus");
+  optBurst(300,  "5 Minuten");
+  optBurst(900,  "15 Minuten");
+  optBurst(1800, "30 Minuten");
+  optBurst(3600, "1 Stunde");
+  html += "</select></div>";
+  html += "<div class='form-row'><label>Burst bei CO₂-Änderung</label><select name='log_burst_slope'>";
+  auto optSlope = [&](int v, const char* txt){
+    html += "<option value='" + String(v) + "' " + String((int)cfg->log_burst_slope == v ? "selected" : "") + ">"
+         + txt + "</option>";
+  };
+  optSlope(0,   "Aus");
+  optSlope(50,  "ab 50 ppm/min");
+  optSlope(100, "ab 100 ppm/min");
+  optSlope(200, "ab 200 ppm/min");
+  optSlope(500, "ab 500 ppm/min");
+  html += "</select></div>";
+  html += "<div class='form-row'><label>Burst nach Zeitplan</label><select name='log_burst_every_h'>";
+  auto optEvery = [&](int v, const char* txt){
+    html += "<option value='" + String(v) + "' " + String((int)cfg->log_burst_every_h == v ? "selected" : "") + ">"
+         + txt + "</option>";
+  };
+  optEvery(0,  "Aus");
+  optEvery(1,  "jede volle Stunde");
+  optEvery(6,  "alle 6 Stunden");
+  optEvery(24, "täglich um Mitternacht");
+  html += "</select></div>";
+  html += "<div class='hint'>Nur mit SD-Karte: bei einem Ereignis wird jede Sekunde gespeichert, ab 2 Minuten davor bis zum Nachlauf danach "
+          "(eigene Datei in /log/burst, höchstens 32, die älteste wird ersetzt). Auslöser: CO₂-Änderung (nur wenn CO₂ "
+          "unter „Zu speichernde Werte“ angehakt ist), Zeitplan, "
+          "Knopf unten oder MQTT <code>multisensor/&lt;id&gt;/cmd/burst</code>. Im Verlauf mit /api/history?captures=1.</div>";
+
+  // Vorbelegung
+  html += "<div class='form-row'><label>Tagesdatei vorbelegen</label><select name='log_prealloc'>";
+  html += "<option value='0' " + String(cfg->log_prealloc ? "" : "selected") + ">Aus</option>";
+  html += "<option value='1' " + String(cfg->log_prealloc ? "selected" : "") + ">Ein</option>";
+  html += "</select></div>";
+  html += "<div class='hint'>Binär-/Komprimiert-Dateien werden zu Tagesbeginn in voller Größe angelegt: "
+          "weniger FAT-Schreibzugriffe je Zeile, zusammenhängende Dateien für schnelleres Lesen. "
+          "Der ungenutzte Rest wird beim Tageswechsel freigegeben. CSV wächst weiter zeilenweise.</div>";
+
+  // Ersatz ohne SD
+  html += "<div class='form-row'><label>Ohne SD-Karte</label><select name='log_flash_kb'>";
+  auto optFlash = [&](int v, const char* txt){
+    html += "<option value='" + String(v) + "' " + String((int)cfg->log_flash_kb == v ? "selected" : "") + ">"
+         + txt + "</option>";
+  };
+  optFlash(0,   "Nicht loggen");
+  optFlash(256, "Interner Flash, 256 KB");
+  optFlash(512, "Interner Flash, 512 KB");
+  optFlash(768, "Interner Flash, 768 KB");
+  html += "</select></div>";
+  html += "<div class='hint'>Fehlt die Karte beim Start, wird in einen Ringspeicher im internen Flash geschrieben "
+          "(Binär, älteste Werte werden überschrieben; 512 KB ≈ 16 Tage bei 1 min, ≈ 16 Monate bei 30 min). "
+          "Geschrieben wird dort gesammelt (alle 32 Werte, spätestens nach 2 Stunden). Wirkt nach Neustart bzw. „SD aktualisieren“.</div>";
+
+  // SPI-Takt
+  html += "<div class='form-row'><label>SD-Takt</label><select name='log_sd_hz'>";
+  auto optHz = [&](uint32_t v, const char* txt){
+    html += "<option value='" + String(v) + "' " + String(cfg->log_sd_hz == v ? "selected" : "") + ">"
+         + txt + "</option>";
+  };
+  optHz(0,        "Automatisch");
+  optHz(4000000,  "4 MHz");
+  optHz(10000000, "10 MHz");
+  optHz(20000000, "20 MHz");
+  optHz(40000000, "40 MHz");
+  html += "</select></div>";
+  html += "<div class='hint'>Automatisch: beim Einhängen wird der Takt stufenweise erhöht und jeweils ein Testmuster "
+          "geschrieben und zurückgelesen; der schnellste fehlerfreie wird je Karte gemerkt. Wirkt nach Neustart bzw. „SD aktualisieren“.</div>";
+
+  // Langsame Karte
+  html += "<div class='form-row'><label>Langsame Karte ab</label><select name='log_slow_ms'>";
+  auto optSlow = [&](int v, const char* txt){
+    html += "<option value='" + String(v) + "' " + String((int)cfg->log_slow_ms == v ? "selected" : "") + ">"
+         + txt + "</option>";
+  };
+  optSlow(0,    "Aus");
+  optSlow(100,  "p99 über 100 ms");
+  optSlow(250,  "p99 über 250 ms");
+  optSlow(500,  "p99 über 500 ms");
+  optSlow(1000, "p99 über 1 s");
+  html += "</select></div>";
+  html += "<div class='hint'>Hängt die Karte häufig, wird seltener in größeren Blöcken geschrieben "
+          "(Schreibpuffer mind. 10 Minuten), bis sie wieder schnell antwortet.</div>";
+
+  // Schreibpuffer
+  html += "<div class='form-row'><label>Schreibpuffer</label><select name='log_flush_sec'>";
+  auto optFlush = [&](int v, const char* txt){
+    html += "<option value='" + String(v) + "' " + String((int)cfg->log_flush_sec == v ? "selected" : "") + ">"
+         + txt + "</option>";
+  };
+  optFlush(0,    "Aus (sofort schreiben)");
+  optFlush(60,   "max. 1 Minute");
+  optFlush(300,  "max. 5 Minuten");
+  optFlush(900,  "max. 15 Minuten");
+  optFlush(3600, "max. 1 Stunde");
+  html += "</select></div>";
+  html += "<div class='hint'>Werte werden im RAM gesammelt und gebündelt geschrieben. "
+          "Bei Stromausfall gehen höchstens die Werte dieses Zeitfensters verloren.</div>";
+
   // SD Hinweis
-  if (!sd.ok) {
-    html += "<div class='hint warn'>Keine SD-Karte erkannt. Logging funktioniert nur mit SD.</div>";
+  const LoggerStats fst = loggerGetStats();
+  if (fst.prePending || fst.preRecovered || fst.preDropped) {
+    html += "<div class='hint" + String(fst.preDropped ? " warn" : "") + "'>Ohne Uhrzeit gemessen: <b>" +
+            String(fst.prePending) + "/" + String(fst.preCapacity) + "</b> warten auf NTP" +
+            (fst.preRestored ? " (davon <b>" + String(fst.preRestored) + "</b> über Neustart gerettet)" : String("")) +
+            ", nachgetragen <b>" + String(fst.preRecovered) + "</b>, verworfen <b>" + String(fst.preDropped) + "</b></div>";
+  }
+  if (!sd.ok && fst.flashActive) {
+    html += "<div class='hint warn'>Keine SD-Karte erkannt. Es wird in den internen Flash geloggt: <b>" +
+            String(fst.flashRecords) + "</b> Werte in <b>" + String(fst.flashSegments) + "/" + String(fst.flashMaxSegments) +
+            "</b> Segmenten (" + fmtMB(fst.flashBytes) + "), übergelaufen <b>" + String(fst.flashWraps) +
+            "</b>, Flash beschrieben <b>" + fmtMB(fst.flashProgrammed) + "</b> für <b>" + fmtMB(fst.flashWritten) +
+            "</b> Daten.</div>";
+  } else if (!sd.ok) {
+    html += "<div class='hint warn'>Keine SD-Karte erkannt. Logging funktioniert nur mit SD oder dem internen Flash.</div>";
   } else {
     html += "<div class='hint'>SD: Gesamt <b>" + fmtGB(sd.total) + "</b>, Belegt <b>" + fmtGB(sd.used) +
             "</b> (" + String(usedPct) + "%), Frei <b>" + fmtGB(sd.free) + "</b>, Log-Tage <b>" + String(logDays) + "</b></div>";
+    const LoggerStats st = loggerGetStats();
+    if (st.samples) {
+      html += "<div class='hint'>Schreiben: <b>" + String(st.samples) + "</b> Werte in <b>" + String(st.flushes) +
+              "</b> Vorgängen, Ø <b>" + String((double)st.fileOpens / st.samples, 2) + "</b> Dateizugriffe und <b>" +
+              String((double)st.totalFlushUs / st.samples / 1000.0, 1) + " ms</b> Schreibzeit je Wert, max. <b>" +
+              String(st.maxFlushUs / 1000.0, 1) + " ms</b> je Vorgang, im Puffer <b>" + String(st.pending) + "</b></div>";
+    }
+    html += "<div class='hint" + String(st.dropped ? " warn" : "") + "'>Schreib-Queue: <b>" + String(st.queueDepth) +
+            "</b> wartend, max. <b>" + String(st.queueMax) + "</b>, verworfen <b>" + String(st.dropped) +
+            "</b>, Einreihen max. <b>" + String(st.maxEnqueueUs) + " µs</b></div>";
+    if (st.cleanupPasses) {
+      html += "<div class='hint'>Aufräumen: <b>" + String(st.cleanupPasses) + "</b> Durchgänge, <b>" +
+              String(st.cleanupFiles) + "</b> Dateien / <b>" + fmtMB(st.cleanupBytes) + "</b> gelöscht, /log <b>" +
+              fmtMB(st.logBytes) + "</b>, Schritt max. <b>" + String(st.cleanupMaxStepUs / 1000.0, 1) + " ms</b></div>";
+    }
+    if (st.archiveDays) {
+      html += "<div class='hint'>Monatsarchiv: <b>" + String(st.archiveDays) + "</b> Tage übernommen, <b>" +
+              fmtMB(st.archiveBytesIn) + "</b> → <b>" + fmtMB(st.archiveBytesOut) + "</b></div>";
+    }
+
+    // SD-Latenz je Operation (Details: /api/log/latency)
+    const LogLatencyHealth lh = logLatencyHealth();
+    String lat;
+    for (uint8_t op = 0; op < LOG_OP_COUNT; op++) {
+      const LogLatencyHist h = logLatencyGet(op);
+      if (!h.count) continue;
+      if (lat.length()) lat += ", ";
+      lat += String(logSdOpName(op)) + " <b>" + String(h.percentileUs(500) / 1000.0, 1) + "/" +
+             String(h.percentileUs(990) / 1000.0, 1) + "/" + String(h.maxUs / 1000.0, 1) + "</b>";
+    }
+    if (lat.length()) {
+      html += "<div class='hint" + String(lh.slow ? " warn" : "") + "'>SD-Latenz p50/p99/max (ms): " + lat +
+              ". Hänger <b>" + String(lh.stalls) + "</b>, langsame Phasen <b>" + String(lh.slowEvents) + "</b>" +
+              (lh.slow ? " – <b>Karte langsam, größere Schreibblöcke aktiv</b>" : "") +
+              " (<a href='/api/log/latency'>JSON</a>)</div>";
+    }
+    const LogBurstStats bs = logBurstGetStats();
+    if (bs.lastTrigger) {
+      html += "<div class='hint" + String(bs.overruns ? " warn" : "") + "'>Burst: " +
+              (bs.active ? String("<b>läuft</b> (") + logBurstReasonName(bs.reason) + ")" : String("bereit")) +
+              ", Aufzeichnungen <b>" + String(bs.captures) + "</b>, Sekunden <b>" + String(bs.samples) +
+              "</b>, verworfen <b>" + String(bs.overruns) + "</b></div>";
+    }
+    html += "<div class='hint'>SD-Takt: <b>" + String(loggerSdHz() / 1e6, 1) + " MHz</b>" +
+            (cfg->log_sd_hz ? " (fest)" : " (automatisch)") + " (<a href='/api/log/sdbench'>JSON</a>)</div>";
+    const LogSdBench b = loggerGetSdBench();
+    if (b.epoch) {
+      html += "<div class='hint" + String(b.ok ? "" : " warn") + "'>Benchmark (" + String(b.hz / 1e6, 1) +
+              " MHz): schreiben <b>" + String(b.seqWriteKBs) + " KB/s</b>, lesen <b>" + String(b.seqReadKBs) +
+              " KB/s</b>, Append Ø <b>" + String(b.appendAvgUs) + " µs</b> (max. " + String(b.appendMaxUs) +
+              "), Öffnen+Schließen Ø <b>" + String(b.openCloseAvgUs) + " µs</b>, CRC-Fehler <b>" +
+              String(b.crcErrors) + "</b></div>";
+    }
     html += "<button class='btn-secondary' type='submit' name='sd_rescan' value='1'>SD aktualisieren</button>";
+    html += " <button class='btn-secondary' type='submit' name='sd_bench' value='1'>SD-Benchmark</button>";
+    if (cfg->log_burst_sec) {
+      html += " <button class='btn-secondary' type='submit' name='burst_now' value='1'>Burst jetzt starten</button>";
+    }
   }
 
   html += "</div>";
@@ -176,6 +550,66 @@ void pageSettingsLogger(WebServer &server) {
           "</div>";
 
   html += "<div class='hint'>Wenn alles abgewählt ist, wird absichtlich nichts gespeichert.</div>";
+
+  // eigenes Intervall je Metrik (Vielfaches des Log-Intervalls)
+  const uint16_t baseMin = cfg->log_interval_min ? cfg->log_interval_min : 1;
+  auto everyRow = [&](const char* name, const char* label, uint8_t cur) {
+    html += "<div class='form-row'><label>" + String(label) + "</label><select name='" + String(name) + "'>";
+    const uint8_t opts[] = { 1, 2, 5, 10, 15, 30, 60 };
+    for (uint8_t k : opts) {
+      const uint32_t min = (uint32_t)baseMin * k;
+      html += "<option value='" + String(k) + "' " + String(cur == k ? "selected" : "") + ">" +
+              (k == 1 ? String("jede Zeile") : "jede " + String(k) + ". Zeile") +
+              " (" + (min % 60 ? String(min) + " min" : String(min / 60) + " h") + ")</option>";
+    }
+    html += "</select></div>";
+  };
+  everyRow("log_every_temp",  "Temperatur alle",  cfg->log_every_temp);
+  everyRow("log_every_hum",   "Luftfeuchte alle", cfg->log_every_hum);
+  everyRow("log_every_press", "Luftdruck alle",   cfg->log_every_press);
+  everyRow("log_every_co2",   "CO₂ alle",         cfg->log_every_co2);
+  {
+    // Werte je Tag mit / ohne eigene Intervalle
+    const uint8_t ev[] = { cfg->log_every_temp, cfg->log_every_hum, cfg->log_every_press, cfg->log_every_co2 };
+    const uint32_t rows = 1440u / baseMin;
+    uint32_t full = 0, sparse = 0;
+    for (int i = 0; i < LOG_METRIC_COUNT; i++) {
+      if (!(m & LOG_METRICS[i].bit)) continue;
+      full += rows;
+      sparse += (rows + (ev[i] ? ev[i] : 1) - 1) / (ev[i] ? ev[i] : 1);
+    }
+    html += "<div class='hint'>Langsame Größen (z.B. Luftdruck) seltener speichern: dazwischen bleibt die Spalte leer, "
+            "gemittelt wird über das ganze eigene Intervall. Werte je Tag: <b>" + String(sparse) + "</b> statt " +
+            String(full) + (full && sparse < full ? " (−" + String(100 - (int)(sparse * 100 / full)) + " %)" : String("")) +
+            ". CSV und Komprimiert werden kleiner, Binär behält die feste Zeilengröße.</div>";
+  }
+
+  // Kompression: Toleranz je Metrik (Hundertstel der Einheit)
+  auto sdtRow = [&](const char* name, const char* label, const char* unit, uint16_t cur, std::initializer_list<uint16_t> opts) {
+    html += "<div class='form-row'><label>" + String(label) + "</label><select name='" + String(name) + "'>";
+    for (uint16_t v : opts) {
+      html += "<option value='" + String(v) + "' " + String(cur == v ? "selected" : "") + ">" +
+              (v ? "± " + (v % 100 ? String(v / 100.0, v % 10 ? 2 : 1) : String(v / 100)) + " " + unit : String("Aus (jeder Wert)")) +
+              "</option>";
+    }
+    html += "</select></div>";
+  };
+  sdtRow("log_sdt_temp",  "Toleranz Temperatur", "°C",  cfg->log_sdt_temp,  { 0, 5, 10, 20, 50 });
+  sdtRow("log_sdt_hum",   "Toleranz Luftfeuchte", "%",  cfg->log_sdt_hum,   { 0, 20, 50, 100, 200 });
+  sdtRow("log_sdt_press", "Toleranz Luftdruck", "hPa",  cfg->log_sdt_press, { 0, 5, 10, 20, 50 });
+  sdtRow("log_sdt_co2",   "Toleranz CO₂", "ppm",        cfg->log_sdt_co2,   { 0, 500, 1000, 2000, 5000 });
+  {
+    String stats;
+    const LoggerStats st = loggerGetStats();
+    if (st.sdtIn) {
+      stats = " Bisher gespeichert: <b>" + String(st.sdtKept) + "</b> von <b>" + String(st.sdtIn) + "</b> Werten (−" +
+              String(100 - (int)((uint64_t)st.sdtKept * 100 / st.sdtIn)) + " %).";
+    }
+    html += "<div class='hint'>Gleichmäßige Abschnitte nur als Anfangs- und Endpunkt speichern (Swinging Door): die Linie "
+            "dazwischen (Diagramm bzw. /api/history?interp=1) weicht höchstens um die Toleranz vom Messwert ab (CSV zusätzlich ±0,005). "
+            "Die letzten Werte bleiben bis zur Entscheidung im RAM (höchstens 64 Zeilen, wie der Schreibpuffer bei Stromausfall "
+            "verloren); Tageszusammenfassungen rechnen mit allen Werten." + stats + "</div>";
+  }
   html += "</div>";
 
   html += "<div class='card'><div class='actions'>"
@@ -5,6 +5,7 @@
 #include "sensors_ctrl.h"
 #include "settings_config/settings_common.h"
 #include "logger.h"
+#include "log_burst.h"
 
 void webServerBegin(WebServer &server,
                     AppConfig &cfg,
@@ -53,18 +54,35 @@ void webServerBegin(WebServer &server,
   AppConfig* c = settingsRequireCfgAndAuth(server);
   if (!c) return;
 
-  loggerRescan();
+  loggerRescan(*c);
+  loggerStoreSdClock(*c);
 
   server.sendHeader("Location", "/settings/logger?msg=rescan", true);
   server.send(302, "text/plain", "");
   });
 
+  server.on("/action/logger_burst", HTTP_POST, [&](){
+  AppConfig* c = settingsRequireCfgAndAuth(server);
+  if (!c) return;
+
+  if (!logBurstTrigger(LOG_BURST_WEB)) {
+    server.send(409, "application/json", "{\"error\":\"burst disabled (log_burst_sec = 0)\"}");
+    return;
+  }
+
+  server.sendHeader("Location", "/settings/logger?msg=burst", true);
+  server.send(302, "text/plain", "");
+  });
+
 
   server.on("/license", HTTP_GET, [&](){ pageLicense(server); });
 
   // API
   server.on("/api/live", HTTP_GET, [&](){ apiLive(server); });
   server.on("/api/history", HTTP_GET, [&](){ apiHistory(server); });
+  server.on("/api/log/csv", HTTP_GET, [&](){ apiLogCsv(server); });
+  server.on("/api/log/latency", HTTP_GET, [&](){ apiLogLatency(server); });
+  server.on("/api/log/sdbench", HTTP_GET, [&](){ apiLogSdBench(server); });
 
   // Seiten
   server.on("/", HTTP_GET,        [&](){ pageRoot(server); });
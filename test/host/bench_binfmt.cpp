@@ -0,0 +1,95 @@
+// Benchmark .bin gegen .csv: Einlesen eines ganzen Tages mit 1-Minuten-Werten (1440 Zeilen)
+// und eines 1-h-Fensters, wie apiHistory() die Tagesdateien liest. Prüft nebenbei, dass beide
+// Dateien dieselben Werte liefern (Rückgabe != 0 sonst).
+#include "synth.h"
+#include "log_csv.h"
+
+static const char* CSV_PATH = "/log/bench_binfmt.csv";
+static const char* BIN_PATH = "/log/bench_binfmt.bin";
+
+// ganze Datei bzw. [t0, t1] aus der CSV (ohne .idx: von vorn lesen)
+static uint32_t readCsv(uint32_t t0, uint32_t t1, std::vector<LogSample>& out) {
+  out.clear();
+  File f = SD.open(CSV_PATH, FILE_READ);
+  LogCsvReader rd(f);
+  rd.next();
+  int idx[LOG_METRIC_COUNT];
+  for (int i = 0; i < LOG_METRIC_COUNT; i++) idx[i] = rd.find(LOG_METRICS[i].col);
+  rd.setCrc(rd.find(LOG_CSV_COL_CRC) >= 0);
+  while (rd.next()) {
+    LogSample s;
+    if (logCsvParseU32(rd.field(0), s.epoch) != LOG_CSV_OK || s.epoch < t0) continue;
+    if (s.epoch > t1) break;
+    for (int i = 0; i < LOG_METRIC_COUNT; i++) {
+      if (idx[i] >= 0 && logCsvParseFloat(rd.field((uint8_t)idx[i]), s.v[i]) != LOG_CSV_OK) s.v[i] = NAN;
+    }
+    out.push_back(s);
+  }
+  f.close();
+  return (uint32_t)out.size();
+}
+
+// wie readBinDay() in apiHistory.cpp: binäre Suche, dann Blöcke zu je 32 Records
+static uint32_t readBin(uint32_t t0, uint32_t t1, std::vector<LogSample>& out) {
+  out.clear();
+  File f = SD.open(BIN_PATH, FILE_READ);
+  LogBinHeader h;
+  if (!logBinReadHeader(f, h)) { f.close(); return 0; }
+  const uint32_t count = logBinRecordCount(f, h);
+  uint32_t r = logBinLowerBound(f, h, count, t0);
+  f.seek(h.header_size + (size_t)r * h.rec_size);
+
+  uint8_t buf[32 * LOG_BIN_MAX_REC];
+  const uint32_t perChunk = sizeof(buf) / h.rec_size;
+  bool done = false;
+  while (r < count && !done) {
+    const uint32_t n = std::min(perChunk, count - r);
+    if (f.read(buf, n * h.rec_size) != n * h.rec_size) break;
+    for (uint32_t k = 0; k < n; k++) {
+      const uint8_t* rec = buf + k * h.rec_size;
+      if (!logBinRecordOk(h, rec)) continue;
+      LogSample s;
+      logBinDecode(h, rec, s);
+      if (s.epoch > t1) { done = true; break; }
+      out.push_back(s);
+    }
+    r += n;
+  }
+  f.close();
+  return (uint32_t)out.size();
+}
+
+static bool same(const std::vector<LogSample>& a, const std::vector<LogSample>& b) {
+  if (a.size() != b.size()) return false;
+  for (size_t r = 0; r < a.size(); r++) {
+    if (a[r].epoch != b[r].epoch) return false;
+    for (int i = 0; i < LOG_METRIC_COUNT; i++) {
+      if (fabsf(a[r].v[i] - b[r].v[i]) > 0.005f) return false;
+    }
+  }
+  return true;
+}
+
+int main() {
+  const std::vector<LogSample> day = synthDay();
+  const size_t csvBytes = synthWriteCsv(CSV_PATH, day);
+  const size_t binBytes = synthWriteBin(BIN_PATH, day);
+
+  const uint32_t allFrom = 0, allTo = 0xFFFFFFFFu;
+  const uint32_t hFrom = SYNTH_DAY_START + 14 * 3600, hTo = hFrom + 3599;
+  const int reps = 200;
+  std::vector<LogSample> a, b;
+
+  const double csvDay = synthBestOf(reps, [&] { readCsv(allFrom, allTo, a); });
+  const double binDay = synthBestOf(reps, [&] { readBin(allFrom, allTo, b); });
+  if (a.size() != day.size() || !same(a, b)) { printf("FAIL: Tag .csv != .bin\n"); return 1; }
+
+  const double csvHour = synthBestOf(reps, [&] { readCsv(hFrom, hTo, a); });
+  const double binHour = synthBestOf(reps, [&] { readBin(hFrom, hTo, b); });
+  if (a.size() != 60 || !same(a, b)) { printf("FAIL: Stunde .csv != .bin\n"); return 1; }
+
+  printf("Datei:   csv %zu B, bin %zu B (%.2fx kleiner)\n", csvBytes, binBytes, (double)csvBytes / binBytes);
+  printf("Tag:     csv %8.1f us, bin %8.1f us (%.1fx schneller)\n", csvDay * 1e6, binDay * 1e6, csvDay / binDay);
+  printf("Stunde:  csv %8.1f us, bin %8.1f us (%.1fx schneller)\n", csvHour * 1e6, binHour * 1e6, csvHour / binHour);
+  return 0;
+}
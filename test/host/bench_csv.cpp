@@ -0,0 +1,95 @@
+// Benchmark CSV-Tokenizer: alter String-Pfad (readStringUntil + splitCsv, bis user-009 in
+// apiHistory.cpp) gegen LogCsvReader auf einer synthetischen Tagesdatei (1-s-Werte, 86400 Zeilen).
+// Gemessen: Zeilen/s und Heap-Allokationen je Zeile. std::string des Hosts hat SSO, kurze Felder
+// zählen hier also nicht mit -> der alte Pfad allokiert auf dem Gerät eher mehr.
+#include "synth.h"
+#include "log_csv.h"
+#include <new>
+
+static size_t g_allocs = 0;
+void* operator new(size_t n) { g_allocs++; void* p = malloc(n ? n : 1); if (!p) throw std::bad_alloc(); return p; }
+void operator delete(void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+
+static const char* PATH = "/log/bench_csv.csv";
+
+// ===== alter Pfad (unverändert übernommen) =====
+static void splitCsv(const String& s, String out[], int maxParts, int& n) {
+  n = 0;
+  int start = 0;
+  while (n < maxParts) {
+    int comma = s.indexOf(',', start);
+    if (comma < 0) {
+      out[n] = s.substring(start);
+      out[n].trim();
+      n++;
+      break;
+    }
+    out[n] = s.substring(start, comma);
+    out[n].trim();
+    n++;
+    start = comma + 1;
+  }
+}
+
+static double readOld(uint32_t& lines) {
+  File f = SD.open(PATH, FILE_READ);
+  const int MAXC = 16;
+  String parts[MAXC];
+  int pn = 0;
+  double sum = 0;
+  lines = 0;
+  String first = f.readStringUntil('\n');
+  while (f.available()) {
+    String line = f.readStringUntil('\n');
+    line.trim();
+    if (!line.length()) continue;
+    splitCsv(line, parts, MAXC, pn);
+    sum += (uint32_t)parts[0].toInt();
+    for (int k = 1; k <= LOG_METRIC_COUNT && k < pn; k++) if (parts[k].length()) sum += parts[k].toFloat();
+    lines++;
+  }
+  f.close();
+  return sum;
+}
+
+// ===== neuer Pfad =====
+static double readNew(uint32_t& lines) {
+  File f = SD.open(PATH, FILE_READ);
+  LogCsvReader rd(f);
+  rd.next();   // ohne setCrc(): der alte Pfad prüfte keine Prüfsumme
+  double sum = 0;
+  lines = 0;
+  while (rd.next()) {
+    uint32_t ep;
+    if (logCsvParseU32(rd.field(0), ep) == LOG_CSV_OK) sum += ep;
+    for (uint8_t k = 1; k <= LOG_METRIC_COUNT && k < rd.count(); k++) {
+      float v;
+      if (logCsvParseFloat(rd.field(k), v) == LOG_CSV_OK) sum += v;
+    }
+    lines++;
+  }
+  f.close();
+  return sum;
+}
+
+template <class F> static void run(const char* name, F fn, double& sum) {
+  uint32_t lines = 0;
+  const size_t a0 = g_allocs;
+  sum = fn(lines);
+  const double perLine = (double)(g_allocs - a0) / lines;
+  const double dt = synthBestOf(3, [&] { fn(lines); });
+  printf("%-4s %u Zeilen, %.2fM Zeilen/s, %.2f Allokationen/Zeile\n", name, lines, lines / dt / 1e6, perLine);
+}
+
+int main() {
+  const std::vector<LogSample> day = synthDay(1, 86400);
+  synthWriteCsv(PATH, day);
+
+  double sumOld = 0, sumNew = 0;
+  run("alt", readOld, sumOld);
+  run("neu", readNew, sumNew);
+  // beide Pfade müssen dieselben Werte lesen (Summe in double, Felder mit 2 Nachkommastellen)
+  if (fabs(sumOld - sumNew) > 1e-12 * fabs(sumOld)) { printf("FAIL: Summen %f != %f\n", sumOld, sumNew); return 1; }
+  return 0;
+}
@@ -0,0 +1,70 @@
+// Benchmark .gor: Kompressionsrate gegen .csv/.bin und Dekodier-Durchsatz.
+//   bench_gorilla              synthetischer Tag mit 1-Minuten-Werten
+//   bench_gorilla export.csv   exportierter Tag (/api/log/csv?day=...) vom Gerät
+// Prüft, dass jeder Block bitgenau dieselben Werte zurückliefert (Rückgabe != 0 sonst).
+#include "synth.h"
+#include "log_gorilla.h"
+
+// wie der Logger: Block voll -> schreiben, neuer Block
+static std::vector<uint8_t> encode(const std::vector<LogSample>& rows, uint32_t mask) {
+  std::vector<uint8_t> out;
+  LogGorEncoder enc;
+  enc.reset(mask);
+  for (const LogSample& s : rows) {
+    if (enc.add(s)) continue;
+    out.insert(out.end(), enc.block(), enc.block() + LOG_GOR_BLOCK_SIZE);
+    enc.reset(mask);
+    enc.add(s);
+  }
+  if (!enc.empty()) out.insert(out.end(), enc.block(), enc.block() + LOG_GOR_BLOCK_SIZE);
+  return out;
+}
+
+static uint32_t decode(const std::vector<uint8_t>& gor, std::vector<LogSample>& rows) {
+  rows.clear();
+  LogGorDecoder dec;
+  for (size_t b = 0; b + LOG_GOR_BLOCK_SIZE <= gor.size(); b += LOG_GOR_BLOCK_SIZE) {
+    if (!dec.begin(&gor[b])) continue;
+    LogSample s;
+    while (dec.next(s)) rows.push_back(s);
+  }
+  return (uint32_t)rows.size();
+}
+
+static bool sameBits(const LogSample& a, const LogSample& b, uint32_t mask) {
+  if (a.epoch != b.epoch) return false;
+  for (int i = 0; i < LOG_METRIC_COUNT; i++) {
+    if (!(mask & LOG_METRICS[i].bit)) continue;
+    if (isnan(a.v[i]) != isnan(b.v[i])) return false;
+    if (!isnan(a.v[i]) && memcmp(&a.v[i], &b.v[i], sizeof(float)) != 0) return false;
+  }
+  return true;
+}
+
+int main(int argc, char** argv) {
+  std::vector<LogSample> rows;
+  uint32_t mask = SYNTH_ALL_MASK;
+  if (argc > 1) {
+    mask = synthLoadCsv(argv[1], rows);
+    if (!mask || rows.empty()) { printf("FAIL: %s nicht lesbar\n", argv[1]); return 1; }
+  } else {
+    rows = synthDay();
+  }
+
+  const size_t csvBytes = synthWriteCsv("/log/bench_gorilla.csv", rows, mask);
+  const size_t binBytes = synthWriteBin("/log/bench_gorilla.bin", rows, mask);
+  const std::vector<uint8_t> gor = encode(rows, mask);
+
+  std::vector<LogSample> back;
+  if (decode(gor, back) != rows.size()) { printf("FAIL: %zu Samples dekodiert, %zu erwartet\n", back.size(), rows.size()); return 1; }
+  for (size_t r = 0; r < rows.size(); r++) {
+    if (!sameBits(rows[r], back[r], mask)) { printf("FAIL: Sample %zu weicht ab\n", r); return 1; }
+  }
+
+  const double dt = synthBestOf(200, [&] { decode(gor, back); });
+  printf("%zu Samples, %zu Blöcke\n", rows.size(), gor.size() / LOG_GOR_BLOCK_SIZE);
+  printf("gor %zu B, csv %zu B (%.1fx), bin %zu B (%.1fx), %.2f B/Sample\n", gor.size(), csvBytes,
+         (double)csvBytes / gor.size(), binBytes, (double)binBytes / gor.size(), (double)gor.size() / rows.size());
+  printf("Dekodieren: %.2fM Samples/s\n", rows.size() / dt / 1e6);
+  return 0;
+}
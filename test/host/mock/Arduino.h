@@ -0,0 +1,74 @@
+#pragma once
+// Host-Ersatz für das Arduino-Core: nur was die log_*-Module brauchen (String, Zeit, Serial)
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <stdarg.h>
+#include <time.h>
+#include <string>
+#include <algorithm>
+
+class String {
+public:
+  String() {}
+  String(const char* c) : s(c ? c : "") {}
+  String(const std::string& x) : s(x) {}
+  String(char c) : s(1, c) {}
+  String(int v) : s(std::to_string(v)) {}
+  String(unsigned v) : s(std::to_string(v)) {}
+  String(long v) : s(std::to_string(v)) {}
+  String(unsigned long v) : s(std::to_string(v)) {}
+  String(float v, unsigned d = 2) { char b[64]; snprintf(b, sizeof b, "%.*f", d, (double)v); s = b; }
+
+  unsigned length() const { return (unsigned)s.size(); }
+  const char* c_str() const { return s.c_str(); }
+  char charAt(unsigned i) const { return i < s.size() ? s[i] : 0; }
+  char operator[](unsigned i) const { return charAt(i); }
+  String substring(unsigned a) const { return a >= s.size() ? String() : String(s.substr(a)); }
+  String substring(unsigned a, unsigned b) const {
+    if (a > b) std::swap(a, b);
+    return a >= s.size() ? String() : String(s.substr(a, b - a));
+  }
+  int indexOf(char c, unsigned from = 0) const { auto p = s.find(c, from); return p == std::string::npos ? -1 : (int)p; }
+  bool startsWith(const String& p) const { return s.compare(0, p.s.size(), p.s) == 0; }
+  void trim() {
+    const size_t a = s.find_first_not_of(" \t\r\n");
+    if (a == std::string::npos) { s.clear(); return; }
+    s = s.substr(a, s.find_last_not_of(" \t\r\n") - a + 1);
+  }
+  long  toInt() const { return atol(s.c_str()); }
+  float toFloat() const { return (float)atof(s.c_str()); }
+  void  reserve(unsigned n) { s.reserve(n); }
+  String& operator+=(const String& o) { s += o.s; return *this; }
+  String& operator+=(const char* o) { s += o; return *this; }
+  String& operator+=(char o) { s += o; return *this; }
+  bool operator==(const String& o) const { return s == o.s; }
+  bool operator==(const char* o) const { return s == o; }
+  bool operator!=(const String& o) const { return s != o.s; }
+  bool operator!=(const char* o) const { return s != o; }
+
+  std::string s;
+};
+inline String operator+(const String& a, const String& b) { return String(a.s + b.s); }
+inline String operator+(const String& a, const char* b) { return String(a.s + b); }
+inline String operator+(const char* a, const String& b) { return String(std::string(a) + b.s); }
+
+uint32_t millis();
+uint32_t micros();
+void delay(uint32_t ms);
+void yield();
+
+struct HardwareSerial {
+  void begin(int) {}
+  int printf(const char* f, ...) __attribute__((format(printf, 2, 3))) {
+    va_list a; va_start(a, f); const int r = vfprintf(stderr, f, a); va_end(a); return r;
+  }
+  void println(const char* v) { fprintf(stderr, "%s\n", v); }
+  void println(const String& v) { println(v.c_str()); }
+};
+extern HardwareSerial Serial;
+
+using std::min;
+using std::max;
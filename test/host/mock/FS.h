@@ -0,0 +1,65 @@
+#pragma once
+// Host-Ersatz für fs::FS / File: Pfade liegen unter einem Verzeichnis des Hosts
+#include <Arduino.h>
+#include <sys/stat.h>
+
+#define FILE_READ   "r"
+#define FILE_WRITE  "w"
+#define FILE_APPEND "a"
+
+namespace fs {
+enum SeekMode { SeekSet = 0, SeekCur = 1, SeekEnd = 2 };
+
+class File {
+public:
+  File() {}
+  explicit File(FILE* fp) : _fp(fp) {}
+  operator bool() const { return _fp != nullptr; }
+
+  size_t write(const uint8_t* b, size_t n) { return _fp ? fwrite(b, 1, n, _fp) : 0; }
+  size_t write(uint8_t c) { return write(&c, 1); }
+  size_t print(const char* s) { return write((const uint8_t*)s, strlen(s)); }
+  size_t print(const String& s) { return print(s.c_str()); }
+  int    read() { return _fp ? fgetc(_fp) : -1; }
+  size_t read(uint8_t* b, size_t n) { return _fp ? fread(b, 1, n, _fp) : 0; }
+  int    available() { return _fp ? (int)(size() - position()) : 0; }
+  bool   seek(uint32_t pos, SeekMode m = SeekSet) { return _fp && fseek(_fp, pos, m) == 0; }
+  size_t position() const { return _fp ? (size_t)ftell(_fp) : 0; }
+  size_t size() const {
+    if (!_fp) return 0;
+    fflush(_fp);
+    struct stat st;
+    return fstat(fileno(_fp), &st) == 0 ? (size_t)st.st_size : 0;
+  }
+  void flush() { if (_fp) fflush(_fp); }
+  void close() { if (_fp) fclose(_fp); _fp = nullptr; }
+  String readStringUntil(char t) {
+    String r;
+    int c;
+    while ((c = read()) >= 0 && c != t) r += (char)c;
+    return r;
+  }
+
+private:
+  FILE* _fp = nullptr;
+};
+
+class FS {
+public:
+  explicit FS(const char* root) : _root(root) {}
+  File open(const String& p, const char* mode = FILE_READ) {
+    return File(fopen(host(p).c_str(), mode[0] == 'r' ? "rb" : (mode[0] == 'a' ? "ab" : "w+b")));
+  }
+  bool exists(const String& p) { struct stat st; return stat(host(p).c_str(), &st) == 0; }
+  bool remove(const String& p) { return ::remove(host(p).c_str()) == 0; }
+
+private:
+  std::string host(const String& p) const { return _root + p.c_str(); }
+  std::string _root;
+};
+}  // namespace fs
+
+using fs::File;
+using fs::SeekSet;
+using fs::SeekCur;
+using fs::SeekEnd;
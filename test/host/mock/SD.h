@@ -0,0 +1,9 @@
+#pragma once
+#include <FS.h>
+
+// Wurzel der "Karte" auf dem Host (CMake: HOST_SD_ROOT im Build-Verzeichnis)
+class SDFS : public fs::FS {
+public:
+  SDFS() : FS(HOST_SD_ROOT) {}
+};
+extern SDFS SD;
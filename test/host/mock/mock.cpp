@@ -0,0 +1,17 @@
+#include <Arduino.h>
+#include <SD.h>
+#include <chrono>
+
+HardwareSerial Serial;
+SDFS SD;
+
+static uint32_t sinceStartUs() {
+  using namespace std::chrono;
+  static const steady_clock::time_point t0 = steady_clock::now();
+  return (uint32_t)duration_cast<microseconds>(steady_clock::now() - t0).count();
+}
+
+uint32_t millis() { return sinceStartUs() / 1000; }
+uint32_t micros() { return sinceStartUs(); }
+void delay(uint32_t ms) { (void)ms; }
+void yield() {}
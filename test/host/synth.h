@@ -0,0 +1,117 @@
+#pragma once
+// Synthetische Messreihen und Tagesdateien im Format des Loggers (logger.cpp) für Tests/Benchmarks
+#include <Arduino.h>
+#include <SD.h>
+#include <chrono>
+#include <vector>
+#include "log_format.h"
+#include "log_csv.h"
+
+static constexpr uint32_t SYNTH_DAY_START = 1756677600;   // 2025-09-01 00:00 (Europe/Berlin)
+static constexpr uint32_t SYNTH_ALL_MASK  = LOG_TEMP | LOG_HUM | LOG_PRESS | LOG_CO2;
+
+// Sensorwerte auf 0,01 gerundet, wie sie in der CSV stehen: Tagesgang + Rauschen (fester Seed)
+inline std::vector<LogSample> synthDay(uint32_t stepSec = 60, uint32_t rows = 1440) {
+  std::vector<LogSample> out(rows);
+  uint32_t seed = 12345;
+  auto noise = [&seed](float amp) {
+    seed = seed * 1664525u + 1013904223u;
+    return amp * ((float)(seed >> 8) / (float)(1u << 24) - 0.5f);
+  };
+  auto r2 = [](float v) { return roundf(v * 100.0f) / 100.0f; };
+  for (uint32_t r = 0; r < rows; r++) {
+    const float ph = 6.2831853f * (float)(r * stepSec) / 86400.0f;
+    LogSample& s = out[r];
+    s.epoch = SYNTH_DAY_START + r * stepSec;
+    s.v[0] = r2(21.0f + 1.5f * sinf(ph) + noise(0.1f));
+    s.v[1] = r2(45.0f - 6.0f * sinf(ph) + noise(0.6f));
+    s.v[2] = r2(1013.0f + 2.0f * sinf(ph * 0.5f) + noise(0.05f));
+    s.v[3] = r2(600.0f + 250.0f * fmaxf(0.0f, sinf(ph * 3.0f)) + noise(8.0f));
+  }
+  return out;
+}
+
+// CSV-Zeile wie logger.cpp (leere Felder für NAN, CRC-Spalte am Ende), ohne '\n'
+inline int synthCsvLine(const LogSample& s, uint32_t mask, char* line, size_t cap) {
+  int k = snprintf(line, cap, "%lu", (unsigned long)s.epoch);
+  for (int i = 0; i < LOG_METRIC_COUNT; i++) {
+    if (!(mask & LOG_METRICS[i].bit)) continue;
+    line[k++] = ',';
+    if (!isnan(s.v[i])) k += snprintf(line + k, cap - k, "%.2f", (double)s.v[i]);
+  }
+  k += snprintf(line + k, cap - k, ",%04X", logCrc16((const uint8_t*)line, (size_t)k));
+  return k;
+}
+
+// CSV-Export vom Gerät (/api/log/csv?day=...) einlesen: Spalten per Header, fehlende Metriken NAN;
+// liefert die Maske (0 = nicht lesbar)
+inline uint32_t synthLoadCsv(const char* hostPath, std::vector<LogSample>& rows) {
+  File f(fopen(hostPath, "rb"));
+  if (!f) return 0;
+  LogCsvReader rd(f);
+  rd.next();
+  int idx[LOG_METRIC_COUNT];
+  uint32_t mask = 0;
+  for (int i = 0; i < LOG_METRIC_COUNT; i++) {
+    idx[i] = rd.find(LOG_METRICS[i].col);
+    if (idx[i] >= 0) mask |= LOG_METRICS[i].bit;
+  }
+  rd.setCrc(rd.find(LOG_CSV_COL_CRC) >= 0);
+  while (rd.next()) {
+    LogSample s;
+    if (logCsvParseU32(rd.field(0), s.epoch) != LOG_CSV_OK) continue;
+    for (int i = 0; i < LOG_METRIC_COUNT; i++) {
+      if (idx[i] >= 0 && logCsvParseFloat(rd.field((uint8_t)idx[i]), s.v[i]) != LOG_CSV_OK) s.v[i] = NAN;
+    }
+    rows.push_back(s);
+  }
+  f.close();
+  return mask;
+}
+
+// Tagesdatei /log/<name>.csv schreiben, liefert die Dateigröße
+inline size_t synthWriteCsv(const char* path, const std::vector<LogSample>& rows, uint32_t mask = SYNTH_ALL_MASK) {
+  File f = SD.open(path, FILE_WRITE);
+  String h = "epoch";
+  for (int i = 0; i < LOG_METRIC_COUNT; i++) {
+    if (mask & LOG_METRICS[i].bit) { h += ","; h += LOG_METRICS[i].col; }
+  }
+  h += ",";
+  h += LOG_CSV_COL_CRC;
+  h += "\n";
+  f.print(h);
+  for (const LogSample& s : rows) {
+    char line[12 + LOG_METRIC_COUNT * 48 + 8];   // wie logger.cpp: "%.2f" bis ±FLT_MAX
+    const int k = synthCsvLine(s, mask, line, sizeof(line) - 1);
+    line[k] = '\n';
+    f.write((const uint8_t*)line, (size_t)k + 1);
+  }
+  const size_t n = f.size();
+  f.close();
+  return n;
+}
+
+// Tagesdatei /log/<name>.bin schreiben, liefert die Dateigröße
+inline size_t synthWriteBin(const char* path, const std::vector<LogSample>& rows, uint32_t mask = SYNTH_ALL_MASK) {
+  File f = SD.open(path, FILE_WRITE);
+  LogBinHeader h;
+  logBinInitHeader(h, mask, SYNTH_DAY_START);
+  f.write((const uint8_t*)&h, sizeof(h));
+  uint8_t rec[LOG_BIN_MAX_REC];
+  for (const LogSample& s : rows) f.write(rec, logBinEncode(h, s, rec));
+  const size_t n = f.size();
+  f.close();
+  return n;
+}
+
+// Laufzeit in Sekunden (beste von reps Wiederholungen, gegen Ausreißer des Hosts)
+template <class F> double synthBestOf(int reps, F fn) {
+  using clk = std::chrono::steady_clock;
+  double best = 1e30;
+  for (int i = 0; i < reps; i++) {
+    const clk::time_point t0 = clk::now();
+    fn();
+    best = std::min(best, std::chrono::duration<double>(clk::now() - t0).count());
+  }
+  return best;
+}
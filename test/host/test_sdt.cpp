@@ -0,0 +1,157 @@
+// Kompression (LogSdt) + Auffüllen im Verlauf (LogInterp, wie HistInterp in apiHistory.cpp):
+// jede gemessene Zeile muss auf der rekonstruierten Linie höchstens um die Toleranz abweichen,
+// und keine Lücke zwischen zwei gespeicherten Werten darf länger als der Interpolationsring sein.
+//   test_sdt              synthetische Tage
+//   test_sdt export.csv   zusätzlich ein exportierter Tag vom Gerät (/api/log/csv?day=...)
+#include "synth.h"
+#include "log_sdt.h"
+#include "log_interp.h"
+
+static int g_fail = 0;
+#define CHECK(c, ...) do { if (!(c)) { printf("FAIL %s:%d: ", __FILE__, __LINE__); printf(__VA_ARGS__); printf("\n"); g_fail++; } } while (0)
+
+struct Row {
+  uint32_t ep;
+  float    v[LOG_INTERP_COLS];
+};
+
+// Logger: jede Zeile durch die Kompression, fertige Zeilen sofort abholen, am Ende finish()
+static std::vector<LogSample> compress(const std::vector<LogSample>& in, const float* tol, LogSdt& sdt) {
+  std::vector<LogSample> out;
+  sdt.configure(tol);
+  LogSample o;
+  for (const LogSample& s : in) {
+    sdt.push(s);
+    while (sdt.pop(o)) out.push_back(o);
+  }
+  sdt.finish();
+  while (sdt.pop(o)) out.push_back(o);
+  return out;
+}
+
+// Verlauf mit interp=1: Zeilen (ggf. als Hüllkurve min = max wie HistEnvPoint) durch LogInterp
+static std::vector<Row> history(const std::vector<LogSample>& stored, bool envelope) {
+  static LogInterp ip;
+  const uint8_t cols = envelope ? 2 * LOG_METRIC_COUNT : LOG_METRIC_COUNT;
+  std::vector<Row> out;
+  ip.begin(cols);
+  Row r;
+  auto drain = [&] { while (ip.pop(r.ep, r.v)) out.push_back(r); };
+  for (const LogSample& s : stored) {
+    float v[LOG_INTERP_COLS];
+    for (int i = 0; i < LOG_METRIC_COUNT; i++) {
+      if (envelope) v[2 * i] = v[2 * i + 1] = s.v[i];
+      else v[i] = s.v[i];
+    }
+    ip.push(s.epoch, v);
+    drain();
+  }
+  ip.finish();
+  drain();
+  return out;
+}
+
+// Spalte col des Verlaufs gegen Metrik m des Originals
+static void checkColumn(const char* name, const std::vector<LogSample>& in, const std::vector<Row>& hist,
+                        int m, int col, float tol) {
+  // zwischen erstem und letztem Wert der Spalte muss jede Zeile gefüllt sein (Ring groß genug)
+  size_t first = hist.size(), last = 0;
+  for (size_t k = 0; k < hist.size(); k++) {
+    if (isnan(hist[k].v[col])) continue;
+    first = std::min(first, k);
+    last = k;
+  }
+  size_t holes = 0;
+  for (size_t k = first; k <= last && k < hist.size(); k++) holes += isnan(hist[k].v[col]);
+  CHECK(holes == 0, "%s m%d: %zu leere Zeilen zwischen gespeicherten Werten", name, m, holes);
+
+  // Original gegen die Linie durch die Verlaufspunkte (weggefallene Zeilen: wie im Diagramm)
+  float maxErr = 0;
+  size_t k = first, n = 0;
+  for (const LogSample& s : in) {
+    if (isnan(s.v[m])) continue;
+    while (k < last && hist[k + 1].ep <= s.epoch) {
+      k++;
+      while (k < last && isnan(hist[k].v[col])) k++;
+    }
+    size_t j = k + 1;
+    while (j <= last && isnan(hist[j].v[col])) j++;
+    float rec;
+    if (hist[k].ep == s.epoch || j > last) rec = hist[k].v[col];
+    else {
+      const double f = (double)(s.epoch - hist[k].ep) / (double)(hist[j].ep - hist[k].ep);
+      rec = (float)(hist[k].v[col] + f * (hist[j].v[col] - hist[k].v[col]));
+    }
+    maxErr = std::max(maxErr, fabsf(rec - s.v[m]));
+    n++;
+  }
+  CHECK(n > 0, "%s m%d: keine Werte", name, m);
+  CHECK(maxErr <= tol, "%s m%d: Abweichung %.5f > Toleranz %.5f", name, m, maxErr, tol);
+}
+
+static void runCase(const char* name, const std::vector<LogSample>& in, const float* tol, bool envelope,
+                    uint32_t mask = SYNTH_ALL_MASK) {
+  LogSdt sdt;
+  const std::vector<LogSample> stored = compress(in, tol, sdt);
+  const std::vector<Row> hist = history(stored, envelope);
+  CHECK(sdt.valuesKept() < sdt.valuesIn(), "%s: nichts komprimiert", name);
+  for (int m = 0; m < LOG_METRIC_COUNT; m++) {
+    if (!(mask & LOG_METRICS[m].bit)) continue;
+    if (envelope) {
+      checkColumn(name, in, hist, m, 2 * m, tol[m]);
+      checkColumn(name, in, hist, m, 2 * m + 1, tol[m]);
+    } else {
+      checkColumn(name, in, hist, m, m, tol[m]);
+    }
+  }
+  printf("%-10s %zu Zeilen -> %zu gespeichert, Werte %u/%u\n", name, in.size(), stored.size(),
+         sdt.valuesKept(), sdt.valuesIn());
+}
+
+int main(int argc, char** argv) {
+  const float tol[LOG_METRIC_COUNT] = { 0.1f, 0.5f, 0.05f, 10.0f };
+
+  // echte Messreihe: Rauschen, Sprünge, Lücken (Neustart) und log_every_* so, wie sie vorkommen
+  if (argc > 1) {
+    std::vector<LogSample> rec;
+    const uint32_t mask = synthLoadCsv(argv[1], rec);
+    if (!mask || rec.empty()) { printf("FAIL: %s nicht lesbar\n", argv[1]); return 1; }
+    runCase("export", rec, tol, false, mask);
+    runCase("export+env", rec, tol, true, mask);
+    const float mixed[LOG_METRIC_COUNT] = { 0, 0.5f, 0.05f, 10.0f };
+    runCase("export/mix", rec, mixed, false, mask);
+  }
+
+  const std::vector<LogSample> day = synthDay(60, 3 * 1440);
+
+  runCase("plain", day, tol, false);
+  runCase("envelope", day, tol, true);
+
+  // log_every_*: Druck nur jede 60., CO2 jede 5. Zeile (dazwischen NAN wie im Logger)
+  std::vector<LogSample> every = day;
+  for (size_t r = 0; r < every.size(); r++) {
+    if (r % 60) every[r].v[2] = NAN;
+    if (r % 5) every[r].v[3] = NAN;
+  }
+  runCase("every", every, tol, false);
+  runCase("every+env", every, tol, true);
+
+  // sehr glatte Reihe: der Korridor reicht weiter als der Ring, trotzdem keine Lücke > Ring
+  std::vector<LogSample> flat = day;
+  for (size_t r = 0; r < flat.size(); r++) flat[r].v[0] = 21.0f + 0.0001f * (float)r;
+  runCase("flat", flat, tol, false);
+
+  // Temperatur ohne Kompression (jede Zeile bleibt): die Lücken der anderen Metriken liegen dann
+  // über ebenso vielen Verlaufszeilen -> deckt den Ring von LogInterp voll ab
+  const float mixed[LOG_METRIC_COUNT] = { 0, 0.5f, 0.05f, 10.0f };
+  runCase("mixed", flat, mixed, false);
+  runCase("mixed+env", every, mixed, true);
+
+  // Toleranz 0 = jeden Wert speichern
+  const float off[LOG_METRIC_COUNT] = { 0, 0, 0, 0 };
+  LogSdt sdt;
+  CHECK(compress(day, off, sdt).size() == day.size() && sdt.valuesKept() == sdt.valuesIn(), "Toleranz 0 verwirft Werte");
+
+  if (g_fail) printf("%d Fehler\n", g_fail);
+  return g_fail ? 1 : 0;
+}